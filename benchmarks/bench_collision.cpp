@@ -0,0 +1,63 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "particlesim/collision.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+// packed pile: particles of radius 0.5 at roughly twice the density that fits without overlap
+static void BM_CollisionSolve(benchmark::State &state)
+{
+    const size_t N = state.range(0);
+    const float side = std::sqrt(N / 2.f);
+
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    cfg.world = {0.f, 0.f, side, side};
+
+    std::vector<float> initX(N), initY(N);
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> dist(0.f, side);
+    std::vector<core::Vector2D> positions(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        initX[i] = dist(rng);
+        initY[i] = dist(rng);
+        positions[i] = {initX[i], initY[i]};
+    }
+
+    UniformGrid grid(cfg);
+    grid.setData({positions, nullptr});
+    grid.build();
+
+    std::vector<float> px(N), py(N), vx(N), vy(N), ax(N), ay(N), life(N, 1.f);
+    std::vector<uint8_t> alive(N, 1);
+    ParticleSoAView view{px.data(), py.data(), vx.data(), vy.data(), ax.data(), ay.data(), life.data(), alive.data(), N};
+
+    CollisionSolver solver({0.5f, 0.f, 4, 1.f, true});
+    std::unique_ptr<ParallelScheduler> scheduler;
+    if (state.range(1) != 1)
+        scheduler = std::make_unique<ParallelScheduler>(state.range(1));
+
+    uint64_t resolved = 0;
+    for (auto _ : state)
+    {
+        // start every solve from the same overlapping pile
+        std::copy(initX.begin(), initX.end(), px.begin());
+        std::copy(initY.begin(), initY.end(), py.begin());
+        solver.solve(grid, view, 0.016f, scheduler.get());
+        resolved += solver.resolvedCount();
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["contacts"] = static_cast<double>(solver.contactCount());
+    state.counters["contacts_resolved_per_second"] = benchmark::Counter(static_cast<double>(resolved), benchmark::Counter::kIsRate);
+}
+
+// args: particle count, worker count (0 = hardware concurrency)
+BENCHMARK(BM_CollisionSolve)
+    ->ArgNames({"n", "workers"})
+    ->ArgsProduct({{100000, 1000000}, {1, 0}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
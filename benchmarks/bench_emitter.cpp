@@ -0,0 +1,107 @@
+#include <random>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static EmitterConfig boxConfig()
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {50.f, 50.f};
+    cfg.maxSpeed = 5.f;
+    cfg.accelerationJitter = 1.f;
+    cfg.minLifetime = 1.f;
+    cfg.maxLifetime = 10.f;
+    return cfg;
+}
+
+// the distributions the console example used to draw from, one particle at a time
+static void BM_Spawn_Mt19937(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSoA soa;
+    soa.resize(n);
+    auto &pos = soa.field<Position>();
+    auto &vel = soa.field<Velocity>();
+    auto &acc = soa.field<Acceleration>();
+    auto &life = soa.field<Lifetime>();
+    auto &alive = soa.field<Alive>();
+
+    std::mt19937 rng(12345);
+    for (auto _ : state)
+    {
+        std::uniform_real_distribution<float> posDist(-50.f, 50.f);
+        std::uniform_real_distribution<float> velDist(-5.f, 5.f);
+        std::uniform_real_distribution<float> accDist(-1.f, 1.f);
+        std::uniform_real_distribution<float> lifeDist(1.f, 10.f);
+        for (size_t i = 0; i < n; ++i)
+        {
+            pos.x()[i] = posDist(rng);
+            pos.y()[i] = posDist(rng);
+            vel.x()[i] = velDist(rng);
+            vel.y()[i] = velDist(rng);
+            acc.x()[i] = accDist(rng);
+            acc.y()[i] = accDist(rng);
+            life[i] = lifeDist(rng);
+            alive[i] = 1;
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+template <EmitterShape Shape>
+static void BM_Spawn_Emitter(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    EmitterConfig cfg = boxConfig();
+    cfg.shape = Shape;
+    ParticleEmitter emitter(cfg);
+
+    ParticleSoA soa;
+    soa.resize(n);
+    const ParticleSoAView out{soa.field<Position>().x(), soa.field<Position>().y(),
+                              soa.field<Velocity>().x(), soa.field<Velocity>().y(),
+                              soa.field<Acceleration>().x(), soa.field<Acceleration>().y(),
+                              soa.field<Lifetime>().data(), soa.field<Alive>().data(), n};
+
+    uint64_t first = 0;
+    for (auto _ : state)
+    {
+        emitter.sample(first, out);
+        first += n;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+// emit() through the append API, restarting the layout every frame
+static void BM_Spawn_EmitterParallel(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleEmitter emitter(boxConfig());
+    ParallelScheduler scheduler;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ParticleSystemDataSoA layout(n);
+        state.ResumeTiming();
+
+        emitter.emit(layout, n, &scheduler);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+    state.counters["threads"] = static_cast<double>(scheduler.workerCount());
+}
+
+BENCHMARK(BM_Spawn_Mt19937)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_Spawn_Emitter<EmitterShape::Box>)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_Spawn_Emitter<EmitterShape::Disc>)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_Spawn_Emitter<EmitterShape::Cone>)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_Spawn_EmitterParallel)->Arg(100000)->UseRealTime();
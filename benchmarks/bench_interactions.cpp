@@ -0,0 +1,62 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "particlesim/interactions.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+// about `density` particles per unit cell, radius == cell size
+template <InteractionModel Model>
+static void BM_InteractionPass(benchmark::State &state)
+{
+    const size_t N = state.range(0);
+    const float density = 4.f;
+    const float side = std::sqrt(N / density);
+
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    cfg.world = {0.f, 0.f, side, side};
+
+    std::vector<core::Vector2D> positions(N);
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(0.f, side);
+    for (auto &p : positions)
+        p = {dist(rng), dist(rng)};
+
+    UniformGrid grid(cfg);
+    grid.setData({positions, nullptr});
+    grid.build();
+
+    InteractionConfig icfg;
+    icfg.model = Model;
+    ParticleInteractions forces(icfg);
+
+    std::unique_ptr<ParallelScheduler> scheduler;
+    if (state.range(1) != 1)
+        scheduler = std::make_unique<ParallelScheduler>(state.range(1));
+
+    uint64_t pairs = 0;
+    for (auto _ : state)
+    {
+        forces.compute(grid, positions, scheduler.get());
+        pairs += forces.pairsEvaluated();
+        benchmark::DoNotOptimize(forces.accelerations().data());
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["pairs_per_second"] = benchmark::Counter(static_cast<double>(pairs), benchmark::Counter::kIsRate);
+}
+
+// args: particle count, worker count (0 = hardware concurrency)
+BENCHMARK(BM_InteractionPass<InteractionModel::SoftRepulsion>)
+    ->ArgNames({"n", "workers"})
+    ->ArgsProduct({{100000, 250000, 1000000}, {1, 0}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_InteractionPass<InteractionModel::SPH>)
+    ->ArgNames({"n", "workers"})
+    ->ArgsProduct({{100000, 250000, 1000000}, {1, 0}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -1,24 +1,45 @@
+#include <type_traits>
+#include <utility>
 #include "particlesim/particle_system.hpp"
 #include "core/vector.hpp"
+#include "particlesim/profiling.hpp"
 #include "benchmark/benchmark.h"
-
-#ifdef TRACY_ENABLE
-#include "tracy/Tracy.hpp"
-#else
-#define ZoneScoped
-#endif
+#include "perf_counters.hpp"
 
 using namespace particlesim;
 
+// bytes per particle of the given columns of a SoA container
+template <typename Columns, typename... Tags>
+constexpr double columnBytes =
+    double((std::remove_reference_t<decltype(std::declval<Columns &>().template field<Tags>())>::RowBytes + ...));
+
+// bytes an update reads and writes back per live particle, 0 where the update touches no columns
+template <typename Layout>
+constexpr double updateBytes = 0.0;
+template <>
+constexpr double updateBytes<ParticleSystemDataAoS> = 2.0 * sizeof(Particle);
+template <>
+constexpr double updateBytes<ParticleSystemDataSoA> =
+    columnBytes<ParticleSoA, Position, Velocity, Acceleration, Lifetime, Alive, Tier> +
+    columnBytes<ParticleSoA, Position, Velocity, Lifetime>;
+template <>
+constexpr double updateBytes<ParticleSystemDataQuantized> =
+    columnBytes<QuantizedSoA, Position, Velocity, Acceleration, Lifetime> +
+    columnBytes<QuantizedSoA, Position, Velocity, Lifetime>;
+template <>
+constexpr double updateBytes<ParticleSystemDataAllocated> = 2.0 * sizeof(Particle) + sizeof(size_t);
+
+// tops the system up to count particles. Lifetimes outlast all but the longest runs (the quantized
+// layout saturates at about 1000 s), and a run that outlives them refills the system in that frame
 template <typename Layout>
 void populate_system(ParticleSystem<Layout> &ps, size_t count)
 {
-    for (size_t i = 0; i < count; ++i)
+    for (size_t i = ps.size(); i < count; ++i)
     {
         Particle p{};
         p.velocity.x = float(i % 100) * 0.01f;
         p.velocity.y = float(i % 50) * 0.01f;
-        p.lifetime = 5.0f;
+        p.lifetime = 1000.0f;
         ps.addParticle(p);
     }
 }
@@ -26,16 +47,22 @@ void populate_system(ParticleSystem<Layout> &ps, size_t count)
 template <typename Layout>
 static void BM_Update(benchmark::State &state)
 {
-    ParticleSystem<Layout> ps(state.range(0));
-    populate_system(ps, state.range(0));
+    const size_t n = state.range(0);
+    ParticleSystem<Layout> ps(n);
+    populate_system(ps, n);
     ps.setPartition(nullptr);
 
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state)
     {
-        ZoneScoped;
         ps.update(0.016f, true); // simulate 1 frame (~16ms)
+        populate_system(ps, n);
         benchmark::ClobberMemory();
     }
+    perf.report(state, updateBytes<Layout> * double(n));
+
+    state.SetItemsProcessed(n * state.iterations());
 }
 
 BENCHMARK_TEMPLATE(BM_Update, ParticleSystemDataAoS)
@@ -56,4 +83,276 @@ BENCHMARK_TEMPLATE(BM_Update, ParticleSystemDataAllocated)
     ->Arg(10000)
     ->Arg(50000);
 
+BENCHMARK_TEMPLATE(BM_Update, ParticleSystemDataBallistic)
+    ->Name("BM_Update_Ballistic")
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000);
+
+BENCHMARK_TEMPLATE(BM_Update, ParticleSystemDataQuantized)
+    ->Name("BM_Update_Quantized")
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000);
+
+// memory bound sizes, spread over the default 100 x 100 world
+template <typename Layout>
+static void BM_UpdateLarge(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    Layout layout(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Particle p{};
+        p.position = {float(i % 997) * 0.1f, float(i % 991) * 0.1f};
+        p.velocity = {float(i % 100) * 0.01f, float(i % 50) * 0.01f};
+        p.acceleration = {0.f, -0.5f};
+        p.lifetime = 1000.0f;
+        layout.add(p);
+    }
+
+    PerfCounters perf;
+    perf.start();
+    for (auto _ : state)
+    {
+        PARTICLESIM_FRAME();
+        layout.update(0.016f);
+        benchmark::ClobberMemory();
+    }
+    perf.report(state, updateBytes<Layout> * double(n));
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_UpdateLarge, ParticleSystemDataSoA)
+    ->Name("BM_UpdateLarge_SoA")
+    ->Arg(1000000)
+    ->Arg(10000000);
+
+BENCHMARK_TEMPLATE(BM_UpdateLarge, ParticleSystemDataQuantized)
+    ->Name("BM_UpdateLarge_Quantized")
+    ->Arg(1000000)
+    ->Arg(10000000);
+
+// a consumer reads the positions every frame - where the ballistic layout pays for evaluation
+template <typename Layout>
+static void BM_UpdateAndPositions(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    Layout layout(n);
+    // long lived as in populate_system, refilled in the frame a long run outlives them
+    const auto refill = [&]
+    {
+        for (size_t i = layout.size(); i < n; ++i)
+        {
+            Particle p{};
+            p.velocity = {float(i % 100) * 0.01f, float(i % 50) * 0.01f};
+            p.acceleration = {0.f, -9.8f};
+            p.lifetime = 1000.0f;
+            layout.add(p);
+        }
+    };
+    refill();
+
+    PerfCounters perf;
+    perf.start();
+    for (auto _ : state)
+    {
+        PARTICLESIM_FRAME();
+        layout.update(0.016f, true);
+        refill();
+        benchmark::DoNotOptimize(layout.positions().data());
+        benchmark::ClobberMemory();
+    }
+    perf.report(state);
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_UpdateAndPositions, ParticleSystemDataSoA)
+    ->Name("BM_UpdateAndPositions_SoA")
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+BENCHMARK_TEMPLATE(BM_UpdateAndPositions, ParticleSystemDataBallistic)
+    ->Name("BM_UpdateAndPositions_Ballistic")
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+BENCHMARK_TEMPLATE(BM_UpdateAndPositions, ParticleSystemDataQuantized)
+    ->Name("BM_UpdateAndPositions_Quantized")
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+// full frame with a grid rebuilt from positions(), the quantized layout decodes on the way in
+template <typename Layout>
+static void BM_UpdateAndGridBuild(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    ParticleSystem<Layout> ps(n, std::make_unique<UniformGrid>(cfg));
+    for (size_t i = 0; i < n; ++i)
+    {
+        Particle p{};
+        p.position = {float(i % 997) * 0.1f, float(i % 991) * 0.1f};
+        p.velocity = {float(i % 100) * 0.01f - 0.5f, float(i % 50) * 0.02f - 0.5f};
+        p.lifetime = 1000.0f;
+        ps.addParticle(p);
+    }
+
+    for (auto _ : state)
+    {
+        ps.update(0.016f);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_UpdateAndGridBuild, ParticleSystemDataSoA)
+    ->Name("BM_UpdateAndGridBuild_SoA")
+    ->Arg(100000)
+    ->Arg(1000000);
+
+BENCHMARK_TEMPLATE(BM_UpdateAndGridBuild, ParticleSystemDataQuantized)
+    ->Name("BM_UpdateAndGridBuild_Quantized")
+    ->Arg(100000)
+    ->Arg(1000000);
+
+// scene where most particles have settled, movers are scattered as a contiguous tail
+// args: particle count, percent settled, rest culling on/off
+static void BM_SettledScene_SoA(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const size_t settled = n * state.range(1) / 100;
+    ParticleSystemDataSoA layout(n);
+    if (state.range(2))
+    {
+        RestConfig rest;
+        rest.enabled = true;
+        rest.sleepFrames = 10;
+        layout.setRestConfig(rest);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Particle p{};
+        if (i >= settled)
+            p.velocity = {float(i % 100) * 0.01f + 0.1f, float(i % 50) * 0.01f};
+        p.lifetime = 1000.0f;
+        layout.add(p);
+    }
+
+    // let the settled blocks fall asleep
+    for (int f = 0; f < 20; ++f)
+        layout.update(0.016f);
+
+    for (auto _ : state)
+    {
+        PARTICLESIM_FRAME();
+        layout.update(0.016f, true);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+    state.counters["sleeping"] = static_cast<double>(layout.sleepingCount());
+}
+
+BENCHMARK(BM_SettledScene_SoA)
+    ->ArgNames({"n", "settled_pct", "rest"})
+    ->ArgsProduct({{100000, 1000000}, {90, 99}, {0, 1}});
+
+// args: particle count, percent of tier 4 particles, LOD level
+static void BM_TieredUpdate_SoA(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const size_t tieredPercent = state.range(1);
+    ParticleSystemDataSoA layout(n);
+    layout.setLodLevel(static_cast<uint8_t>(state.range(2)));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Particle p{};
+        p.velocity = {float(i % 100) * 0.01f, float(i % 50) * 0.01f};
+        p.lifetime = 1000.0f;
+        p.updateTier = i < n * tieredPercent / 100 ? 4 : 1; // contiguous, as an emitter would spawn them
+        layout.add(p);
+    }
+
+    PerfCounters perf;
+    perf.start();
+    for (auto _ : state)
+    {
+        PARTICLESIM_FRAME();
+        layout.update(0.016f);
+        benchmark::ClobberMemory();
+    }
+    perf.report(state);
+
+    state.SetItemsProcessed(n * state.iterations());
+}
+
+BENCHMARK(BM_TieredUpdate_SoA)
+    ->ArgNames({"n", "tier4_pct", "lod"})
+    ->ArgsProduct({{1000000}, {0, 50, 90}, {0, 2}});
+
+// steady state churn: every frame respawns what died, so births == deaths
+// args: particle count, percent of short-lived particles (0.25 s) - the rest live 60 s
+template <typename Layout>
+static void BM_SteadyStateChurn(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const size_t shortPercent = state.range(1);
+    Layout layout(n);
+    size_t spawned = 0;
+
+    auto spawn = [&]
+    {
+        Particle p{};
+        p.velocity = {float(spawned % 100) * 0.01f, float(spawned % 50) * 0.01f};
+        p.lifetime = (spawned % 100) < shortPercent ? 0.25f : 60.0f;
+        ++spawned;
+        return layout.add(p) != INVALID_INDEX;
+    };
+
+    while (layout.size() < n && spawn())
+        ;
+
+    size_t births = 0;
+    for (auto _ : state)
+    {
+        PARTICLESIM_FRAME();
+        layout.update(0.016f, true);
+        const size_t before = spawned;
+        while (layout.size() < n && spawn())
+            ;
+        births += spawned - before;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(n * state.iterations());
+    state.counters["births_per_frame"] = static_cast<double>(births) / state.iterations();
+}
+
+BENCHMARK_TEMPLATE(BM_SteadyStateChurn, ParticleSystemDataSoA)
+    ->Name("BM_SteadyStateChurn_SoA")
+    ->ArgNames({"n", "short_pct"})
+    ->ArgsProduct({{10000, 100000}, {0, 10, 90, 100}});
+
+BENCHMARK_TEMPLATE(BM_SteadyStateChurn, ParticleSystemDataAllocated)
+    ->Name("BM_SteadyStateChurn_Allocated")
+    ->ArgNames({"n", "short_pct"})
+    ->ArgsProduct({{10000, 100000}, {0, 10, 90, 100}});
+
+// expired cohorts between live ones are reclaimed by sliding the later cohorts down, so mixed
+// lifetimes show up as compaction cost on top of the truncation
+BENCHMARK_TEMPLATE(BM_SteadyStateChurn, ParticleSystemDataCohort)
+    ->Name("BM_SteadyStateChurn_Cohort")
+    ->ArgNames({"n", "short_pct"})
+    ->ArgsProduct({{10000, 100000}, {0, 10, 90, 100}});
+
 BENCHMARK_MAIN();
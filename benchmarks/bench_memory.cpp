@@ -0,0 +1,114 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "core/page_allocator.hpp"
+#include "particlesim/particle_system.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static const char *backingName(PageBacking backing)
+{
+    switch (backing)
+    {
+    case PageBacking::SmallPages:
+        return "4k";
+    case PageBacking::HugeAdvise:
+        return "thp";
+    case PageBacking::HugeExplicit:
+        return "hugetlb";
+    default:
+        return "heap";
+    }
+}
+
+// anonymous memory of the process currently on transparent huge pages
+static double anonHugePagesMb()
+{
+    double mb = 0.0;
+#if defined(__linux__)
+    if (FILE *f = std::fopen("/proc/self/smaps_rollup", "r"))
+    {
+        char line[256];
+        while (std::fgets(line, sizeof(line), f))
+        {
+            unsigned long kb = 0;
+            if (std::sscanf(line, "AnonHugePages: %lu kB", &kb) == 1)
+                mb = kb / 1024.0;
+        }
+        std::fclose(f);
+    }
+#endif
+    return mb;
+}
+
+// args: backing, particles
+static void BM_SoAUpdate_Pages(benchmark::State &state)
+{
+    const PageBacking backing = static_cast<PageBacking>(state.range(0));
+    const size_t n = state.range(1);
+
+    setDefaultPageBacking(backing);
+    ParticleSystemDataSoA data(n);
+    setDefaultPageBacking(PageBacking::Default);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Particle p{};
+        p.velocity = {float(i % 100) * 0.01f, float(i % 50) * 0.01f};
+        p.lifetime = 1000.0f;
+        data.add(p);
+    }
+
+    for (auto _ : state)
+    {
+        data.update(0.016f);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(backingName(backing));
+    state.SetItemsProcessed(n * state.iterations());
+    state.counters["anon_huge_mb"] = anonHugePagesMb();
+}
+
+// random reads over a large column - one TLB lookup per access, the worst case for 4 KB pages
+static void BM_RandomGather_Pages(benchmark::State &state)
+{
+    const PageBacking backing = static_cast<PageBacking>(state.range(0));
+    const size_t n = state.range(1);
+    constexpr size_t Reads = 1 << 20;
+
+    std::vector<float, PageAllocator<float>> column{PageAllocator<float>(backing)};
+    column.resize(n, 1.0f);
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> dist(0, static_cast<uint32_t>(n - 1));
+    std::vector<uint32_t> indices(Reads);
+    for (auto &i : indices)
+        i = dist(rng);
+
+    for (auto _ : state)
+    {
+        float sum = 0.f;
+        for (uint32_t i : indices)
+            sum += column[i];
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetLabel(backingName(backing));
+    state.SetItemsProcessed(Reads * state.iterations());
+    state.counters["anon_huge_mb"] = anonHugePagesMb();
+}
+
+static void PageBackingArgs(benchmark::internal::Benchmark *b, std::initializer_list<int64_t> sizes)
+{
+    for (PageBacking backing : {PageBacking::SmallPages, PageBacking::HugeAdvise, PageBacking::HugeExplicit})
+        for (int64_t n : sizes)
+            b->Args({static_cast<int64_t>(backing), n});
+}
+
+BENCHMARK(BM_SoAUpdate_Pages)->Apply([](auto *b)
+                                     { PageBackingArgs(b, {1 << 20, 4 << 20}); });
+BENCHMARK(BM_RandomGather_Pages)->Apply([](auto *b)
+                                        { PageBackingArgs(b, {1 << 20, 16 << 20}); });
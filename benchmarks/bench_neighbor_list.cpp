@@ -0,0 +1,70 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "particlesim/neighbor_list.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+// particles drift in fixed random directions and bounce off the world edges
+struct DriftingParticles
+{
+    std::vector<core::Vector2D> positions;
+    std::vector<core::Vector2D> directions;
+    WorldBounds world;
+
+    DriftingParticles(size_t n, const WorldBounds &bounds) : positions(n), directions(n), world(bounds)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> x(bounds.minX, bounds.maxX);
+        std::uniform_real_distribution<float> y(bounds.minY, bounds.maxY);
+        std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+        for (size_t i = 0; i < n; ++i)
+        {
+            positions[i] = {x(rng), y(rng)};
+            float a = angle(rng);
+            directions[i] = {std::cos(a), std::sin(a)};
+        }
+    }
+
+    void step(float distance)
+    {
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            auto &p = positions[i];
+            auto &d = directions[i];
+            p += d * distance;
+            if (p.x < world.minX || p.x > world.maxX)
+                d.x = -d.x;
+            if (p.y < world.minY || p.y > world.maxY)
+                d.y = -d.y;
+        }
+    }
+};
+
+// args: particle count, speed in hundredths of a world unit per frame, skin in hundredths
+static void BM_NeighborListAmortized(benchmark::State &state)
+{
+    const size_t N = state.range(0);
+    const float perFrame = state.range(1) / 100.f;
+    const float skin = state.range(2) / 100.f;
+
+    PartitioningConfig cfg;
+    cfg.world = {0.f, 0.f, 100.f, 100.f};
+    DriftingParticles particles(N, cfg.world);
+    NeighborListCache cache(cfg, {1.f, skin});
+
+    for (auto _ : state)
+    {
+        particles.step(perFrame);
+        benchmark::DoNotOptimize(cache.update(particles.positions));
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["rebuild_ratio"] = static_cast<double>(cache.rebuildCount()) / state.iterations();
+    state.counters["avg_neighbors"] = N ? static_cast<double>(cache.indices().size()) / N : 0.0;
+}
+
+BENCHMARK(BM_NeighborListAmortized)
+    ->ArgNames({"n", "speed", "skin"})
+    ->ArgsProduct({{10000, 100000}, {0, 1, 5, 20}, {0, 30}});
@@ -1,9 +1,12 @@
+#include <cmath>
 #include <random>
 #include <vector>
 #include "core/vector.hpp"
 #include "particlesim/spatial_partitioning.hpp"
+#include "particlesim/grid_tuner.hpp"
 #include "particlesim/particle.hpp"
 #include "benchmark/benchmark.h"
+#include "perf_counters.hpp"
 
 using namespace particlesim;
 
@@ -31,11 +34,11 @@ struct PartitioningBenchmarkData
 
     PartitioningBenchmarkData(size_t range, float cellSize)
         : particles(),
-          grid(makeConfig(cellSize)),
-          arena((range * sizeof(uint32_t) * 32) + (64 * 1024))
+          arena(64 * 1024), // chains more chunks when a dense frame needs them
+          grid(makeConfig(cellSize))
     {
         particles = generateParticles(range, grid.config.world);
-        grid.setData({particles, std::move(arena)});
+        grid.setData({particles, &arena});
     }
 
     static PartitioningConfig makeConfig(float cellSize)
@@ -54,11 +57,15 @@ static void BM_UniformGridBuild(benchmark::State &state)
     size_t N = state.range(0);
     auto data = PartitioningBenchmarkData<T>(N, S);
 
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state)
     {
         data.arena.reset();
+        data.grid.clear();
         data.grid.build();
     }
+    perf.report(state);
 
     state.SetItemsProcessed(N * state.iterations());
 }
@@ -70,6 +77,8 @@ static void BM_UniformGridQuery(benchmark::State &state)
     auto grid = PartitioningBenchmarkData<T>(N, S);
     grid.grid.build();
 
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state)
     {
         for (size_t i = 0; i < N; ++i)
@@ -78,14 +87,161 @@ static void BM_UniformGridQuery(benchmark::State &state)
             benchmark::DoNotOptimize(grid.grid.queryNeighborhood(static_cast<uint32_t>(i)));            
         }
     }
+    perf.report(state);
 
     state.SetItemsProcessed(N * state.iterations());
 }
 
+// same queries as BM_UniformGridQuery<UniformGridAllocated>, spread over the scheduler with
+// every worker writing its results into its own arena
+static void BM_UniformGridAllocatedQueryParallel(benchmark::State &state)
+{
+    size_t N = state.range(0);
+    auto data = PartitioningBenchmarkData<UniformGridAllocated>(N, 1.f);
+    data.grid.build();
+    ParallelScheduler scheduler;
+
+    for (auto _ : state)
+    {
+        scheduler.parallelFor(N, [&](size_t begin, size_t end, size_t worker)
+                              {
+            core::FrameArena &arena = scheduler.workerArena(worker);
+            for (size_t i = begin; i < end; ++i)
+            {
+                core::ScopedArenaMarker scope(arena);
+                benchmark::DoNotOptimize(data.grid.queryNeighborhood(static_cast<uint32_t>(i), arena));
+            } });
+        scheduler.resetArenas();
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["threads"] = static_cast<double>(scheduler.workerCount());
+}
+
+template <uint32_t K>
+static void BM_KDTreeKNearest(benchmark::State &state)
+{
+    size_t N = state.range(0);
+    auto data = PartitioningBenchmarkData<KDTree>(N, 1.f);
+    data.grid.build();
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            data.arena.reset();
+            benchmark::DoNotOptimize(data.grid.queryKNearest(static_cast<uint32_t>(i), K));
+        }
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+}
+
+template <uint32_t K>
+static void BM_KDTreeKNearestBatch(benchmark::State &state)
+{
+    size_t N = state.range(0);
+    auto data = PartitioningBenchmarkData<KDTree>(N, 1.f);
+    data.grid.build();
+    ParallelScheduler scheduler;
+
+    std::vector<uint32_t> ids(N);
+    for (size_t i = 0; i < N; ++i)
+        ids[i] = static_cast<uint32_t>(i);
+
+    for (auto _ : state)
+    {
+        data.arena.reset();
+        benchmark::DoNotOptimize(data.grid.queryKNearestBatch(ids, K, scheduler));
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["threads"] = static_cast<double>(scheduler.workerCount());
+}
+
+// every particle queries once per frame inside a dense cluster, the results of the whole
+// frame stay live in the arena until the reset
+static void BM_UniformGridAllocatedClusteredFrame(benchmark::State &state)
+{
+    const size_t N = state.range(0);
+    auto data = PartitioningBenchmarkData<UniformGridAllocated>(N, 1.f);
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> cluster(500.f, 3.f);
+    for (auto &p : data.particles)
+        p = {cluster(rng), cluster(rng)};
+    data.grid.build();
+
+    for (auto _ : state)
+    {
+        data.arena.reset();
+        for (size_t i = 0; i < N; ++i)
+            benchmark::DoNotOptimize(data.grid.queryNeighborhood(static_cast<uint32_t>(i)));
+    }
+
+    const core::ArenaStats stats = data.arena.stats();
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["arena_peak_mb"] = static_cast<double>(stats.highWaterMark) / (1024.0 * 1024.0);
+    state.counters["arena_chunks"] = static_cast<double>(stats.chunks);
+    state.counters["arena_overflows"] = static_cast<double>(stats.overflows);
+}
+
+// A cloud of particles that contracts to 2% of its radius and expands again every 600 frames,
+// one frame per iteration: clear, build and one query per particle. Arg is the cell size in
+// tenths for a fixed grid, 0 lets a GridAutoTuner pick it starting from 1.
+static void BM_UniformGridDensityChange(benchmark::State &state)
+{
+    constexpr size_t N = 20000;
+    constexpr int Period = 600;
+    const bool tuned = state.range(0) == 0;
+
+    PartitioningConfig cfg = PartitioningBenchmarkData<UniformGrid>::makeConfig(tuned ? 1.f : float(state.range(0)) / 10.f);
+    UniformGrid grid(cfg);
+    GridAutoTuner tuner;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> angle(0.f, 6.2831853f), radius(0.f, 1.f);
+    std::vector<Vector2D> offsets(N), positions(N);
+    for (auto &o : offsets)
+    {
+        const float a = angle(rng), r = 200.f * std::sqrt(radius(rng));
+        o = {r * std::cos(a), r * std::sin(a)};
+    }
+
+    int frame = 0;
+    double cellSizeSum = 0.0;
+    for (auto _ : state)
+    {
+        const float scale = 0.02f + 0.98f * (0.5f + 0.5f * std::cos(6.2831853f * float(frame++ % Period) / Period));
+        for (size_t i = 0; i < N; ++i)
+            positions[i] = Vector2D(500.f, 500.f) + offsets[i] * scale;
+
+        grid.clear();
+        grid.setData({positions, nullptr});
+        grid.build();
+        for (size_t i = 0; i < N; ++i)
+            benchmark::DoNotOptimize(grid.queryNeighborhood(static_cast<uint32_t>(i)));
+        if (tuned)
+            tuner.observe(grid);
+        cellSizeSum += grid.config.cellSize;
+    }
+
+    state.SetItemsProcessed(N * state.iterations());
+    state.counters["mean_cell_size"] = cellSizeSum / double(state.iterations());
+    state.counters["resizes"] = static_cast<double>(tuner.resizeCount());
+}
+
+BENCHMARK(BM_UniformGridDensityChange)->Arg(5)->Arg(10)->Arg(20)->Arg(40)->Arg(0)->Iterations(1800)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UniformGridAllocatedClusteredFrame)->Arg(1000)->Arg(10000);
 BENCHMARK(BM_UniformGridQuery<UniformGridAllocated>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+BENCHMARK(BM_UniformGridAllocatedQueryParallel)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000)->UseRealTime();
 BENCHMARK(BM_UniformGridBuild<UniformGrid>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
 BENCHMARK(BM_UniformGridQuery<UniformGrid>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
 BENCHMARK(BM_UniformGridQuery<UniformGrid, 0.5f>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
 BENCHMARK(BM_UniformGridQuery<UniformGrid, 2.f>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
 BENCHMARK(BM_UniformGridBuild<NoPartition>)->Arg(1000)->Arg(10000)->Arg(20000);
-BENCHMARK(BM_UniformGridQuery<NoPartition>)->Arg(1000)->Arg(10000)->Arg(20000);
\ No newline at end of file
+BENCHMARK(BM_UniformGridQuery<NoPartition>)->Arg(1000)->Arg(10000)->Arg(20000);
+BENCHMARK(BM_UniformGridBuild<KDTree>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+BENCHMARK(BM_KDTreeKNearest<8>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+BENCHMARK(BM_KDTreeKNearest<32>)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+BENCHMARK(BM_KDTreeKNearestBatch<8>)->Arg(10000)->Arg(100000);
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+#include "particlesim/publisher.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static void fillLayout(ParticleSystemDataSoA &layout, size_t n)
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {200.f, 200.f};
+    cfg.maxSpeed = 2.f;
+    cfg.minLifetime = 1000.f;
+    cfg.maxLifetime = 2000.f;
+    ParticleEmitter(cfg).emit(layout, n);
+}
+
+// what consumers did before: positions() on the simulation thread plus their own copy
+static void BM_Publish_PositionsCopy(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+    std::vector<core::Vector2D> copy;
+
+    for (auto _ : state)
+    {
+        const auto positions = layout.positions();
+        copy.assign(positions.begin(), positions.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// publish() alone, nobody reading
+static void BM_Publish_TripleBuffer(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+    FramePublisher publisher(n);
+
+    for (auto _ : state)
+        publisher.publish(layout.view());
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// publish() while a consumer thread keeps reading the newest frame
+static void BM_Publish_WithConsumer(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+    FramePublisher publisher(n);
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> consumed{0};
+    std::thread consumer([&]
+                         {
+                             uint64_t last = ~uint64_t{0};
+                             float sum = 0.f;
+                             while (!done.load(std::memory_order_relaxed))
+                             {
+                                 const PublishedFrame *f = publisher.latest();
+                                 if (!f || f->index == last)
+                                 {
+                                     std::this_thread::yield();
+                                     continue;
+                                 }
+                                 last = f->index;
+                                 for (float x : f->posX)
+                                     sum += x;
+                                 consumed.fetch_add(1, std::memory_order_relaxed);
+                             }
+                             benchmark::DoNotOptimize(sum); });
+
+    for (auto _ : state)
+        publisher.publish(layout.view());
+
+    done = true;
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["consumed_share"] = double(consumed.load()) / double(state.iterations());
+}
+
+BENCHMARK(BM_Publish_PositionsCopy)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Publish_TripleBuffer)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Publish_WithConsumer)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond)->UseRealTime();
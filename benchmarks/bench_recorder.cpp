@@ -0,0 +1,96 @@
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+#include "particlesim/recorder.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static std::string recordingPath()
+{
+    return (std::filesystem::temp_directory_path() / ("particlesim_bench_" + std::to_string(::getpid()) + ".rec")).string();
+}
+
+static void fillLayout(ParticleSystemDataSoA &layout, size_t n)
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {200.f, 200.f};
+    cfg.maxSpeed = 2.f;
+    cfg.acceleration = {0.f, -0.5f};
+    cfg.minLifetime = 1000.f;
+    cfg.maxLifetime = 2000.f;
+    ParticleEmitter(cfg).emit(layout, n);
+}
+
+// the frame alone, as the baseline for the recorder's share
+static void BM_Frame_NoRecording(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+
+    for (auto _ : state)
+    {
+        layout.update(1.f / 60.f);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_Frame_Recorder(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::string path = recordingPath();
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+
+    RecorderStats stats;
+    {
+        FrameRecorder recorder(path);
+        for (auto _ : state)
+        {
+            layout.update(1.f / 60.f);
+            recorder.record(layout.view());
+        }
+        recorder.close();
+        stats = recorder.stats();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["ratio"] = stats.compressionRatio();
+    state.counters["bytes_per_particle"] = double(stats.encodedBytes) / double(stats.frames * n);
+    state.counters["record_us"] = 1e6 * stats.recordSeconds / double(stats.frames);
+    state.counters["encode_us"] = 1e6 * stats.encodeSeconds / double(stats.frames);
+    state.counters["stalls"] = double(stats.stalls);
+    std::filesystem::remove(path);
+}
+
+// what the recorder replaces: positions() spans straight to disk
+static void BM_Frame_RawDump(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::string path = recordingPath();
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (auto _ : state)
+        {
+            layout.update(1.f / 60.f);
+            const auto positions = layout.positions();
+            out.write(reinterpret_cast<const char *>(positions.data()), positions.size_bytes());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["bytes_per_particle"] = double(sizeof(core::Vector2D));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_Frame_NoRecording)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Frame_Recorder)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_Frame_RawDump)->Arg(1 << 14)->Arg(1 << 18)->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "particlesim/particle_system.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+// Whole ParticleSystem::update frames in a steady state: a UniformGrid is built every frame,
+// particles move and die, and the dead are replaced by new ones right away, so births match
+// deaths and the count stays at n. The frame time includes the respawn.
+
+enum class Distribution
+{
+    Uniform,   // over the whole world
+    Clustered, // 32 gaussian blobs at random centres
+    Gaussian   // one blob in the middle
+};
+
+namespace
+{
+    constexpr float Density = 4.f; // particles per unit area for Uniform, one cell is 1 x 1
+    constexpr float MinLifetime = 0.5f;
+    constexpr float MaxLifetime = 4.f;
+    constexpr float MaxSpeed = 1.f;
+    constexpr size_t Clusters = 32;
+
+    class Scene
+    {
+    public:
+        Scene(size_t n, Distribution distribution) : distribution_(distribution), rng_(1234)
+        {
+            side_ = std::sqrt(float(n) / Density);
+            std::uniform_real_distribution<float> centre(0.1f * side_, 0.9f * side_);
+            for (size_t c = 0; c < Clusters; ++c)
+                centres_.push_back({centre(rng_), centre(rng_)});
+        }
+
+        WorldBounds world() const { return {0.f, 0.f, side_, side_}; }
+
+        Particle spawn()
+        {
+            Particle p{};
+            p.position = position();
+            const float angle = std::uniform_real_distribution<float>(0.f, 6.2831853f)(rng_);
+            const float speed = std::uniform_real_distribution<float>(0.f, MaxSpeed)(rng_);
+            p.velocity = {speed * std::cos(angle), speed * std::sin(angle)};
+            p.lifetime = std::uniform_real_distribution<float>(MinLifetime, MaxLifetime)(rng_);
+            return p;
+        }
+
+        // a particle part way through its life, so deaths are spread over frames from the start
+        Particle spawnAged()
+        {
+            Particle p = spawn();
+            p.lifetime *= std::uniform_real_distribution<float>(0.f, 1.f)(rng_);
+            return p;
+        }
+
+    private:
+        Distribution distribution_;
+        std::mt19937 rng_;
+        float side_ = 0.f;
+        std::vector<Vector2D> centres_;
+
+        Vector2D position()
+        {
+            Vector2D p;
+            switch (distribution_)
+            {
+            case Distribution::Uniform:
+            {
+                std::uniform_real_distribution<float> dist(0.f, side_);
+                p = {dist(rng_), dist(rng_)};
+                break;
+            }
+            case Distribution::Clustered:
+            {
+                const Vector2D c = centres_[std::uniform_int_distribution<size_t>(0, Clusters - 1)(rng_)];
+                std::normal_distribution<float> dist(0.f, side_ / 40.f);
+                p = {c.x + dist(rng_), c.y + dist(rng_)};
+                break;
+            }
+            case Distribution::Gaussian:
+            {
+                std::normal_distribution<float> dist(0.5f * side_, side_ / 8.f);
+                p = {dist(rng_), dist(rng_)};
+                break;
+            }
+            }
+            return {std::clamp(p.x, 0.f, side_), std::clamp(p.y, 0.f, side_)};
+        }
+    };
+
+    double percentile(std::vector<double> &sorted, double p)
+    {
+        const size_t rank = static_cast<size_t>(std::ceil(p * double(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    // full frames of ps with respawning, reporting the per-frame time distribution
+    template <typename Layout>
+    void runFrames(benchmark::State &state, ParticleSystem<Layout> &ps, Scene &scene, size_t n)
+    {
+        using clock = std::chrono::steady_clock;
+        const float dt = 0.016f;
+
+        size_t births = 0;
+        const auto frame = [&]()
+        {
+            ps.update(dt, true);
+            births += n - ps.size();
+            for (size_t i = ps.size(); i < n; ++i)
+                ps.addParticle(scene.spawn());
+        };
+        // the first frames grow the grid's buckets and the arena
+        for (int i = 0; i < 3; ++i)
+            frame();
+        births = 0;
+
+        std::vector<double> frameMs;
+        for (auto _ : state)
+        {
+            const auto start = clock::now();
+            frame();
+            frameMs.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+            benchmark::ClobberMemory();
+        }
+
+        std::sort(frameMs.begin(), frameMs.end());
+        state.counters["p50_ms"] = percentile(frameMs, 0.5);
+        state.counters["p99_ms"] = percentile(frameMs, 0.99);
+        state.counters["max_ms"] = frameMs.back();
+        state.counters["births_per_frame"] = double(births) / double(frameMs.size());
+        state.SetItemsProcessed(n * state.iterations());
+    }
+
+    PartitioningConfig gridConfig(const Scene &scene)
+    {
+        PartitioningConfig cfg;
+        cfg.cellSize = 1.f;
+        cfg.world = scene.world();
+        return cfg;
+    }
+}
+
+// args: particle count, distribution
+template <typename Layout>
+static void BM_Scenario(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    Scene scene(n, static_cast<Distribution>(state.range(1)));
+
+    ParticleSystem<Layout> ps(n, std::make_unique<UniformGrid>(gridConfig(scene)));
+    for (size_t i = 0; i < n; ++i)
+        ps.addParticle(scene.spawnAged());
+
+    runFrames(state, ps, scene, n);
+}
+
+// the same frames with overlap resolution on the grid, particles of radius 0.2
+static void BM_Scenario_SoA_Collisions(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    Scene scene(n, static_cast<Distribution>(state.range(1)));
+
+    ParticleSystem<ParticleSystemDataSoA> ps(n, std::make_unique<UniformGrid>(gridConfig(scene)));
+    CollisionConfig collisions;
+    collisions.radius = 0.2f;
+    ps.setCollisionSolver(std::make_unique<CollisionSolver>(collisions));
+    for (size_t i = 0; i < n; ++i)
+        ps.addParticle(scene.spawnAged());
+
+    runFrames(state, ps, scene, n);
+}
+
+static void scenarioArgs(benchmark::internal::Benchmark *b, int64_t maxN)
+{
+    b->ArgNames({"n", "dist"})->Unit(benchmark::kMillisecond);
+    for (int64_t n = 100000; n <= maxN; n *= 10)
+    {
+        for (Distribution d : {Distribution::Uniform, Distribution::Clustered, Distribution::Gaussian})
+            b->Args({n, static_cast<int64_t>(d)});
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Scenario, ParticleSystemDataSoA)
+    ->Name("BM_Scenario_SoA")
+    ->Apply([](benchmark::internal::Benchmark *b) { scenarioArgs(b, 10000000); });
+
+BENCHMARK_TEMPLATE(BM_Scenario, ParticleSystemDataAoS)
+    ->Name("BM_Scenario_AoS")
+    ->Apply([](benchmark::internal::Benchmark *b) { scenarioArgs(b, 1000000); });
+
+BENCHMARK_TEMPLATE(BM_Scenario, ParticleSystemDataAllocated)
+    ->Name("BM_Scenario_Allocated")
+    ->Apply([](benchmark::internal::Benchmark *b) { scenarioArgs(b, 1000000); });
+
+BENCHMARK(BM_Scenario_SoA_Collisions)
+    ->Apply([](benchmark::internal::Benchmark *b) { scenarioArgs(b, 1000000); });
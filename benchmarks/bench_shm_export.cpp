@@ -0,0 +1,77 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+#include "particlesim/shm_export.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static std::string segmentName() { return "/particlesim_bench_" + std::to_string(::getpid()); }
+
+static void fillLayout(ParticleSystemDataSoA &layout, size_t n)
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {200.f, 200.f};
+    cfg.maxSpeed = 2.f;
+    cfg.minLifetime = 1000.f;
+    cfg.maxLifetime = 2000.f;
+    ParticleEmitter(cfg).emit(layout, n);
+}
+
+// one frame into the segment: positions, alive flags and the alive count
+static void BM_SharedExport_Publish(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+    SharedFrameExport shared(segmentName(), n);
+
+    for (auto _ : state)
+        shared.publish(layout.view());
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * (2 * sizeof(float) + 1));
+}
+
+// the same with a reader scanning the newest frame in place on another thread
+static void BM_SharedExport_PublishWithReader(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    ParticleSystemDataSoA layout(n);
+    fillLayout(layout, n);
+    const std::string name = segmentName();
+    SharedFrameExport shared(name, n);
+    shared.publish(layout.view());
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0}, retries{0};
+    std::thread reader([&]
+                       {
+                           SharedFrameReader in(name);
+                           float sum = 0.f;
+                           while (!done.load(std::memory_order_relaxed))
+                           {
+                               const bool ok = in.read([&](const SharedFrameReader::Frame &f)
+                                                       {
+                                                           for (size_t i = 0; i < f.count; ++i)
+                                                               sum += f.posX[i]; });
+                               (ok ? reads : retries).fetch_add(1, std::memory_order_relaxed);
+                               std::this_thread::yield();
+                           }
+                           benchmark::DoNotOptimize(sum); });
+
+    for (auto _ : state)
+        shared.publish(layout.view());
+
+    done = true;
+    reader.join();
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["reads"] = double(reads.load());
+    state.counters["failed_reads"] = double(retries.load());
+}
+
+BENCHMARK(BM_SharedExport_Publish)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SharedExport_PublishWithReader)->Arg(1 << 20)->Unit(benchmark::kMicrosecond)->UseRealTime();
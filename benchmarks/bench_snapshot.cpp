@@ -0,0 +1,106 @@
+#include <filesystem>
+#include <unistd.h>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+#include "particlesim/snapshot.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static std::string snapshotPath()
+{
+    return (std::filesystem::temp_directory_path() / ("particlesim_bench_" + std::to_string(::getpid()) + ".snap")).string();
+}
+
+static std::vector<Particle> makeParticles(size_t n)
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {500.f, 500.f};
+    cfg.maxSpeed = 5.f;
+    cfg.maxLifetime = 10.f;
+    ParticleEmitter emitter(cfg);
+
+    std::vector<Particle> particles(n);
+    for (size_t i = 0; i < n; ++i)
+        particles[i] = emitter.sample(uint64_t{i});
+    return particles;
+}
+
+// the usual startup: every particle pushed through addParticle
+static void BM_Startup_AddParticle(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::vector<Particle> particles = makeParticles(n);
+
+    for (auto _ : state)
+    {
+        ParticleSystem<ParticleSystemDataSoA> system(n);
+        for (const Particle &p : particles)
+            system.addParticle(p);
+        benchmark::DoNotOptimize(system.layout().size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// map the file and copy whole columns in; the file stays in the page cache between iterations
+static void BM_Startup_Snapshot(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::string path = snapshotPath();
+    {
+        ParticleSystem<ParticleSystemDataSoA> source(n);
+        for (const Particle &p : makeParticles(n))
+            source.addParticle(p);
+        writeSnapshot(path, source.layout());
+    }
+
+    for (auto _ : state)
+    {
+        ParticleSystem<ParticleSystemDataSoA> system(n);
+        MappedSnapshot(path).restore(system.layout());
+        benchmark::DoNotOptimize(system.layout().size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    std::filesystem::remove(path);
+}
+
+// only mapping and validating, for readers that use the columns in place
+static void BM_Startup_SnapshotMapOnly(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::string path = snapshotPath();
+    {
+        ParticleSystemDataSoA source(n);
+        for (const Particle &p : makeParticles(n))
+            source.add(p);
+        writeSnapshot(path, source);
+    }
+
+    for (auto _ : state)
+    {
+        MappedSnapshot snapshot(path);
+        benchmark::DoNotOptimize(snapshot.column<float>(SnapshotField::Position));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    std::filesystem::remove(path);
+}
+
+static void BM_Snapshot_Write(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    const std::string path = snapshotPath();
+    ParticleSystemDataSoA source(n);
+    for (const Particle &p : makeParticles(n))
+        source.add(p);
+
+    for (auto _ : state)
+        writeSnapshot(path, source);
+    state.SetBytesProcessed(state.iterations() * n * (7 * sizeof(float) + 2));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_Startup_AddParticle)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Startup_Snapshot)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Startup_SnapshotMapOnly)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Snapshot_Write)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#include <memory>
+#include <vector>
+#include "particlesim/particle_world.hpp"
+#include "particlesim/particle_system.hpp"
+#include "benchmark/benchmark.h"
+
+using namespace particlesim;
+
+static Particle emitterParticle(size_t i)
+{
+    Particle p{};
+    p.velocity = {float(i % 100) * 0.01f, float(i % 50) * 0.01f};
+    p.lifetime = 1000.0f;
+    return p;
+}
+
+// args: emitters, particles per emitter
+static void BM_SeparateSystems(benchmark::State &state)
+{
+    const size_t emitters = state.range(0);
+    const size_t perEmitter = state.range(1);
+
+    std::vector<std::unique_ptr<ParticleSystem<ParticleSystemDataSoA>>> systems;
+    systems.reserve(emitters);
+    for (size_t e = 0; e < emitters; ++e)
+    {
+        systems.push_back(std::make_unique<ParticleSystem<ParticleSystemDataSoA>>(perEmitter));
+        for (size_t i = 0; i < perEmitter; ++i)
+            systems.back()->addParticle(emitterParticle(i));
+    }
+
+    for (auto _ : state)
+    {
+        for (auto &ps : systems)
+            ps->update(0.016f, true);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(emitters * perEmitter * state.iterations());
+}
+
+BENCHMARK(BM_SeparateSystems)
+    ->ArgNames({"emitters", "per_emitter"})
+    ->ArgsProduct({{1000, 10000}, {10, 100, 500}})
+    ->Unit(benchmark::kMicrosecond);
+
+// args: emitters, particles per emitter, workers (0 - calling thread only)
+static void BM_ParticleWorld(benchmark::State &state)
+{
+    const size_t emitters = state.range(0);
+    const size_t perEmitter = state.range(1);
+    const size_t workers = state.range(2);
+
+    std::unique_ptr<ParallelScheduler> scheduler;
+    if (workers > 0)
+        scheduler = std::make_unique<ParallelScheduler>(workers);
+
+    ParticleWorld world(emitters * perEmitter);
+    for (size_t e = 0; e < emitters; ++e)
+    {
+        EmitterID id = world.createEmitter(perEmitter, {{0.0f, -float(e % 10)}, 0.01f * float(e % 5)});
+        for (size_t i = 0; i < perEmitter; ++i)
+            world.add(id, emitterParticle(i));
+    }
+
+    for (auto _ : state)
+    {
+        world.update(0.016f, true, scheduler.get());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(emitters * perEmitter * state.iterations());
+}
+
+BENCHMARK(BM_ParticleWorld)
+    ->ArgNames({"emitters", "per_emitter", "workers"})
+    ->ArgsProduct({{1000, 10000}, {10, 100, 500}, {0, 4}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
@@ -0,0 +1,204 @@
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+#ifdef __linux__
+    struct EventSpec
+    {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr EventSpec specs[PerfCounters::EventCount] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+
+    int openEvent(const EventSpec &spec)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = spec.type;
+        attr.config = spec.config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1; // what perf_event_paranoid 2 allows
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+#endif
+}
+
+PerfCounters::PerfCounters()
+{
+    fds_.fill(-1);
+#ifdef __linux__
+    std::string missing;
+    int error = 0;
+    for (int e = 0; e < EventCount; ++e)
+    {
+        fds_[e] = openEvent(specs[e]);
+        if (fds_[e] < 0)
+        {
+            error = errno;
+            missing += std::string(missing.empty() ? "" : ", ") + name(Event(e));
+        }
+    }
+
+    // once per process, every benchmark opens its own set
+    static bool warned = false;
+    if (!missing.empty() && !warned)
+    {
+        warned = true;
+        std::fprintf(stderr, "perf counters unavailable: %s (%s)\n", missing.c_str(), std::strerror(error));
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int fd : fds_)
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+}
+
+void PerfCounters::start()
+{
+    values_.fill(0);
+#ifdef __linux__
+    for (int fd : fds_)
+    {
+        if (fd >= 0)
+        {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+    running_ = true;
+    startNs_ = nowNs();
+}
+
+void PerfCounters::stop()
+{
+    if (!running_)
+        return;
+    seconds_ = double(nowNs() - startNs_) * 1e-9;
+    running_ = false;
+#ifdef __linux__
+    for (int e = 0; e < EventCount; ++e)
+    {
+        if (fds_[e] < 0)
+            continue;
+        ::ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time enabled, time running
+        uint64_t data[3] = {};
+        if (::read(fds_[e], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+            continue;
+        // the kernel multiplexes when there are more events than hardware counters
+        values_[e] = data[2] < data[1] ? uint64_t(double(data[0]) * double(data[1]) / double(data[2])) : data[0];
+    }
+#endif
+}
+
+uint64_t PerfCounters::value(Event event) const
+{
+    return values_[event];
+}
+
+void PerfCounters::report(benchmark::State &state, double bytesPerIteration)
+{
+    stop();
+    const double iterations = double(std::max<benchmark::IterationCount>(state.iterations(), 1));
+
+    for (int e = 0; e < EventCount; ++e)
+    {
+        if (available(Event(e)))
+            state.counters[name(Event(e))] = double(values_[e]) / iterations;
+    }
+    if (available(Cycles) && available(Instructions) && values_[Cycles] > 0)
+        state.counters["IPC"] = double(values_[Instructions]) / double(values_[Cycles]);
+    if (available(CacheMisses))
+        state.counters["llc_bytes"] = double(values_[CacheMisses]) * 64.0 / iterations;
+
+    if (bytesPerIteration > 0.0 && seconds_ > 0.0)
+    {
+        const double gbps = bytesPerIteration * iterations / seconds_ * 1e-9;
+        state.counters["GB/s"] = gbps;
+        state.counters["of_stream"] = gbps / streamTriadGBps();
+    }
+}
+
+const char *PerfCounters::name(Event event)
+{
+    switch (event)
+    {
+    case Cycles:
+        return "cycles";
+    case Instructions:
+        return "instructions";
+    case CacheMisses:
+        return "llc_misses";
+    case L1DMisses:
+        return "l1d_misses";
+    case BranchMisses:
+        return "branch_misses";
+    case PageFaults:
+        return "page_faults";
+    case EventCount:
+        break;
+    }
+    return "?";
+}
+
+double streamTriadGBps()
+{
+    static const double baseline = []
+    {
+        // three 64 MiB arrays, far past any last level cache
+        constexpr size_t N = size_t{8} << 20;
+        std::vector<double> a(N, 0.0), b(N, 1.0), c(N, 2.0);
+        const double s = 3.0;
+
+        double best = 1e30;
+        for (int run = 0; run < 5; ++run)
+        {
+            const int64_t start = nowNs();
+            for (size_t i = 0; i < N; ++i)
+                a[i] = b[i] + s * c[i];
+            benchmark::DoNotOptimize(a.data());
+            benchmark::ClobberMemory();
+            best = std::min(best, double(nowNs() - start) * 1e-9);
+        }
+        return 3.0 * sizeof(double) * double(N) / best * 1e-9;
+    }();
+    return baseline;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "benchmark/benchmark.h"
+
+// Hardware counters for the benchmark loops through perf_event_open, reported as user counters.
+// Every event is opened on its own so a missing one (no PMU in a VM, perf_event_paranoid, not
+// Linux) only drops that counter; multiplexed events are scaled by their enabled / running time.
+// Counts the calling thread only, so threaded benchmarks report the main thread's share.
+//
+//     PerfCounters perf;
+//     perf.start();
+//     for (auto _ : state) { ... }
+//     perf.report(state, bytesPerIteration);
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        CacheMisses, // last level
+        L1DMisses,
+        BranchMisses,
+        PageFaults,
+        EventCount
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available(Event event) const { return fds_[event] >= 0; }
+
+    void start();
+    void stop();
+    // count since start(), 0 for unavailable events
+    uint64_t value(Event event) const;
+
+    // stops, then adds per-iteration counts, IPC and bytes from last level misses for what is
+    // available, and with bytesPerIteration the bandwidth as a rate and as a share of streamTriadGBps()
+    void report(benchmark::State &state, double bytesPerIteration = 0.0);
+
+    static const char *name(Event event);
+
+private:
+    std::array<int, EventCount> fds_;
+    std::array<uint64_t, EventCount> values_{};
+    double seconds_ = 0.0;
+    int64_t startNs_ = 0;
+    bool running_ = false;
+};
+
+// Sustained memory bandwidth of a STREAM triad a[i] = b[i] + s * c[i] over arrays well past the
+// last level cache, best of a few runs, measured once per process. Reads and writes both count.
+double streamTriadGBps();
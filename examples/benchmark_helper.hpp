@@ -1,8 +1,12 @@
 #pragma once
 #include <chrono>
-#include <functional>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <sstream>
 #include <string>
-#include <numeric>
+#include <utility>
+#include "core/hdr_histogram.hpp"
 
 class BenchmarkHelper
 {
@@ -13,16 +17,76 @@ public:
         double total_ms;   // total time (milliseconds)
         int iterations;
 
-        std::string tostring()
+        // per-iteration distribution (microseconds)
+        double stddev_us;
+        double min_us;
+        double p50_us;
+        double p90_us;
+        double p99_us;
+        double p999_us;
+        double max_us;
+
+        core::HdrHistogram histogram; // per-iteration times in nanoseconds
+
+        std::string tostring() const
         {
             std::ostringstream ss;
-            ss << "Update average: " << average_us << " us\n";
+            ss << "Update average: " << average_us << " us (stddev " << stddev_us << " us)\n";
+            ss << "p50 " << p50_us << " us, p90 " << p90_us << " us, p99 " << p99_us
+               << " us, p99.9 " << p999_us << " us, max " << max_us << " us\n";
             ss << "Total: " << total_ms << " ms over " << iterations << " iterations";
             return ss.str();
         }
+
+        // one row per non-empty histogram bucket: its upper bound, count and the share of iterations at or below it
+        void writeCsv(std::ostream &out) const
+        {
+            out << "upper_us,count,cumulative\n";
+            uint64_t seen = 0;
+            for (size_t b = 0; b < histogram.bucketCount(); ++b)
+            {
+                if (histogram.count(b) == 0)
+                    continue;
+                seen += histogram.count(b);
+                out << toUs(core::HdrHistogram::bucketUpperBound(b)) << ',' << histogram.count(b) << ','
+                    << double(seen) / double(histogram.total()) << '\n';
+            }
+        }
+
+        // the summary plus the non-empty buckets as [upper_us, count] pairs
+        void writeJson(std::ostream &out) const
+        {
+            out << "{\"iterations\": " << iterations << ", \"total_ms\": " << total_ms
+                << ", \"average_us\": " << average_us << ", \"stddev_us\": " << stddev_us
+                << ", \"min_us\": " << min_us << ", \"p50_us\": " << p50_us << ", \"p90_us\": " << p90_us
+                << ", \"p99_us\": " << p99_us << ", \"p999_us\": " << p999_us << ", \"max_us\": " << max_us
+                << ", \"histogram\": [";
+            const char *separator = "";
+            for (size_t b = 0; b < histogram.bucketCount(); ++b)
+            {
+                if (histogram.count(b) == 0)
+                    continue;
+                out << separator << '[' << toUs(core::HdrHistogram::bucketUpperBound(b)) << ", " << histogram.count(b) << ']';
+                separator = ", ";
+            }
+            out << "]}\n";
+        }
+
+        // CSV unless the path ends in .json, false when the file can't be written
+        bool save(const std::string &path) const
+        {
+            std::ofstream file(path);
+            if (!file)
+                return false;
+            if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0)
+                writeJson(file);
+            else
+                writeCsv(file);
+            return static_cast<bool>(file);
+        }
     };
 
-    // Runs benchmark on a callable F
+    // Runs benchmark on a callable F, timing every iteration on its own
     template <typename F>
     static Result run(F func,
                       int warmup_iterations = 200,
@@ -32,24 +96,38 @@ public:
         for (int i = 0; i < warmup_iterations; i++)
             func();
 
-        auto start = clock::now();
+        core::HdrHistogram histogram;
+        const auto start = clock::now();
+        auto last = start;
 
+        // consecutive readings share one clock call, so the loop adds a single now() per iteration
         for (int i = 0; i < measure_iterations; i++)
+        {
             func();
-
-        auto end = clock::now();
-
-        long long total_us =
-            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            const auto now = clock::now();
+            histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count()));
+            last = now;
+        }
 
         Result r;
-        r.total_ms = total_us / 1000.0f;
+        r.total_ms = std::chrono::duration<double, std::milli>(last - start).count();
         r.iterations = measure_iterations;
-        r.average_us = total_us / (float)measure_iterations;
+        r.average_us = measure_iterations ? r.total_ms * 1000.0 / measure_iterations : 0.0;
+        r.stddev_us = toUs(histogram.stddev());
+        r.min_us = toUs(histogram.min());
+        r.p50_us = toUs(histogram.percentile(0.5));
+        r.p90_us = toUs(histogram.percentile(0.9));
+        r.p99_us = toUs(histogram.percentile(0.99));
+        r.p999_us = toUs(histogram.percentile(0.999));
+        r.max_us = toUs(histogram.max());
+        r.histogram = std::move(histogram);
 
         return r;
     }
 
 private:
-    using clock = std::chrono::high_resolution_clock;
+    // steady and, through the vDSO, tens of nanoseconds per call
+    using clock = std::chrono::steady_clock;
+
+    static double toUs(double ns) { return ns / 1000.0; }
 };
@@ -1,38 +1,102 @@
 #include <iostream>
 #include "particlesim/particle_system.hpp"
+#include "particlesim/emitter.hpp"
 #include <chrono>
 #include <functional>
-#include <random>
+#include <string>
 #include "benchmark_helper.hpp"
 
 using namespace particlesim;
 
-Particle generate_particle(
+// reproducible stream of particles spread over a box - the same values whichever thread samples them
+ParticleEmitter make_emitter(
     float area_half_size = 50.0f,
     float max_speed = 5.0f,
     float max_acc = 1.0f,
     float min_life = 1.0f,
     float max_life = 10.0f)
 {
-    static thread_local std::mt19937 rng(std::random_device{}());
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Box;
+    cfg.halfExtents = {area_half_size, area_half_size};
+    cfg.maxSpeed = max_speed;
+    cfg.accelerationJitter = max_acc;
+    cfg.minLifetime = min_life;
+    cfg.maxLifetime = max_life;
 
-    std::uniform_real_distribution<float> pos_dist(-area_half_size, area_half_size);
-    std::uniform_real_distribution<float> vel_dist(-max_speed, max_speed);
-    std::uniform_real_distribution<float> acc_dist(-max_acc, max_acc);
-    std::uniform_real_distribution<float> life_dist(min_life, max_life);
+    return ParticleEmitter(cfg);
+}
+
+// the emitter's next count particles: written in place where the layout can append columns,
+// else sampled as one batch into scratch columns and added one by one
+template <typename Layout>
+void spawn(ParticleSystem<Layout> &ps, ParticleEmitter &emitter, ParticleSoA &scratch, size_t count)
+{
+    if (count == 0)
+        return;
+
+    if constexpr (requires { ps.layout().append(count); })
+    {
+        emitter.emit(ps.layout(), count);
+    }
+    else
+    {
+        scratch.resize(count);
+        auto &pos = scratch.field<Position>();
+        auto &vel = scratch.field<Velocity>();
+        auto &acc = scratch.field<Acceleration>();
+        auto &life = scratch.field<Lifetime>();
+        const ParticleSoAView out{pos.x(), pos.y(), vel.x(), vel.y(), acc.x(), acc.y(),
+                                  life.data(), scratch.field<Alive>().data(), count};
+
+        const uint64_t first = emitter.emitted();
+        emitter.sample(first, out);
+        emitter.restart(first + count);
 
-    Particle p;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle p;
+            p.position = {out.posX[i], out.posY[i]};
+            p.velocity = {out.velX[i], out.velY[i]};
+            p.acceleration = {out.accX[i], out.accY[i]};
+            p.lifetime = out.lifetime[i];
+            ps.addParticle(p);
+        }
+    }
+}
+
+// frame times of one layout holding `count` particles, dead ones replaced after every frame.
+// With an export prefix the distribution is also written to <prefix>_<name>.csv and .json
+template <typename Layout>
+void benchmark_layout(const std::string &name, size_t count, const std::string &export_prefix)
+{
+    ParticleSystem<Layout> ps(count);
+    ParticleEmitter emitter = make_emitter();
+    ParticleSoA scratch;
+    spawn(ps, emitter, scratch, count);
 
-    p.position = {pos_dist(rng), pos_dist(rng)};
-    p.velocity = {vel_dist(rng), vel_dist(rng)};
-    p.acceleration = {acc_dist(rng), acc_dist(rng)};
-    p.lifetime = life_dist(rng);
-    p.alive = true;
+    auto result = BenchmarkHelper::run([&]()
+                                       {
+        ps.update(0.016f, true);
+        spawn(ps, emitter, scratch, count - ps.size()); },
+                                       50, 1000);
 
-    return p;
+    std::cout << name << " (" << count << " particles)\n"
+              << result.tostring() << "\n\n";
+
+    if (!export_prefix.empty())
+    {
+        for (const char *extension : {".csv", ".json"})
+        {
+            const std::string path = export_prefix + "_" + name + extension;
+            if (!result.save(path))
+                std::cerr << "could not write " << path << "\n";
+        }
+    }
 }
 
-int main()
+// usage: particlesim_example [particle count] [export prefix]
+int main(int argc, char **argv)
 {
     ParticleSystem<ParticleSystemDataAoS> ps;
 
@@ -55,5 +119,11 @@ int main()
         ps.update(1.0f);
     }
 
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const std::string export_prefix = argc > 2 ? argv[2] : "";
+    benchmark_layout<ParticleSystemDataAoS>("AoS", count, export_prefix);
+    benchmark_layout<ParticleSystemDataSoA>("SoA", count, export_prefix);
+    benchmark_layout<ParticleSystemDataAllocated>("Allocated", count, export_prefix);
+
     return 0;
 }
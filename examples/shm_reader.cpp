@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/emitter.hpp"
+#include "particlesim/shm_export.hpp"
+
+using namespace particlesim;
+
+// Out-of-process consumer of a SharedFrameExport.
+//   particlesim_shm_reader /particles --simulate   exports a running simulation
+//   particlesim_shm_reader /particles              prints what another process exports, any number at once
+
+static int simulate(const std::string &name, int seconds)
+{
+    constexpr size_t Count = 100000;
+    ParticleSystem<ParticleSystemDataSoA> ps(Count);
+
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Disc;
+    cfg.radius = 50.0f;
+    cfg.maxSpeed = 5.0f;
+    cfg.acceleration = {0.0f, -1.0f};
+    cfg.minLifetime = 1.0f;
+    cfg.maxLifetime = 10.0f;
+    ParticleEmitter emitter(cfg);
+
+    SharedFrameExport shared(name, Count);
+    ps.setExport(&shared);
+    std::cout << "exporting to " << name << " for " << seconds << "s\n";
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        emitter.emit(ps.layout(), Count - ps.size());
+        ps.update(1.0f / 60.0f, true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    return 0;
+}
+
+static int read(const std::string &name, int seconds)
+{
+    SharedFrameReader reader(name);
+    uint64_t last = ~uint64_t{0};
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        SharedFrameReader::Frame frame;
+        float minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f;
+
+        // bounds straight from the shared columns, only printed when the writer left them alone meanwhile
+        const bool ok = reader.read([&](const SharedFrameReader::Frame &f)
+                                    {
+                                        frame = f;
+                                        minX = maxX = f.count ? f.posX[0] : 0.0f;
+                                        minY = maxY = f.count ? f.posY[0] : 0.0f;
+                                        for (size_t i = 1; i < f.count; ++i)
+                                        {
+                                            minX = std::min(minX, f.posX[i]);
+                                            maxX = std::max(maxX, f.posX[i]);
+                                            minY = std::min(minY, f.posY[i]);
+                                            maxY = std::max(maxY, f.posY[i]);
+                                        } });
+
+        if (ok && frame.frame != last)
+        {
+            last = frame.frame;
+            std::cout << "frame " << frame.frame << ": " << frame.aliveCount << "/" << frame.totalCount << " alive, x ["
+                      << minX << ", " << maxX << "], y [" << minY << ", " << maxY << "]\n";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " /name [--simulate] [seconds]\n";
+        return 2;
+    }
+
+    const std::string name = argv[1];
+    const bool producer = argc > 2 && std::strcmp(argv[2], "--simulate") == 0;
+    const int seconds = argc > 2 + producer ? std::stoi(argv[2 + producer]) : 10;
+
+    try
+    {
+        return producer ? simulate(name, seconds) : read(name, seconds);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
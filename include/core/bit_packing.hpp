@@ -0,0 +1,107 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace core
+{
+    // maps small magnitudes of either sign to small unsigned values: 0, -1, 1, -2 -> 0, 1, 2, 3
+    inline uint32_t zigzagEncode(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+    inline int32_t zigzagDecode(uint32_t v) { return static_cast<int32_t>((v >> 1) ^ (0u - (v & 1u))); }
+
+    // Block bit packing in the style of BP128: values go in blocks of PackBlockSize, each stored as
+    // one byte holding the bit width of its largest value followed by every value in that many bits,
+    // little-endian. An all-zero block costs a single byte.
+    inline constexpr size_t PackBlockSize = 128;
+
+    inline size_t packedBlockBytes(size_t count, uint32_t width) { return (count * width + 7) / 8; }
+
+    // appends values[0, count) to out
+    inline void packBlocks(const uint32_t *values, size_t count, std::vector<uint8_t> &out)
+    {
+        for (size_t base = 0; base < count; base += PackBlockSize)
+        {
+            const size_t n = count - base < PackBlockSize ? count - base : PackBlockSize;
+            const uint32_t *v = values + base;
+
+            uint32_t any = 0;
+            for (size_t i = 0; i < n; ++i)
+                any |= v[i];
+            const uint32_t width = static_cast<uint32_t>(std::bit_width(any));
+
+            const size_t start = out.size();
+            out.resize(start + 1 + packedBlockBytes(n, width));
+            uint8_t *p = out.data() + start;
+            *p++ = static_cast<uint8_t>(width);
+            if (width == 0)
+                continue;
+
+            // at most 31 + 32 bits pending, whole 32 bit words are written as they fill up
+            uint64_t acc = 0;
+            uint32_t filled = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                acc |= static_cast<uint64_t>(v[i]) << filled;
+                filled += width;
+                if (filled >= 32)
+                {
+                    p[0] = static_cast<uint8_t>(acc);
+                    p[1] = static_cast<uint8_t>(acc >> 8);
+                    p[2] = static_cast<uint8_t>(acc >> 16);
+                    p[3] = static_cast<uint8_t>(acc >> 24);
+                    p += 4;
+                    acc >>= 32;
+                    filled -= 32;
+                }
+            }
+            for (; filled > 0; filled = filled > 8 ? filled - 8 : 0, acc >>= 8)
+                *p++ = static_cast<uint8_t>(acc);
+        }
+    }
+
+    // reads count values packed by packBlocks from [in, end) and advances in past them,
+    // false when the input ends early or holds a width above 32
+    inline bool unpackBlocks(const uint8_t *&in, const uint8_t *end, size_t count, uint32_t *values)
+    {
+        const uint8_t *p = in;
+        for (size_t base = 0; base < count; base += PackBlockSize)
+        {
+            const size_t n = count - base < PackBlockSize ? count - base : PackBlockSize;
+            uint32_t *v = values + base;
+
+            if (p == end || *p > 32)
+                return false;
+            const uint32_t width = *p++;
+            const size_t bytes = packedBlockBytes(n, width);
+            if (static_cast<size_t>(end - p) < bytes)
+                return false;
+
+            if (width == 0)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    v[i] = 0;
+                continue;
+            }
+
+            const uint8_t *blockEnd = p + bytes;
+            const uint64_t mask = (uint64_t{1} << width) - 1;
+            uint64_t acc = 0;
+            uint32_t filled = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                while (filled < width)
+                {
+                    acc |= static_cast<uint64_t>(*p++) << filled;
+                    filled += 8;
+                }
+                v[i] = static_cast<uint32_t>(acc & mask);
+                acc >>= width;
+                filled -= width;
+            }
+            p = blockEnd;
+        }
+        in = p;
+        return true;
+    }
+}
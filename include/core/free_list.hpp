@@ -1,6 +1,8 @@
 #pragma once
 #include <cstddef>
 #include <cassert>
+#include <memory>
+#include "page_allocator.hpp"
 
 namespace core
 {
@@ -11,9 +13,10 @@ namespace core
     class FreeListPool
     {
     public:
-        explicit FreeListPool(size_t capacity)
-            : capacity_(capacity), nodes_(new Node[capacity])
+        explicit FreeListPool(size_t capacity, PageBacking backing = defaultPageBacking())
+            : capacity_(capacity), allocator_(backing), nodes_(allocator_.allocate(capacity))
         {
+            std::uninitialized_default_construct_n(nodes_, capacity_);
             for (size_t i = 0; i < capacity_ - 1; ++i)
             {
                 nodes_[i].nextFree = i + 1;
@@ -24,7 +27,8 @@ namespace core
 
         ~FreeListPool()
         {
-            delete[] nodes_;
+            std::destroy_n(nodes_, capacity_);
+            allocator_.deallocate(nodes_, capacity_);
         }
 
         size_t allocate()
@@ -66,6 +70,7 @@ namespace core
         };
 
         size_t capacity_;
+        PageAllocator<Node> allocator_;
         Node *nodes_;
         size_t freeHead_ = INVALID_INDEX;
     };
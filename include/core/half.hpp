@@ -0,0 +1,51 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+namespace core
+{
+    // IEEE 754 binary16 conversions for storage. Rounds to nearest even, overflow goes to infinity
+    // and NaN stays NaN - the same results _mm256_cvtps_ph / _mm256_cvtph_ps give with F16C.
+    // 11 significant bits: relative precision 2^-11, largest finite value 65504.
+    inline uint16_t floatToHalf(float f)
+    {
+        const uint32_t x = std::bit_cast<uint32_t>(f);
+        const uint32_t sign = (x >> 16) & 0x8000u;
+        uint32_t a = x & 0x7fffffffu;
+
+        if (a >= 0x7f800000u) // inf or nan
+            return static_cast<uint16_t>(sign | 0x7c00u | (a > 0x7f800000u ? 0x200u : 0u));
+        if (a >= 0x477ff000u) // rounds past 65504
+            return static_cast<uint16_t>(sign | 0x7c00u);
+
+        if (a < 0x38800000u)
+        {
+            // half subnormal - adding 0.5 lines the half ulp (2^-24) up with the float ulp
+            // so the FPU does the rounding
+            const float shifted = std::bit_cast<float>(a) + 0.5f;
+            return static_cast<uint16_t>(sign | (std::bit_cast<uint32_t>(shifted) - 0x3f000000u));
+        }
+
+        // rebias the exponent and round the 13 dropped mantissa bits to nearest even
+        const uint32_t odd = (a >> 13) & 1u;
+        a += 0xc8000fffu + odd;
+        return static_cast<uint16_t>(sign | (a >> 13));
+    }
+
+    inline float halfToFloat(uint16_t h)
+    {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+        const uint32_t exp = (h >> 10) & 0x1fu;
+        const uint32_t mant = h & 0x3ffu;
+
+        if (exp == 0)
+        {
+            const float v = static_cast<float>(mant) * 5.9604645e-8f; // 2^-24
+            return sign ? -v : v;
+        }
+        if (exp == 31)
+            return std::bit_cast<float>(sign | 0x7f800000u | (mant << 13));
+
+        return std::bit_cast<float>(sign | ((exp + 112u) << 23) | (mant << 13));
+    }
+}
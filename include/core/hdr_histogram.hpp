@@ -0,0 +1,68 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "log_linear_buckets.hpp"
+
+namespace core
+{
+    // Counts of unsigned values, e.g. latencies in nanoseconds, in log-linear buckets as HdrHistogram
+    // lays them out: every power-of-two range is split into SubBuckets equal buckets, so a bucket is
+    // never wider than 1 / SubBuckets of the values in it. Buckets are added as larger values arrive.
+    class HdrHistogram
+    {
+    public:
+        static constexpr unsigned SubBucketBits = 5;
+        using Buckets = LogLinearBuckets<SubBucketBits>;
+        static constexpr uint64_t SubBuckets = Buckets::SubBuckets;
+
+        static constexpr size_t bucketOf(uint64_t value) { return Buckets::bucketOf(value); }
+        static constexpr uint64_t bucketLowerBound(size_t bucket) { return Buckets::lowerBound(bucket); }
+        // largest value that falls into the bucket
+        static constexpr uint64_t bucketUpperBound(size_t bucket) { return Buckets::upperBound(bucket); }
+
+        void record(uint64_t value)
+        {
+            const size_t bucket = bucketOf(value);
+            if (bucket >= counts_.size())
+                counts_.resize(bucket + 1);
+            ++counts_[bucket];
+            if (total_ == 0 || value < min_)
+                min_ = value;
+            max_ = max_ < value ? value : max_;
+            ++total_;
+            sum_ += double(value);
+            sumSquares_ += double(value) * double(value);
+        }
+
+        void clear() { *this = {}; }
+
+        // buckets up to the one holding max()
+        size_t bucketCount() const { return counts_.size(); }
+        uint64_t count(size_t bucket) const { return bucket < counts_.size() ? counts_[bucket] : 0; }
+        uint64_t total() const { return total_; }
+        uint64_t min() const { return min_; }
+        uint64_t max() const { return max_; }
+        double mean() const { return total_ ? sum_ / double(total_) : 0.0; }
+        double stddev() const
+        {
+            if (total_ == 0)
+                return 0.0;
+            const double m = mean();
+            const double variance = sumSquares_ / double(total_) - m * m;
+            return variance > 0.0 ? std::sqrt(variance) : 0.0;
+        }
+
+        // upper bound of the bucket holding the nearest-rank percentile, p in [0, 1], capped at max()
+        uint64_t percentile(double p) const { return Buckets::percentile(counts_.data(), counts_.size(), total_, max_, p); }
+
+    private:
+        std::vector<uint64_t> counts_;
+        uint64_t total_ = 0;
+        uint64_t min_ = 0;
+        uint64_t max_ = 0;
+        double sum_ = 0.0;
+        double sumSquares_ = 0.0;
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include "log_linear_buckets.hpp"
+
+namespace core
+{
+    // Counts of small unsigned values in power-of-two bins: bin 0 holds 0, bin k holds [2^(k-1), 2^k).
+    // LogLinearBuckets without sub-buckets, in a fixed array and with integer sums so it is cheap
+    // enough to feed from inner loops, e.g. one record() per neighbor query.
+    class Log2Histogram
+    {
+    public:
+        static constexpr size_t Bins = 33;
+        using Buckets = LogLinearBuckets<0>;
+
+        static constexpr size_t binOf(uint32_t value) { return Buckets::bucketOf(value); }
+        // largest value that falls into the bin
+        static constexpr uint32_t binUpperBound(size_t bin) { return static_cast<uint32_t>(Buckets::upperBound(bin)); }
+
+        void record(uint32_t value)
+        {
+            ++bins_[binOf(value)];
+            ++total_;
+            sum_ += value;
+            sumSquares_ += uint64_t{value} * value;
+            max_ = max_ < value ? value : max_;
+        }
+
+        // a value recorded earlier as size - 1 became size, e.g. a bucket that took one more
+        // element. It only changes bin when size reaches a power of two; size 1 is a new value.
+        void grown(uint32_t size)
+        {
+            if (size == 1)
+            {
+                record(1);
+                return;
+            }
+            ++sum_;
+            sumSquares_ += 2 * uint64_t{size} - 1;
+            max_ = max_ < size ? size : max_;
+            if (std::has_single_bit(size))
+            {
+                const size_t bin = binOf(size);
+                --bins_[bin - 1];
+                ++bins_[bin];
+            }
+        }
+
+        void clear() { *this = {}; }
+
+        uint64_t count(size_t bin) const { return bins_[bin]; }
+        uint64_t total() const { return total_; }
+        uint64_t sum() const { return sum_; }
+        uint64_t sumSquares() const { return sumSquares_; }
+        uint32_t max() const { return max_; }
+        double mean() const { return total_ ? double(sum_) / double(total_) : 0.0; }
+        // mean weighted by the values themselves, e.g. the bucket size the average element sits in
+        double weightedMean() const { return sum_ ? double(sumSquares_) / double(sum_) : 0.0; }
+
+        // upper bound of the bin holding the nearest-rank percentile, p in [0, 1], capped at max()
+        uint32_t percentile(double p) const { return static_cast<uint32_t>(Buckets::percentile(bins_.data(), Bins, total_, max_, p)); }
+
+    private:
+        std::array<uint64_t, Bins> bins_{};
+        uint64_t total_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t sumSquares_ = 0;
+        uint32_t max_ = 0;
+    };
+}
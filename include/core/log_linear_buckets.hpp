@@ -0,0 +1,53 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+    // Log-linear bucket layout, as in the HdrHistogram scheme: values below 2 * SubBuckets get a
+    // bucket each, above that every power-of-two range is split into SubBuckets equal buckets.
+    // With SubBucketBits = 0 the buckets are plain powers of two: 0, 1, [2, 3], [4, 7], ...
+    template <unsigned SubBucketBits>
+    struct LogLinearBuckets
+    {
+        static constexpr uint64_t SubBuckets = uint64_t{1} << SubBucketBits;
+
+        // above 2 * SubBuckets the top SubBucketBits + 1 bits pick the bucket
+        static constexpr size_t bucketOf(uint64_t value)
+        {
+            const unsigned width = static_cast<unsigned>(std::bit_width(value));
+            const unsigned shift = width > SubBucketBits + 1 ? width - SubBucketBits - 1 : 0;
+            return static_cast<size_t>(shift * SubBuckets + (value >> shift));
+        }
+        static constexpr uint64_t lowerBound(size_t bucket)
+        {
+            const size_t shift = bucket < 2 * SubBuckets ? 0 : bucket / SubBuckets - 1;
+            return (uint64_t{bucket} - shift * SubBuckets) << shift;
+        }
+        // largest value that falls into the bucket
+        static constexpr uint64_t upperBound(size_t bucket) { return lowerBound(bucket + 1) - 1; }
+
+        // upper bound of the bucket holding the nearest-rank percentile, p in [0, 1], capped at max;
+        // counts holds the first buckets in order and total is their sum
+        static uint64_t percentile(const uint64_t *counts, size_t buckets, uint64_t total, uint64_t max, double p)
+        {
+            if (total == 0)
+                return 0;
+            uint64_t rank = static_cast<uint64_t>(std::ceil(p * double(total)));
+            rank = rank < 1 ? 1 : rank;
+            uint64_t seen = 0;
+            for (size_t bucket = 0; bucket < buckets; ++bucket)
+            {
+                seen += counts[bucket];
+                if (seen >= rank)
+                {
+                    const uint64_t upper = upperBound(bucket);
+                    return upper < max ? upper : max;
+                }
+            }
+            return max;
+        }
+    };
+}
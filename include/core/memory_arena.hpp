@@ -1,50 +1,52 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 #include <type_traits>
 #include <stdexcept>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "page_allocator.hpp"
 
 namespace core
 {
+    enum class ArenaGrowth
+    {
+        Fixed, // one buffer, allocations past it throw std::bad_alloc
+        Chain  // overflowing allocations link another chunk, chunks are kept across reset()
+    };
+
+    struct ArenaStats
+    {
+        size_t bytesUsed = 0;     // since the last reset, alignment padding included
+        size_t capacity = 0;      // over all chunks
+        size_t chunks = 0;
+        size_t overflows = 0;     // allocations that did not fit the chunk they started in
+        size_t highWaterMark = 0; // largest bytesUsed seen at a reset or now
+    };
+
     class FrameArena
     {
     public:
-        FrameArena(size_t size = 1024 * 1024)
+        // resets between two rebalances of a chained arena
+        static constexpr uint32_t DefaultRebalanceInterval = 256;
+
+        FrameArena(size_t size = 1024 * 1024, ArenaGrowth growth = ArenaGrowth::Chain,
+                   PageBacking backing = defaultPageBacking())
+            : growth_(growth), backing_(backing)
         {
-            buffer_ = new char[size];
-            capacity_ = size;
-            head_ = 0;
+            addChunk(size);
         }
-        
+
         // deep copy
-        FrameArena(const FrameArena &other)
-        {
-            capacity_ = other.capacity_;
-            head_ = other.head_;
-            if (other.buffer_)
-            {
-                buffer_ = new char[capacity_];
-                memcpy(buffer_, other.buffer_, head_);
-            }
-            else
-            {
-                buffer_ = nullptr;
-            }
-        }
+        FrameArena(const FrameArena &other) { copyFrom(other); }
 
         // movable
-        FrameArena(FrameArena &&other) noexcept
-            : buffer_(other.buffer_), capacity_(other.capacity_), head_(other.head_)
-        {
-            other.buffer_ = nullptr;
-            other.capacity_ = 0;
-            other.head_ = 0;
-        }
+        FrameArena(FrameArena &&other) noexcept = default;
 
-        ~FrameArena()
-        {
-            delete[] buffer_;
-        }
+        ~FrameArena() = default;
 
         template <typename T>
         T* allocate()
@@ -59,70 +61,224 @@ namespace core
         {
             assert(std::is_trivially_destructible_v<T> && "FrameArena can only allocate trivially destructible types");
 
-            size_t alignment = alignof(T);
-            size_t size = sizeof(T) * count;
+            const size_t alignment = alignof(T);
+            const size_t size = sizeof(T) * count;
 
-            size_t current = reinterpret_cast<uintptr_t>(buffer_) + head_;
-            size_t aligned = (current + alignment - 1) & ~(alignment - 1);
-            size_t padding = aligned - current;
+            if (!chunks_.empty())
+            {
+                if (char *ptr = tryAllocate(chunks_[current_], size, alignment))
+                    return reinterpret_cast<T *>(ptr);
+            }
 
-            if (head_ + padding + size > capacity_)
+            if (growth_ == ArenaGrowth::Fixed)
             {
+                ++overflows_;
                 throw std::bad_alloc();
             }
 
-            head_ += padding;
-            T* ptr = reinterpret_cast<T*>(buffer_ + head_);
-            head_ += size;
-            return ptr;
+            return reinterpret_cast<T *>(allocateOverflow(size, alignment));
         }
-        
+
         void reset()
-        { 
+        {
             // can be subscribed for an event of a global frame manager
-            head_ = 0;
+            const size_t used = bytesUsed();
+            highWater_ = std::max(highWater_, used);
+            windowPeak_ = std::max(windowPeak_, used);
+
+            for (size_t c = 0; c <= current_ && c < chunks_.size(); ++c)
+                chunks_[c].head = 0;
+            current_ = 0;
+            finished_ = 0;
+
+            if (growth_ == ArenaGrowth::Chain && rebalanceInterval_ > 0 && ++resets_ >= rebalanceInterval_)
+                rebalance();
+        }
+
+        // position of the bump pointer, rewind() releases everything allocated after it.
+        // A marker is only valid until the next reset().
+        struct Marker
+        {
+            size_t chunk = 0;
+            size_t head = 0;
+            size_t finished = 0;
+        };
+
+        Marker mark() const { return {current_, chunks_.empty() ? 0 : chunks_[current_].head, finished_}; }
+
+        void rewind(const Marker &marker)
+        {
+            if (marker.chunk >= chunks_.size())
+                return;
+            assert(marker.chunk <= current_ && "marker is newer than the bump pointer");
+
+            const size_t used = bytesUsed();
+            highWater_ = std::max(highWater_, used);
+            windowPeak_ = std::max(windowPeak_, used);
+
+            current_ = marker.chunk;
+            chunks_[current_].head = marker.head;
+            finished_ = marker.finished;
+        }
+
+        // every `resets` resets a chained arena is replaced by one chunk sized to the peak seen
+        // since the last rebalance, 0 keeps the chunks forever
+        void setRebalanceInterval(uint32_t resets) { rebalanceInterval_ = resets; }
+
+        ArenaStats stats() const
+        {
+            ArenaStats s;
+            s.bytesUsed = bytesUsed();
+            s.capacity = capacity();
+            s.chunks = chunks_.size();
+            s.overflows = overflows_;
+            s.highWaterMark = std::max(highWater_, s.bytesUsed);
+            return s;
+        }
+
+        size_t capacity() const
+        {
+            size_t total = 0;
+            for (const Chunk &c : chunks_)
+                total += c.size;
+            return total;
         }
 
         FrameArena &operator=(const FrameArena &other)
         {
             if (this != &other)
+                copyFrom(other);
+            return *this;
+        }
+
+        FrameArena &operator=(FrameArena &&other) noexcept = default;
+
+    private:
+        struct PageDeleter
+        {
+            size_t size = 0;
+            PageBacking backing = PageBacking::Default;
+            void operator()(char *p) const noexcept { freePages(p, size, backing); }
+        };
+
+        struct Chunk
+        {
+            std::unique_ptr<char[], PageDeleter> data;
+            size_t size = 0;
+            size_t head = 0;
+        };
+
+        // smallest chunk a rebalance shrinks to
+        static constexpr size_t MinChunkSize = 4 * 1024;
+
+        std::vector<Chunk> chunks_;
+        ArenaGrowth growth_ = ArenaGrowth::Chain;
+        PageBacking backing_ = PageBacking::Default;
+        size_t current_ = 0;
+        size_t finished_ = 0; // bytes used in chunks before current_
+        size_t overflows_ = 0;
+        size_t highWater_ = 0;
+        size_t windowPeak_ = 0;
+        uint32_t resets_ = 0;
+        uint32_t rebalanceInterval_ = DefaultRebalanceInterval;
+
+        size_t bytesUsed() const { return chunks_.empty() ? 0 : finished_ + chunks_[current_].head; }
+
+        static char *tryAllocate(Chunk &chunk, size_t size, size_t alignment)
+        {
+            const uintptr_t current = reinterpret_cast<uintptr_t>(chunk.data.get()) + chunk.head;
+            const uintptr_t aligned = (current + alignment - 1) & ~(alignment - 1);
+            const size_t padding = aligned - current;
+
+            if (chunk.head + padding + size > chunk.size)
+                return nullptr;
+
+            chunk.head += padding + size;
+            return reinterpret_cast<char *>(aligned);
+        }
+
+        void addChunk(size_t size)
+        {
+            std::unique_ptr<char[], PageDeleter> data(static_cast<char *>(allocatePages(size, backing_)), PageDeleter{size, backing_});
+            chunks_.push_back({std::move(data), size, 0});
+        }
+
+        // continues in the next kept chunk that fits, or links a new one twice as large as the last
+        char *allocateOverflow(size_t size, size_t alignment)
+        {
+            ++overflows_;
+            if (chunks_.empty())
             {
-                delete[] buffer_;
-                capacity_ = other.capacity_;
-                head_ = other.head_;
-                if (other.buffer_)
-                {
-                    buffer_ = new char[capacity_];
-                    memcpy(buffer_, other.buffer_, head_);
-                }
-                else
-                {
-                    buffer_ = nullptr;
-                }
+                // moved-from arena
+                addChunk(size + alignment);
+                current_ = 0;
+                finished_ = 0;
+                return tryAllocate(chunks_[0], size, alignment);
             }
-            return *this;
+
+            while (current_ + 1 < chunks_.size())
+            {
+                finished_ += chunks_[current_].head;
+                ++current_;
+                chunks_[current_].head = 0;
+                if (char *ptr = tryAllocate(chunks_[current_], size, alignment))
+                    return ptr;
+            }
+
+            finished_ += chunks_[current_].head;
+            addChunk(std::max(size + alignment, 2 * chunks_.back().size));
+            current_ = chunks_.size() - 1;
+            return tryAllocate(chunks_[current_], size, alignment);
         }
 
-        FrameArena &operator=(FrameArena &&other) noexcept
+        void rebalance()
         {
-            if (this != &other)
+            // a quarter of headroom over the peak
+            const size_t target = std::max(MinChunkSize, windowPeak_ + windowPeak_ / 4);
+            const size_t total = capacity();
+            if (chunks_.size() > 1 || total > 2 * target)
             {
-                delete[] buffer_;
-                buffer_ = other.buffer_;
-                capacity_ = other.capacity_;
-                head_ = other.head_;
-
-                other.buffer_ = nullptr;
-                other.capacity_ = 0;
-                other.head_ = 0;
+                chunks_.clear();
+                addChunk(target);
             }
-            return *this;
+
+            resets_ = 0;
+            windowPeak_ = 0;
         }
 
-    private:
-        char* buffer_ = nullptr;
-        size_t capacity_ = 0;
-        size_t head_ = 0;
+        void copyFrom(const FrameArena &other)
+        {
+            chunks_.clear();
+            backing_ = other.backing_;
+            for (const Chunk &c : other.chunks_)
+            {
+                addChunk(c.size);
+                chunks_.back().head = c.head;
+                memcpy(chunks_.back().data.get(), c.data.get(), c.head);
+            }
+            growth_ = other.growth_;
+            current_ = other.current_;
+            finished_ = other.finished_;
+            overflows_ = other.overflows_;
+            highWater_ = other.highWater_;
+            windowPeak_ = other.windowPeak_;
+            resets_ = other.resets_;
+            rebalanceInterval_ = other.rebalanceInterval_;
+        }
     };
 
-}
\ No newline at end of file
+    // rewinds the arena to where it was on construction, for nested per-call temporaries
+    class ScopedArenaMarker
+    {
+    public:
+        explicit ScopedArenaMarker(FrameArena &arena) : arena_(arena), marker_(arena.mark()) {}
+        ~ScopedArenaMarker() { arena_.rewind(marker_); }
+
+        ScopedArenaMarker(const ScopedArenaMarker &) = delete;
+        ScopedArenaMarker &operator=(const ScopedArenaMarker &) = delete;
+
+    private:
+        FrameArena &arena_;
+        FrameArena::Marker marker_;
+    };
+}
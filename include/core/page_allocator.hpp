@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace core
+{
+    enum class PageBacking
+    {
+        Default,     // regular heap
+        SmallPages,  // anonymous mapping kept on 4 KB pages
+        HugeAdvise,  // anonymous mapping advised for transparent 2 MB pages
+        HugeExplicit // MAP_HUGETLB from the reserved 2 MB pool, HugeAdvise when the pool is empty
+    };
+
+    inline constexpr size_t SmallPageSize = 4 * 1024;
+    inline constexpr size_t HugePageSize = 2 * 1024 * 1024;
+    // smaller blocks stay on the heap whatever the backing, a mapping per small vector costs more than it saves
+    inline constexpr size_t PageMappingThreshold = 64 * 1024;
+
+    namespace detail
+    {
+        inline std::atomic<PageBacking> &defaultBacking()
+        {
+            static std::atomic<PageBacking> backing{PageBacking::Default};
+            return backing;
+        }
+
+        inline std::atomic<size_t> &hugeFallbacks()
+        {
+            static std::atomic<size_t> count{0};
+            return count;
+        }
+
+        inline bool mapped(size_t bytes, PageBacking backing)
+        {
+#if defined(__linux__)
+            return backing != PageBacking::Default && bytes >= PageMappingThreshold;
+#else
+            (void)bytes;
+            (void)backing;
+            return false;
+#endif
+        }
+
+        // Mappings start page aligned, so equal indices of columns mapped side by side would share
+        // a cache set and evict each other. Every mapping hands out its block at the next cache line
+        // colour instead, kept below one small page so freeing can round back to the mapping start.
+        inline constexpr size_t ColourStride = 64;
+        inline constexpr size_t Colours = SmallPageSize / ColourStride;
+
+        inline size_t nextColourOffset()
+        {
+            static std::atomic<size_t> colour{0};
+            return (colour.fetch_add(1, std::memory_order_relaxed) % Colours) * ColourStride;
+        }
+
+        inline size_t mappingSize(size_t bytes, PageBacking backing)
+        {
+            const size_t page = backing == PageBacking::SmallPages ? SmallPageSize : HugePageSize;
+            return (bytes + SmallPageSize + page - 1) & ~(page - 1);
+        }
+    }
+
+    // backing picked up by allocators constructed without one, e.g. every SoA column
+    inline void setDefaultPageBacking(PageBacking backing) { detail::defaultBacking().store(backing); }
+    inline PageBacking defaultPageBacking() { return detail::defaultBacking().load(); }
+
+    // HugeExplicit requests that found no reserved huge pages
+    inline size_t hugePageFallbacks() { return detail::hugeFallbacks().load(); }
+
+    // Mapped memory is not touched here: a page is placed on the NUMA node of the thread that
+    // first writes it, see ParallelScheduler::firstTouch. Aligned to at least a cache line.
+    inline void *allocatePages(size_t bytes, PageBacking backing)
+    {
+        if (!detail::mapped(bytes, backing))
+            return ::operator new(bytes, std::align_val_t{64});
+
+#if defined(__linux__)
+        const size_t size = detail::mappingSize(bytes, backing);
+        void *p = MAP_FAILED;
+        if (backing == PageBacking::HugeExplicit)
+        {
+            p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED)
+                detail::hugeFallbacks().fetch_add(1);
+        }
+        if (p == MAP_FAILED)
+        {
+            p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+                throw std::bad_alloc();
+            // advice only, kernels without THP keep 4 KB pages
+            madvise(p, size, backing == PageBacking::SmallPages ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+        }
+        return static_cast<char *>(p) + detail::nextColourOffset();
+#else
+        return nullptr;
+#endif
+    }
+
+    // bytes and backing must match the allocatePages() call
+    inline void freePages(void *p, size_t bytes, PageBacking backing) noexcept
+    {
+        if (!p)
+            return;
+        if (!detail::mapped(bytes, backing))
+        {
+            ::operator delete(p, std::align_val_t{64});
+            return;
+        }
+#if defined(__linux__)
+        const uintptr_t start = reinterpret_cast<uintptr_t>(p) & ~uintptr_t(SmallPageSize - 1);
+        munmap(reinterpret_cast<void *>(start), detail::mappingSize(bytes, backing));
+#endif
+    }
+
+    // std allocator over allocatePages, e.g. std::vector<float, PageAllocator<float>>
+    template <typename T>
+    class PageAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        PageAllocator() noexcept : backing_(defaultPageBacking()) {}
+        explicit PageAllocator(PageBacking backing) noexcept : backing_(backing) {}
+
+        template <typename U>
+        PageAllocator(const PageAllocator<U> &other) noexcept : backing_(other.backing()) {}
+
+        T *allocate(size_t n) { return static_cast<T *>(allocatePages(n * sizeof(T), backing_)); }
+        void deallocate(T *p, size_t n) noexcept { freePages(p, n * sizeof(T), backing_); }
+
+        PageBacking backing() const { return backing_; }
+
+        template <typename U>
+        bool operator==(const PageAllocator<U> &other) const { return backing_ == other.backing(); }
+
+    private:
+        PageBacking backing_;
+    };
+}
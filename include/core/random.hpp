@@ -0,0 +1,135 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CORE_PHILOX_SSE2
+#endif
+
+namespace core
+{
+    // Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+    // Output is a pure function of a 128-bit counter and a 64-bit key, so any element of a stream
+    // can be produced directly - no state to share or advance between threads.
+    class Philox4x32
+    {
+    public:
+        using Counter = std::array<uint32_t, 4>;
+        using Key = std::array<uint32_t, 2>;
+
+        static constexpr uint32_t Rounds = 10;
+
+        static constexpr Key keyFromSeed(uint64_t seed) { return {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}; }
+
+        static Counter generate(Counter ctr, Key key)
+        {
+            for (uint32_t r = 0; r < Rounds; ++r)
+            {
+                if (r > 0)
+                    bumpKey(key);
+                round(ctr[0], ctr[1], ctr[2], ctr[3], key[0], key[1]);
+            }
+            return ctr;
+        }
+
+        // Lanes blocks at once, lane l on counter {lo(first + l), hi(first + l), c2, c3}.
+        // Results land word-major in out[word][lane]. Compilers do not vectorize the 32x32->64 bit
+        // multiplies, so on x86-64 four lanes go through each SSE2 pmuludq pair by hand.
+        template <size_t Lanes>
+        static void generateLanes(uint64_t first, uint32_t c2, uint32_t c3, Key key, uint32_t (&out)[4][Lanes])
+        {
+#ifdef CORE_PHILOX_SSE2
+            if constexpr (Lanes % 4 == 0)
+            {
+                constexpr size_t Groups = Lanes / 4;
+                __m128i x0[Groups], x1[Groups], x2[Groups], x3[Groups];
+                for (size_t g = 0; g < Groups; ++g)
+                {
+                    const uint64_t i0 = first + 4 * g;
+                    const uint64_t i1 = i0 + 1, i2 = i0 + 2, i3 = i0 + 3;
+                    x0[g] = _mm_setr_epi32(int(uint32_t(i0)), int(uint32_t(i1)), int(uint32_t(i2)), int(uint32_t(i3)));
+                    x1[g] = _mm_setr_epi32(int(uint32_t(i0 >> 32)), int(uint32_t(i1 >> 32)), int(uint32_t(i2 >> 32)), int(uint32_t(i3 >> 32)));
+                    x2[g] = _mm_set1_epi32(int(c2));
+                    x3[g] = _mm_set1_epi32(int(c3));
+                }
+
+                const __m128i m0 = _mm_set1_epi32(int(M0));
+                const __m128i m1 = _mm_set1_epi32(int(M1));
+                for (uint32_t r = 0; r < Rounds; ++r)
+                {
+                    if (r > 0)
+                        bumpKey(key);
+                    const __m128i k0 = _mm_set1_epi32(int(key[0]));
+                    const __m128i k1 = _mm_set1_epi32(int(key[1]));
+                    for (size_t g = 0; g < Groups; ++g)
+                    {
+                        __m128i hi0, lo0, hi1, lo1;
+                        mulHiLo(x0[g], m0, hi0, lo0);
+                        mulHiLo(x2[g], m1, hi1, lo1);
+                        x0[g] = _mm_xor_si128(_mm_xor_si128(hi1, x1[g]), k0);
+                        x2[g] = _mm_xor_si128(_mm_xor_si128(hi0, x3[g]), k1);
+                        x1[g] = lo1;
+                        x3[g] = lo0;
+                    }
+                }
+
+                for (size_t g = 0; g < Groups; ++g)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[0][4 * g]), x0[g]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[1][4 * g]), x1[g]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[2][4 * g]), x2[g]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[3][4 * g]), x3[g]);
+                }
+                return;
+            }
+#endif
+            for (size_t l = 0; l < Lanes; ++l)
+            {
+                const uint64_t index = first + l;
+                const Counter block = generate({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), c2, c3}, key);
+                for (size_t w = 0; w < 4; ++w)
+                    out[w][l] = block[w];
+            }
+        }
+
+    private:
+        static constexpr uint32_t M0 = 0xD2511F53u;
+        static constexpr uint32_t M1 = 0xCD9E8D57u;
+        static constexpr uint32_t W0 = 0x9E3779B9u;
+        static constexpr uint32_t W1 = 0xBB67AE85u;
+
+        static void bumpKey(Key &key)
+        {
+            key[0] += W0;
+            key[1] += W1;
+        }
+
+#ifdef CORE_PHILOX_SSE2
+        // full 64 bit products of four lanes, split into high and low words
+        static void mulHiLo(__m128i x, __m128i m, __m128i &hi, __m128i &lo)
+        {
+            const __m128i even = _mm_shuffle_epi32(_mm_mul_epu32(x, m), _MM_SHUFFLE(3, 1, 2, 0));
+            const __m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(x, 32), m), _MM_SHUFFLE(3, 1, 2, 0));
+            lo = _mm_unpacklo_epi32(even, odd);
+            hi = _mm_unpackhi_epi32(even, odd);
+        }
+#endif
+
+        static void round(uint32_t &c0, uint32_t &c1, uint32_t &c2, uint32_t &c3, uint32_t k0, uint32_t k1)
+        {
+            const uint64_t p0 = uint64_t{M0} * c0;
+            const uint64_t p1 = uint64_t{M1} * c2;
+            const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+        }
+    };
+
+    // top 24 bits as a float in [0, 1)
+    inline float uniformFloat(uint32_t bits) { return static_cast<float>(bits >> 8) * 0x1.0p-24f; }
+}
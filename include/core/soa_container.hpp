@@ -24,12 +24,32 @@ namespace core
                   { (f.reserve(n), ...); }, fields);
         }
 
+        void resize(size_t n)
+        {
+            apply([&](auto &...f)
+                  { (f.resize(n), ...); }, fields);
+        }
+
         void push_back()
         {
             apply([&](auto &...f)
                   { (f.push_default(), ...); }, fields);
         }
 
+        void setPageBacking(PageBacking backing)
+        {
+            apply([&](auto &...f)
+                  { (f.setPageBacking(backing), ...); }, fields);
+        }
+
+        // fn(T *data, size_t capacity) for every column of every field
+        template <typename F>
+        void forEachColumn(F &&fn)
+        {
+            apply([&](auto &...f)
+                  { (f.forEachColumn(fn), ...); }, fields);
+        }
+
         size_t size() const
         {
             return get<0>(fields).size();
@@ -3,6 +3,7 @@
 #include <vector>
 #include <array>
 #include <cstddef>
+#include "page_allocator.hpp"
 
 namespace core
 {
@@ -52,7 +53,11 @@ namespace core
     {
         static_assert(Components > 0);
 
-        array<vector<T>, Components> storage; // a try to convert AoS with nested data to SoA
+        using Column = vector<T, PageAllocator<T>>;
+
+        static constexpr size_t RowBytes = sizeof(T) * Components; // one element across all components
+
+        array<Column, Components> storage; // a try to convert AoS with nested data to SoA
 
         void reserve(size_t n)
         {
@@ -68,6 +73,26 @@ namespace core
 
         size_t size() const { return storage[0].size(); }
 
+        // moves the columns, reserved capacity included, onto memory with the given backing
+        void setPageBacking(PageBacking backing)
+        {
+            for (auto &v : storage)
+            {
+                Column moved{PageAllocator<T>(backing)};
+                moved.reserve(v.capacity());
+                moved.assign(v.begin(), v.end());
+                v = std::move(moved);
+            }
+        }
+
+        // fn(T *data, size_t capacity) for every component column
+        template <typename F>
+        void forEachColumn(F &&fn)
+        {
+            for (auto &v : storage)
+                fn(v.data(), v.capacity());
+        }
+
         template <size_t K>
             requires ComponentIndex<K, Components>
         T *data() noexcept { return storage[K].data();}
@@ -92,12 +117,12 @@ namespace core
         const T *data() const noexcept { return Base::storage[0].data(); }
     };
 
-    template <typename Tag>
-    struct SoAFieldVector2D : public SoAFieldBase<float, 2>, FieldTag<Tag>
+    template <typename Tag, typename T = float>
+    struct SoAFieldVector2D : public SoAFieldBase<T, 2>, FieldTag<Tag>
     {
-        using Base = SoAFieldBase<float, 2>;
+        using Base = SoAFieldBase<T, 2>;
 
-        void push_back(float x, float y)
+        void push_back(T x, T y)
         {
             Base::storage[0].push_back(x);
             Base::storage[1].push_back(y);
@@ -105,11 +130,11 @@ namespace core
 
         void push_default()
         {
-            Base::storage[0].push_back(0.f);
-            Base::storage[1].push_back(0.f);
+            Base::storage[0].push_back(T{});
+            Base::storage[1].push_back(T{});
         }
 
-        float *x() { return Base::data<0>(); }
-        float *y() { return Base::data<1>(); }
+        T *x() { return Base::template data<0>(); }
+        T *y() { return Base::template data<1>(); }
     };
 }
\ No newline at end of file
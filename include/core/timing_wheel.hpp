@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace core
+{
+    // Hierarchical timing wheel keyed by integer ticks.
+    // Level L has 64 slots of 64^L ticks each; entries trickle down a level whenever time
+    // crosses the start of their slot, so advancing one tick costs O(expired) plus an
+    // occasional cascade instead of a scan over everything scheduled.
+    template <typename T>
+    class TimingWheel
+    {
+    public:
+        static constexpr uint32_t SlotBits = 6;
+        static constexpr uint32_t Slots = 1u << SlotBits;
+        static constexpr uint32_t Levels = 4;
+
+        explicit TimingWheel(uint64_t startTick = 0) : now_(startTick) {}
+
+        uint64_t now() const { return now_; }
+        size_t size() const { return count_; }
+
+        // entries at or before now() expire on the next advance()
+        void schedule(uint64_t tick, const T &value)
+        {
+            ++count_;
+            if (tick <= now_)
+            {
+                overdue_.push_back({tick, value});
+                return;
+            }
+            place({tick, value});
+        }
+
+        // moves time forward to tick, calling onExpire(value, dueTick) for everything due up to it
+        template <typename F>
+        void advance(uint64_t tick, F &&onExpire)
+        {
+            for (const auto &e : overdue_)
+                onExpire(e.value, e.tick);
+            count_ -= overdue_.size();
+            overdue_.clear();
+
+            while (now_ < tick)
+            {
+                if (count_ == 0)
+                {
+                    now_ = tick;
+                    break;
+                }
+
+                ++now_;
+                for (uint32_t level = Levels - 1; level > 0; --level)
+                {
+                    if ((now_ & levelMask(level)) == 0)
+                        cascade(level);
+                }
+
+                auto &slot = wheels_[0][now_ & (Slots - 1)];
+                for (const auto &e : slot)
+                {
+                    assert(e.tick == now_);
+                    onExpire(e.value, e.tick);
+                }
+                count_ -= slot.size();
+                slot.clear();
+            }
+        }
+
+        void clear()
+        {
+            for (auto &level : wheels_)
+                for (auto &slot : level)
+                    slot.clear();
+            overdue_.clear();
+            overflow_.clear();
+            count_ = 0;
+        }
+
+    private:
+        struct Entry
+        {
+            uint64_t tick;
+            T value;
+        };
+
+        std::array<std::array<std::vector<Entry>, Slots>, Levels> wheels_;
+        std::vector<Entry> overdue_;  // scheduled at or before now
+        std::vector<Entry> overflow_; // past the horizon of the top level
+        uint64_t now_;
+        size_t count_ = 0;
+
+        // ticks covered by one slot of `level` minus one
+        static constexpr uint64_t levelMask(uint32_t level) { return (uint64_t{1} << (SlotBits * level)) - 1; }
+
+        void place(const Entry &e)
+        {
+            const uint64_t delta = e.tick - now_;
+            for (uint32_t level = 0; level < Levels; ++level)
+            {
+                if (delta < (uint64_t{1} << (SlotBits * (level + 1))))
+                {
+                    wheels_[level][(e.tick >> (SlotBits * level)) & (Slots - 1)].push_back(e);
+                    return;
+                }
+            }
+            overflow_.push_back(e);
+        }
+
+        void cascade(uint32_t level)
+        {
+            auto &slot = wheels_[level][(now_ >> (SlotBits * level)) & (Slots - 1)];
+            std::vector<Entry> moving;
+            moving.swap(slot);
+            for (const auto &e : moving)
+                place(e);
+
+            if (level == Levels - 1 && !overflow_.empty())
+            {
+                moving.clear();
+                moving.swap(overflow_);
+                for (const auto &e : moving)
+                    place(e);
+            }
+        }
+    };
+}
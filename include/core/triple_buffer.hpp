@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace core
+{
+    // Wait-free hand-over of whole values from one writer thread to one reader thread.
+    // The writer fills its back buffer and publish() swaps it with the middle one; the reader's
+    // acquire() swaps the middle buffer for its front one when something new was published.
+    // Neither side ever waits for the other, the reader just sees the latest complete value and
+    // values published in between are skipped.
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+        TripleBuffer(const TripleBuffer &) = delete;
+        TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+        // writer side
+        T &back() { return slots_[back_].value; }
+        void publish() { back_ = middle_.exchange(back_ | Fresh, std::memory_order_acq_rel) & IndexMask; }
+
+        // reader side: true when front() changed to a newer value
+        bool acquire()
+        {
+            if (!(middle_.load(std::memory_order_relaxed) & Fresh))
+                return false;
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+        const T &front() const { return slots_[front_].value; }
+        T &front() { return slots_[front_].value; }
+
+        // no thread may be using the buffers, e.g. to preallocate all three
+        template <typename Fn>
+        void forEach(Fn &&fn)
+        {
+            for (Slot &s : slots_)
+                fn(s.value);
+        }
+
+    private:
+        static constexpr uint8_t IndexMask = 3;
+        static constexpr uint8_t Fresh = 4; // the middle buffer was published after the reader last swapped
+
+        // own cache lines, so the writer filling one does not false share with the reader
+        struct alignas(64) Slot
+        {
+            T value{};
+        };
+
+        Slot slots_[3];
+        alignas(64) std::atomic<uint8_t> middle_{1};
+        alignas(64) uint8_t back_ = 0;  // writer only
+        alignas(64) uint8_t front_ = 2; // reader only
+    };
+}
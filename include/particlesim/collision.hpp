@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "particle.hpp"
+#include "spatial_partitioning.hpp"
+#include "parallel_scheduler.hpp"
+
+namespace particlesim
+{
+    using namespace std;
+
+    struct CollisionConfig
+    {
+        float radius = 0.5f;          // particle radius, contacts form below 2 * radius
+        float contactMargin = 0.f;    // extra distance for candidate contacts that may close during the sweeps
+        uint32_t iterations = 4;      // projection sweeps per solve
+        float relaxation = 1.f;       // fraction of the overlap removed per projection
+        bool updateVelocities = true; // fold position corrections back into velocity
+    };
+
+    // Position-based overlap resolution on the SoA Position columns.
+    // Contacts are generated once per solve from the grid and stored per grid row; projection
+    // sweeps then run rows in two parity passes (see UniformGrid::forEachRowColored), so parallel
+    // workers never move the same particle and no atomics are needed.
+    class CollisionSolver
+    {
+    public:
+        explicit CollisionSolver(const CollisionConfig &cfg) : config(cfg) {}
+
+        // grid must be built from the current positions with a cell size of at least 2 * radius
+        void solve(const UniformGrid &grid, ParticleSoAView particles, float dt, ParallelScheduler *scheduler = nullptr);
+
+        // contacts generated by the last solve
+        size_t contactCount() const { return contacts; }
+        // projections that moved particles during the last solve, summed over iterations
+        uint64_t resolvedCount() const { return resolved; }
+        // particles moved by the last solve
+        span<const uint32_t> displaced() const { return displacedIds; }
+
+        CollisionConfig config;
+
+    private:
+        struct Contact
+        {
+            uint32_t a;
+            uint32_t b;
+        };
+
+        struct alignas(64) WorkerCounter
+        {
+            uint64_t resolved = 0;
+        };
+
+        vector<vector<Contact>> rowContacts;
+        vector<float> startX;
+        vector<float> startY;
+        vector<WorkerCounter> counters;
+        vector<uint8_t> moved;
+        vector<uint32_t> displacedIds;
+        size_t contacts = 0;
+        uint64_t resolved = 0;
+
+        void generateContacts(const UniformGrid &grid, const ParticleSoAView &particles, ParallelScheduler *scheduler);
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "core/vector.hpp"
+#include "core/random.hpp"
+#include "particle.hpp"
+#include "parallel_scheduler.hpp"
+
+namespace particlesim
+{
+    using namespace core;
+
+    enum class EmitterShape
+    {
+        Point, // at origin
+        Box,   // uniform over origin +- halfExtents
+        Disc,  // uniform over the disc of radius around origin
+        Cone   // uniform over the sector of radius around origin, moving away from it
+    };
+
+    struct EmitterConfig
+    {
+        EmitterShape shape = EmitterShape::Point;
+        Vector2D origin{0.0f, 0.0f};
+        Vector2D halfExtents{1.0f, 1.0f}; // Box
+        float radius = 1.0f;              // Disc, Cone
+
+        // velocity heading, in radians, spread uniformly over direction +- spread.
+        // Cone uses them for the sector too; every other shape aims each particle on its own.
+        float direction = 0.0f;
+        float spread = 3.14159265f;
+        float minSpeed = 0.0f;
+        float maxSpeed = 1.0f;
+
+        Vector2D acceleration{0.0f, 0.0f};
+        float accelerationJitter = 0.0f; // per component, uniform in +- jitter
+
+        float minLifetime = 1.0f;
+        float maxLifetime = 1.0f;
+
+        uint64_t seed = 0;
+    };
+
+    // Spawns particles from a Philox stream keyed by the seed: particle i of the sequence is a pure
+    // function of (seed, i), so sampling a range in one call, in pieces, or over any number of
+    // threads writes the same values. Lanes of 16 particles are generated at once.
+    class ParticleEmitter
+    {
+    public:
+        static constexpr size_t Lanes = 16;
+
+        explicit ParticleEmitter(const EmitterConfig &cfg = {}) : config(cfg) {}
+
+        // writes particles [first, first + out.count) of the sequence into the columns of out
+        void sample(uint64_t first, const ParticleSoAView &out) const;
+        Particle sample(uint64_t index) const;
+
+        // appends the next count particles of the sequence, split over the scheduler's workers
+        // when given, and returns the layout index of the first one
+        template <typename Layout>
+        size_t emit(Layout &layout, size_t count, ParallelScheduler *scheduler = nullptr)
+        {
+            const size_t begin = layout.size();
+            const ParticleSoAView out = layout.append(count);
+            const uint64_t first = next_;
+            next_ += count;
+
+            if (!scheduler)
+            {
+                sample(first, out);
+                return begin;
+            }
+
+            scheduler->parallelFor(count, [&](size_t b, size_t e, size_t)
+                                   { sample(first + b, subview(out, b, e)); });
+            return begin;
+        }
+
+        // index of the next particle emit() spawns
+        uint64_t emitted() const { return next_; }
+        void restart(uint64_t index = 0) { next_ = index; }
+
+        EmitterConfig config;
+
+    private:
+        uint64_t next_ = 0;
+
+        static ParticleSoAView subview(const ParticleSoAView &v, size_t begin, size_t end)
+        {
+            return {v.posX + begin, v.posY + begin, v.velX + begin, v.velY + begin,
+                    v.accX + begin, v.accY + begin, v.lifetime + begin, v.alive + begin, end - begin};
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "spatial_partitioning.hpp"
+
+namespace particlesim
+{
+    struct GridTunerConfig
+    {
+        float minCellSize = 0.25f;
+        float maxCellSize = 64.f;
+        float targetOccupancy = 4.f; // other particles per cell around the average particle
+        float hysteresis = 1.5f;     // occupancy within [target / h, target * h] leaves the grid alone
+        uint32_t window = 30;        // frames averaged per decision
+        uint32_t cooldown = 30;      // frames ignored after a resize while the scene settles in the new grid
+        uint32_t maxOccupancy = 512; // cells are not grown while the fullest would end up above this
+        size_t maxCells = size_t{1} << 22;
+    };
+
+    // Picks UniformGrid::cellSize from the PartitionStats of the frames it observes. Each window
+    // averages the occupancy queries saw (neighbor count / 9 cells) or, in frames without queries,
+    // the occupancy of the cell the average particle sits in, less itself. A window outside the
+    // hysteresis band rescales the cell by sqrt(target / occupancy), which for locally uniform
+    // density lands on the target, then the cooldown passes before the next window starts.
+    class GridAutoTuner
+    {
+    public:
+        explicit GridAutoTuner(const GridTunerConfig &cfg = {}) : config(cfg) {}
+
+        // call after a frame's build and queries, before the next clear(). minCellSize raises the
+        // configured floor, e.g. to the interaction radius. Returns true when it resized the grid,
+        // which empties it until the next build.
+        bool observe(UniformGrid &grid, float minCellSize = 0.f);
+
+        // occupancy averaged over the last complete window
+        float lastOccupancy() const { return lastOccupancy_; }
+        uint32_t resizeCount() const { return resizes_; }
+
+        GridTunerConfig config;
+
+    private:
+        double occupancySum_ = 0.0;
+        uint32_t windowMax_ = 0;
+        uint32_t frames_ = 0;
+        uint32_t cooldown_ = 0;
+        uint32_t resizes_ = 0;
+        float lastOccupancy_ = 0.f;
+
+        float chooseCellSize(const UniformGrid &grid, float occupancy, float minCellSize) const;
+    };
+}
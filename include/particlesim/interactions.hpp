@@ -0,0 +1,66 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <cstdint>
+#include "core/vector.hpp"
+#include "spatial_partitioning.hpp"
+#include "parallel_scheduler.hpp"
+
+namespace particlesim
+{
+    using namespace core;
+    using namespace std;
+
+    enum class InteractionModel
+    {
+        SoftRepulsion, // linear spring pushing overlapping particles apart
+        SPH            // density summation followed by a pressure force
+    };
+
+    struct InteractionConfig
+    {
+        InteractionModel model = InteractionModel::SoftRepulsion;
+        float radius = 1.f;    // support radius - must not exceed the grid cell size
+        float stiffness = 10.f; // soft repulsion acceleration at zero distance
+
+        // SPH
+        float particleMass = 1.f;
+        float restDensity = 1.f;
+        float pressureStiffness = 1.f;
+    };
+
+    // Short-range pairwise accelerations evaluated over the UniformGrid cell pairs.
+    // Every pair is visited once and applied to both particles; rows of the grid are
+    // processed in two colored passes so parallel workers never write the same particle.
+    class ParticleInteractions
+    {
+    public:
+        explicit ParticleInteractions(const InteractionConfig &cfg) : config(cfg) {}
+
+        // positions must be the span the grid was built from
+        void compute(const UniformGrid &grid, span<const Vector2D> positions, ParallelScheduler *scheduler = nullptr);
+
+        span<const Vector2D> accelerations() const { return accel; }
+        // SPH only, empty for soft repulsion
+        span<const float> densities() const { return density; }
+        // pairs closer than the radius during the last compute()
+        uint64_t pairsEvaluated() const { return pairs; }
+
+        InteractionConfig config;
+
+    private:
+        struct alignas(64) WorkerCounter
+        {
+            uint64_t pairs = 0;
+        };
+
+        vector<Vector2D> accel;
+        vector<float> density;
+        vector<float> pressureTerm; // P / rho^2
+        vector<WorkerCounter> counters;
+        uint64_t pairs = 0;
+
+        template <typename PairFn>
+        void forEachPair(const UniformGrid &grid, span<const Vector2D> positions, ParallelScheduler *scheduler, PairFn &&fn);
+    };
+}
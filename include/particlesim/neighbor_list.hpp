@@ -0,0 +1,64 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "core/vector.hpp"
+#include "spatial_partitioning.hpp"
+
+namespace particlesim
+{
+    using namespace core;
+    using namespace std;
+
+    struct NeighborListConfig
+    {
+        float radius = 1.f; // interaction radius the lists must cover
+        float skin = 0.3f;  // extra margin - lists stay valid until a particle moves more than skin / 2
+    };
+
+    // Verlet neighbor lists in CSR form, built from a UniformGrid with radius + skin and reused
+    // across frames while particles stay within half the skin of where they were at the last rebuild.
+    // Indices must stay stable between updates - call invalidate() after reordering particles.
+    class NeighborListCache
+    {
+    public:
+        NeighborListCache(const PartitioningConfig &gridConfig, const NeighborListConfig &cfg);
+
+        // rebuilds the lists if they are stale, returns true when a rebuild happened
+        bool update(span<const Vector2D> positions);
+        void invalidate() { valid = false; }
+
+        // particles that were within radius + skin of particleID at the last rebuild
+        span<const uint32_t> neighbors(uint32_t particleID) const
+        {
+            assert(particleID + 1 < offsets_.size());
+            return {indices_.data() + offsets_[particleID], indices_.data() + offsets_[particleID + 1]};
+        }
+
+        // raw CSR arrays - neighbors of i are indices()[offsets()[i] .. offsets()[i + 1])
+        span<const uint32_t> offsets() const { return offsets_; }
+        span<const uint32_t> indices() const { return indices_; }
+
+        size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+        size_t rebuildCount() const { return rebuilds; }
+        // list lengths at the last rebuild
+        const Log2Histogram &listLengths() const { return lengths_; }
+
+        // largest squared distance any particle travelled since the last rebuild
+        float maxDisplacementSq(span<const Vector2D> positions) const;
+
+        NeighborListConfig config;
+
+    private:
+        UniformGrid grid;
+        vector<Vector2D> reference; // positions at the last rebuild
+        vector<uint32_t> offsets_;
+        vector<uint32_t> indices_;
+        Log2Histogram lengths_;
+        bool valid = false;
+        size_t rebuilds = 0;
+
+        void rebuild(span<const Vector2D> positions);
+    };
+}
@@ -1,4 +1,87 @@
 #pragma once
-namespace particlesim {
-class ParallelScheduler {};
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <cstring>
+#include <type_traits>
+#include "core/memory_arena.hpp"
+
+namespace particlesim
+{
+    // Fixed pool of workers running fork-join range loops.
+    // [0, count) is always split into workerCount() contiguous chunks and chunk w always
+    // runs on worker w, so data touched by a worker stays with that worker between frames.
+    // The calling thread acts as worker 0.
+    // Every worker also owns a FrameArena for allocation-free scratch space inside tasks; with a
+    // mapped page backing its chunks are first written, and so placed, by the worker itself.
+    class ParallelScheduler
+    {
+    public:
+        using RangeTask = std::function<void(size_t begin, size_t end, size_t worker)>;
+
+        // 0 - use std::thread::hardware_concurrency()
+        // arenaSize - initial size of each worker arena, they chain more chunks when needed
+        explicit ParallelScheduler(size_t workerCount = 0, size_t arenaSize = 256 * 1024);
+        ~ParallelScheduler();
+
+        ParallelScheduler(const ParallelScheduler &) = delete;
+        ParallelScheduler &operator=(const ParallelScheduler &) = delete;
+
+        size_t workerCount() const { return workerCount_; }
+
+        // blocks until every chunk has been processed
+        void parallelFor(size_t count, const RangeTask &task);
+
+        // writes zeros over data[0, count) split the way parallelFor(count) splits it. Pages nobody
+        // touched yet, e.g. fresh allocatePages() mappings, land on the NUMA node of the worker
+        // that writes them first, so later parallelFor(count) loops find them local.
+        template <typename T>
+        void firstTouch(T *data, size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            parallelFor(count, [&](size_t begin, size_t end, size_t)
+                        { std::memset(data + begin, 0, (end - begin) * sizeof(T)); });
+        }
+
+        // arena of one worker - only tasks running as that worker may allocate from it
+        core::FrameArena &workerArena(size_t worker) { return arenas_[worker].arena; }
+
+        // frame boundary for all worker arenas, must not be called during parallelFor
+        void resetArenas();
+
+        static std::pair<size_t, size_t> chunkRange(size_t count, size_t chunks, size_t chunk)
+        {
+            const size_t base = count / chunks;
+            const size_t extra = count % chunks;
+            const size_t begin = chunk * base + (chunk < extra ? chunk : extra);
+            return {begin, begin + base + (chunk < extra ? 1 : 0)};
+        }
+
+    private:
+        // own cache line each, so bump pointers of neighbouring workers do not false share
+        struct alignas(64) WorkerArena
+        {
+            core::FrameArena arena;
+        };
+
+        size_t workerCount_ = 1;
+        std::vector<WorkerArena> arenas_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeWorkers_;
+        std::condition_variable workDone_;
+        const RangeTask *task_ = nullptr;
+        size_t count_ = 0;
+        uint64_t generation_ = 0;
+        size_t pending_ = 0;
+        bool stopping_ = false;
+
+        void workerLoop(size_t worker);
+    };
 }
@@ -14,6 +14,9 @@ namespace particlesim
     struct Acceleration {};
     struct Lifetime {};
     struct Alive {};
+    struct SpawnTime {};
+    struct DeathTime {};
+    struct Tier {};
     struct Particle
     {
         Vector2D position{0.0f, 0.0f};
@@ -21,6 +24,7 @@ namespace particlesim
         Vector2D acceleration{0.0f, 0.0f};
         float lifetime = 0.0f;
         bool alive = true;
+        uint8_t updateTier = 1; // integrated every updateTier frames, honoured by ParticleSystemDataSoA
 
         void reset();
         void kill();
@@ -28,12 +32,54 @@ namespace particlesim
     };
 
     static_assert(std::is_trivially_copyable_v<Particle>);
+
+    // raw columns of a SoA layout, valid until the layout grows or compacts
+    struct ParticleSoAView
+    {
+        float *posX = nullptr;
+        float *posY = nullptr;
+        float *velX = nullptr;
+        float *velY = nullptr;
+        float *accX = nullptr;
+        float *accY = nullptr;
+        float *lifetime = nullptr;
+        uint8_t *alive = nullptr;
+        size_t count = 0;
+    };
+
     using ParticleSoA = SoAContainer<
         SoAFieldVector2D<Position>,
         SoAFieldVector2D<Velocity>,
         SoAFieldVector2D<Acceleration>, 
         SoAFieldScalar<float, Lifetime>,     
-        SoAFieldScalar<uint8_t, Alive>   
+        SoAFieldScalar<uint8_t, Alive>,
+        SoAFieldScalar<uint8_t, Tier>
+        >;
+
+    // launch state of particles that follow p0 + v0 t + a t^2 / 2 until they die
+    using BallisticSoA = SoAContainer<
+        SoAFieldVector2D<Position>,
+        SoAFieldVector2D<Velocity>,
+        SoAFieldVector2D<Acceleration>,
+        SoAFieldScalar<float, SpawnTime>,
+        SoAFieldScalar<float, DeathTime>
+        >;
+
+    // columns of the spawn-cohort ring layout
+    using CohortSoA = SoAContainer<
+        SoAFieldVector2D<Position>,
+        SoAFieldVector2D<Velocity>,
+        SoAFieldVector2D<Acceleration>,
+        SoAFieldScalar<float, DeathTime>
+        >;
+
+    // compressed columns, 14 bytes per particle: fixed-point positions, fp16 velocity and
+    // acceleration bits, lifetime in ticks with zero meaning dead
+    using QuantizedSoA = SoAContainer<
+        SoAFieldVector2D<Position, uint16_t>,
+        SoAFieldVector2D<Velocity, uint16_t>,
+        SoAFieldVector2D<Acceleration, uint16_t>,
+        SoAFieldScalar<uint16_t, Lifetime>
         >;
 
 }
\ No newline at end of file
@@ -3,13 +3,28 @@
 #include <string>
 #include <span>
 #include <memory>
+#include <deque>
+#include <chrono>
+#include <bit>
+#include <stdexcept>
 
 #include "core/soa_container.hpp"
 #include "core/vector.hpp"
 #include "core/free_list.hpp"
 #include "core/memory_arena.hpp"
+#include "core/timing_wheel.hpp"
+#include "core/half.hpp"
 #include "particle.hpp"
 #include "spatial_partitioning.hpp"
+#include "interactions.hpp"
+#include "collision.hpp"
+#include "parallel_scheduler.hpp"
+#include "recorder.hpp"
+#include "publisher.hpp"
+#include "shm_export.hpp"
+#include "profiling.hpp"
+#include "simulation_stats.hpp"
+#include "grid_tuner.hpp"
 
 namespace particlesim
 {
@@ -24,38 +39,293 @@ namespace particlesim
         { layout.get() } -> std::same_as<std::vector<Particle>>;
     };
 
+    // layouts that can take a per-particle acceleration on top of their own for one step
+    template <typename T>
+    concept AcceleratedLayout = requires(T layout, span<const core::Vector2D> acc, float dt) {
+        { layout.applyAcceleration(acc, dt) } -> same_as<void>;
+    };
+
+    // layouts that let particles sleep and must hear about moves made outside their update
+    template <typename T>
+    concept RestingLayout = requires(T layout, span<const uint32_t> ids) {
+        { layout.wake(ids) } -> same_as<void>;
+    };
+
+    // layouts that can integrate low-importance particles at a reduced rate
+    template <typename T>
+    concept TieredLayout = requires(T layout, uint8_t level) {
+        { layout.setLodLevel(level) } -> same_as<void>;
+    };
+
+    // layouts that count deaths and compaction moves while they integrate and compact
+    template <typename T>
+    concept CountingLayout = requires(const T layout) {
+        { layout.counters() } -> same_as<const LayoutCounters &>;
+    };
+
+    // layouts exposing their columns for in-place stages
+    template <typename T>
+    concept SoAViewLayout = requires(T layout) {
+        { layout.view() } -> same_as<ParticleSoAView>;
+    };
+
     template <ParticleDataContainer Layout>
     class ParticleSystem
     {
     public:
         ParticleSystem(size_t capacity = 100000, std::unique_ptr<ISpatialPartition> p = nullptr)
-            : data(capacity), partition(std::move(p)), arena_(estimateArenaSize(capacity)) {}
+            : data(capacity), arena_(estimateArenaSize(capacity)) { setPartition(std::move(p)); }
+
+        // throws std::invalid_argument when interactions are set and p is not a UniformGrid
+        void setPartition(std::unique_ptr<ISpatialPartition> p)
+        {
+            UniformGrid *grid = dynamic_cast<UniformGrid *>(p.get());
+            if (interactions_ && !grid)
+                throw std::invalid_argument("interactions need a UniformGrid partition");
+            partition = std::move(p);
+            grid_ = grid;
+            partitionCurrent_ = false;
+        }
+
+        // pairwise forces need a UniformGrid partition whose cell size covers the interaction radius,
+        // throws std::invalid_argument without one
+        void setInteractions(std::unique_ptr<ParticleInteractions> i)
+            requires AcceleratedLayout<Layout>
+        {
+            if (i && !grid_)
+                throw std::invalid_argument("interactions need a UniformGrid partition");
+            interactions_ = std::move(i);
+        }
+
+        // overlap resolution after integration, needs a UniformGrid partition with cells of at least 2 * radius
+        void setCollisionSolver(std::unique_ptr<CollisionSolver> solver)
+            requires SoAViewLayout<Layout>
+        {
+            collisions_ = std::move(solver);
+        }
+
+        // re-picks the grid's cell size from the occupancy of past frames, never below what the
+        // interactions and the collision solver need; does nothing without a UniformGrid partition
+        void setGridTuner(std::unique_ptr<GridAutoTuner> tuner) { tuner_ = std::move(tuner); }
 
-        void setPartition(std::unique_ptr<ISpatialPartition> p) { partition = std::move(p); }
+        // not owned, nullptr runs the stages on the calling thread.
+        // The scheduler's worker arenas are reset together with the system's own arena.
+        void setScheduler(ParallelScheduler *scheduler) { scheduler_ = scheduler; }
+
+        // not owned, every update() ends by handing the frame to it; nullptr stops recording
+        void setRecorder(FrameRecorder *recorder)
+            requires SoAViewLayout<Layout>
+        {
+            recorder_ = recorder;
+        }
 
-        size_t addParticle(const Particle &p) { return data.add(p); }
+        // not owned, every update() ends by publishing the frame to its consumer; nullptr stops it
+        void setPublisher(FramePublisher *publisher) { publisher_ = publisher; }
+
+        // not owned, every update() ends by exporting the frame to other processes; nullptr stops it
+        void setExport(SharedFrameExport *shared) { export_ = shared; }
+
+        size_t addParticle(const Particle &p)
+        {
+            partitionCurrent_ = false;
+            return data.add(p);
+        }
 
         void update(float dt, bool compact = false)
         {
+            PARTICLESIM_FRAME();
+            const FrameBaseline baseline = frameBaseline();
+            if (tuner_ && grid_ && tuner_->observe(*grid_, minCellSize()))
+                partitionCurrent_ = false; // resized and emptied
+            if constexpr (AcceleratedLayout<Layout>)
+            {
+                if (interactions_ && grid_)
+                {
+                    PARTICLESIM_ZONE(Interactions);
+                    // forces are evaluated on the positions at the start of the frame, which the last
+                    // frame's closing build still holds unless particles were added or changed since
+                    auto positions = partitionCurrent_ ? partitionPositions_ : buildPartition();
+                    interactions_->compute(*grid_, positions, scheduler_);
+                    data.applyAcceleration(interactions_->accelerations(), dt);
+                }
+            }
+
             data.update(dt, compact);
+            partitionCurrent_ = false;
             if (partition)
+                buildPartition();
+
+            if constexpr (SoAViewLayout<Layout>)
+            {
+                if (collisions_ && grid_)
+                {
+                    PARTICLESIM_ZONE(Collisions);
+                    collisions_->solve(*grid_, data.view(), dt, scheduler_);
+                    if constexpr (RestingLayout<Layout>)
+                        data.wake(collisions_->displaced());
+                    // queries after update() see the resolved positions
+                    if (!collisions_->displaced().empty())
+                        buildPartition();
+                }
+                if (recorder_)
+                {
+                    PARTICLESIM_ZONE(Export);
+                    recorder_->record(data.view());
+                }
+            }
+
+            if (publisher_ || export_)
+            {
+                PARTICLESIM_ZONE(Export);
+                if (publisher_)
+                    publishTo(*publisher_);
+                if (export_)
+                    publishTo(*export_);
+            }
+            finishStats(baseline);
+        }
+
+        // update() against a frame budget: a frame over budget raises the layout's LOD level by one,
+        // RecoverFrames frames in a row under half the budget lower it again
+        void update(float dt, std::chrono::microseconds budget, bool compact = false)
+            requires TieredLayout<Layout>
+        {
+            const auto start = std::chrono::steady_clock::now();
+            update(dt, compact);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            if (elapsed > budget)
+            {
+                underBudgetFrames_ = 0;
+                if (lod_ < Layout::MaxLodLevel)
+                    data.setLodLevel(++lod_);
+            }
+            else if (elapsed * 2 < budget && lod_ > 0)
             {
-                partition->clear();
-                partition->setData({data.positions(), std::move(arena_)});
-                partition->build();
+                if (++underBudgetFrames_ >= RecoverFrames)
+                {
+                    underBudgetFrames_ = 0;
+                    data.setLodLevel(--lod_);
+                }
+            }
+            else
+            {
+                underBudgetFrames_ = 0;
             }
         }
 
+        static constexpr uint32_t RecoverFrames = 30;
+        uint8_t lodLevel() const { return lod_; }
+
         size_t size() const { return data.size(); }
 
+        // the last update plus the partition's view of its last build and the queries since
+        SimulationStats stats() const
+        {
+            SimulationStats s = stats_;
+            if (partition)
+                s.partition = partition->stats();
+            return s;
+        }
+
+        // sizing data for the frame arena behind partition queries
+        core::ArenaStats arenaStats() const { return arena_.stats(); }
+
+        // may move or add particles, so the next update rebuilds the partition before using it
+        Layout &layout()
+        {
+            partitionCurrent_ = false;
+            return data;
+        }
+        const Layout &layout() const { return data; }
+
         // for testing purposes
         std::vector<Particle> get() { return data.get(); }
 
     private:
         Layout data;
         std::unique_ptr<ISpatialPartition> partition = nullptr;
+        UniformGrid *grid_ = nullptr; // partition, when it is a grid
+        std::unique_ptr<ParticleInteractions> interactions_ = nullptr;
+        std::unique_ptr<CollisionSolver> collisions_ = nullptr;
+        std::unique_ptr<GridAutoTuner> tuner_ = nullptr;
+        ParallelScheduler *scheduler_ = nullptr;
+        FrameRecorder *recorder_ = nullptr;
+        FramePublisher *publisher_ = nullptr;
+        SharedFrameExport *export_ = nullptr;
         core::FrameArena arena_;
+        span<const core::Vector2D> partitionPositions_; // what the partition was last built from
+        bool partitionCurrent_ = false;                  // and still matches the layout
+        uint8_t lod_ = 0;
+        uint32_t underBudgetFrames_ = 0;
+        SimulationStats stats_;
+
+        struct FrameBaseline
+        {
+            size_t births = 0;
+            LayoutCounters counters;
+        };
+
+        FrameBaseline frameBaseline() const
+        {
+            FrameBaseline b;
+            const size_t size = data.size();
+            b.births = size > stats_.particles ? size - stats_.particles : 0;
+            if constexpr (CountingLayout<Layout>)
+                b.counters = data.counters();
+            return b;
+        }
+
+        void finishStats(const FrameBaseline &baseline)
+        {
+            ++stats_.frame;
+            stats_.particles = data.size();
+            stats_.births = baseline.births;
+            stats_.alive = stats_.particles;
+            if constexpr (CountingLayout<Layout>)
+            {
+                const LayoutCounters &now = data.counters();
+                stats_.alive -= now.dead;
+                stats_.deaths = static_cast<size_t>(now.deaths - baseline.counters.deaths);
+                stats_.compactionMoves = static_cast<size_t>(now.compactionMoves - baseline.counters.compactionMoves);
+            }
+        }
+
+        float minCellSize() const
+        {
+            float floor = 0.f;
+            if (interactions_)
+                floor = interactions_->config.radius;
+            if (collisions_)
+                floor = max(floor, 2.f * collisions_->config.radius + collisions_->config.contactMargin);
+            return floor;
+        }
+
+        span<const core::Vector2D> buildPartition()
+        {
+            auto positions = data.positions();
+            arena_.reset();
+            if (scheduler_)
+                scheduler_->resetArenas();
+            partition->clear();
+            partition->setData({positions, &arena_});
+            partition->build();
+            partitionPositions_ = positions;
+            partitionCurrent_ = true;
+            return positions;
+        }
+
+        // the columns when the layout has them, positions otherwise
+        template <typename Sink>
+        void publishTo(Sink &sink)
+        {
+            if constexpr (SoAViewLayout<Layout>)
+                sink.publish(data.view());
+            else
+                sink.publish(data.positions());
+        }
 
+        // initial size only, the arena chains more chunks when a frame needs them
         size_t estimateArenaSize(size_t particleCount)
         {
             return (particleCount * 16) + (particleCount * sizeof(uint32_t) * 8) + (64 * 1024);
@@ -71,6 +341,9 @@ namespace particlesim
         size_t add(const Particle &p);
         size_t size() const;
 
+        // velocity kick equal to integrating acc[i] on top of the particle's own acceleration
+        void applyAcceleration(span<const core::Vector2D> acc, float dt);
+
         span<const core::Vector2D> positions();
         // for testing purposes
         std::vector<Particle> get();
@@ -80,23 +353,113 @@ namespace particlesim
         std::vector<Vector2D> positionsCache_;
     };
 
+    struct RestConfig
+    {
+        bool enabled = false;
+        float sleepSpeed = 0.01f;        // particles slower than this count as resting...
+        float sleepAcceleration = 0.01f; // ...while their acceleration stays below this
+        uint8_t sleepFrames = 30;        // resting frames before a particle may fall asleep, 0 counts as 1
+    };
+
     class ParticleSystemDataSoA
     {
     public:
+        // particles sleep per block of BlockSize: once every live particle of a block has rested for
+        // sleepFrames frames its velocities are zeroed and update() skips the block, only counting
+        // the elapsed time until the shortest lifetime in it runs out or something wakes it
+        static constexpr size_t BlockSize = 64;
+        // deepest LOD level setLodLevel() takes
+        static constexpr uint8_t MaxLodLevel = 3;
+
         ParticleSystemDataSoA(size_t capacity = 100000);
 
         void update(float dt, bool compact = false);
         size_t add(const Particle &p);
+        // count zeroed, alive, tier 1 particles at the end - their columns for the caller to fill,
+        // valid until the next add(), append() or compacting update()
+        ParticleSoAView append(size_t count);
         size_t size() const;
 
+        // wakes sleeping particles whose acc exceeds RestConfig::sleepAcceleration, smaller kicks are dropped for them
+        void applyAcceleration(span<const core::Vector2D> acc, float dt);
+        // columns of sleeping blocks hold lifetimes as of the moment they fell asleep
+        ParticleSoAView view();
+
+        // particles with updateTier k > 1 (rounded down to a power of two) are integrated with
+        // (k << level) * dt every k << level frames, staggered per block of BlockSize so each frame
+        // takes an even share and skipped particles skip whole cache lines. Tier 1 always runs every
+        // frame. Deaths land up to one stride late, and swap-remove compaction may move a particle
+        // into a block with another phase, so it runs once a little early or late.
+        // Each block moves to a new level at its next phase that is a multiple of every tier's old
+        // and new stride, where the old strides' steps have just run out, so no particle over- or
+        // under-steps; that is within maxTier << max(old, new) frames. lodLevel() is the target.
+        void setLodLevel(uint8_t level) { lod_ = min(level, MaxLodLevel); }
+        uint8_t lodLevel() const { return lod_; }
+
+        // takes effect from the next update, disabling it wakes everything
+        void setRestConfig(const RestConfig &cfg);
+        const RestConfig &restConfig() const { return rest_; }
+        // particles moved from outside update(), e.g. by a collision pass
+        void wake(span<const uint32_t> ids);
+        size_t sleepingCount() const;
+        size_t activeCount() const { return size() - sleepingCount(); }
+
+        // deaths found by update() and by waking blocks; particles killed through view() are only
+        // seen when compaction removes them
+        const LayoutCounters &counters() const { return counters_; }
+
         span<const core::Vector2D> positions();
+
+        // every column, e.g. for snapshots - sleeping blocks are woken first so lifetimes are current
+        ParticleSoA &columns();
+        // after columns() were refilled from outside, rebuilds the tier and rest bookkeeping
+        void columnsReplaced();
+
         // for testing purposes
         std::vector<Particle> get();
 
     private:
+        struct BlockState
+        {
+            bool sleeping = false;
+            uint32_t sleepers = 0;   // live particles when the block fell asleep
+            float sleepTime = 0.f;   // time skipped since then, not yet taken off the lifetimes
+            float minLifetime = 0.f; // shortest lifetime in the block when it fell asleep
+        };
+
         ParticleSoA particles;
         std::vector<Vector2D> positionsCache_;
+        RestConfig rest_;
+        std::vector<uint8_t> restFrames_; // only kept while resting is enabled
+        std::vector<BlockState> blocks_;
+        std::vector<uint8_t> blockLod_; // level each block integrates at, see setLodLevel()
+        LayoutCounters counters_;
+        uint32_t frame_ = 0;
+        uint8_t lod_ = 0;
+        uint8_t maxTier_ = 1;
 
+        // frames between two integrations of a particle of the given tier
+        static uint32_t stride(uint8_t tier, uint8_t level) { return tier <= 1 ? 1u : uint32_t(tier) << level; }
+        // highest tier whose stride divides phase - tiers are powers of two, so that is every tier up to it
+        static uint8_t dueTier(uint32_t phase, uint8_t level)
+        {
+            const int shift = (phase == 0 ? 32 : countr_zero(phase)) - level;
+            return shift <= 0 ? 1 : shift >= 8 ? 255 : static_cast<uint8_t>(1u << shift);
+        }
+        // the block's level this frame, switched to lod_ on a boundary of both levels' strides
+        uint8_t blockLevel(size_t block, uint32_t phase)
+        {
+            if (block >= blockLod_.size())
+                blockLod_.resize(block + 1, lod_);
+            uint8_t &level = blockLod_[block];
+            if (level != lod_ && phase % (uint32_t(maxTier_) << max(level, lod_)) == 0)
+                level = lod_;
+            return level;
+        }
+
+        void updateTiered(float dt);
+        void updateBlocks(float dt);
+        void flushBlock(size_t block);
         void compactDead();
         const auto fields()
         {
@@ -109,10 +472,170 @@ namespace particlesim
         }
     };
 
+    // Fire-and-forget particles with constant acceleration. Nothing is written per frame: update()
+    // only advances the clock, positions are evaluated in closed form when positions() is called
+    // and a particle dies once the clock passes spawn time + lifetime.
+    // The analytic trajectory differs from the semi-implicit Euler layouts by (v0 + a t / 2) dt
+    // at most, the discretization error of those layouts.
+    // Spawn and death times are stored as floats relative to an epoch that update() moves forward
+    // every RebaseInterval seconds, so they keep sub-millisecond precision however long it runs.
+    class ParticleSystemDataBallistic
+    {
+    public:
+        static constexpr float RebaseInterval = 1024.f;
+
+        ParticleSystemDataBallistic(size_t capacity = 100000);
+
+        void update(float dt, bool compact = false);
+        size_t add(const Particle &p);
+        size_t size() const;
+        double time() const { return time_; }
+
+        span<const core::Vector2D> positions();
+        // for testing purposes
+        std::vector<Particle> get();
+
+    private:
+        BallisticSoA particles;
+        std::vector<Vector2D> positionsCache_;
+        double time_ = 0.0;
+        double epoch_ = 0.0;
+
+        // the clock in the units of the SpawnTime and DeathTime columns
+        float localTime() const { return static_cast<float>(time_ - epoch_); }
+        void rebase();
+        void compactDead();
+        const auto fields()
+        {
+            return tie(
+                particles.field<Position>(),
+                particles.field<Velocity>(),
+                particles.field<Acceleration>(),
+                particles.field<SpawnTime>(),
+                particles.field<DeathTime>());
+        }
+    };
+
+    // Particles kept in spawn order as a ring of cohorts: consecutive adds share a segment while
+    // their death times lie within cohortTolerance of each other, or while the segment holds fewer
+    // than MinCohortSize particles, so random lifetimes give segments of MinCohortSize rather than
+    // one per particle. update() skips expired segments and only checks deaths in segments that
+    // have started to expire.
+    // Compaction removes every expired particle and keeps the order. When particles die in spawn
+    // order, e.g. one lifetime per emitter, they are a prefix of the ring and compaction only moves
+    // the head; otherwise segments behind the first gap slide down to close it, one pass over them.
+    // Capacity is fixed and rounded up to a power of two, add() returns INVALID_INDEX when full.
+    // Death times are kept relative to an epoch moved every RebaseInterval seconds, as in
+    // ParticleSystemDataBallistic.
+    class ParticleSystemDataCohort
+    {
+    public:
+        static constexpr size_t MinCohortSize = 32;
+        static constexpr float RebaseInterval = 1024.f;
+
+        ParticleSystemDataCohort(size_t capacity = 100000, float cohortTolerance = 1.f / 60.f);
+
+        void update(float dt, bool compact = false);
+        size_t add(const Particle &p);
+        size_t size() const { return size_; }
+        size_t cohortCount() const { return cohorts_.size(); }
+
+        span<const core::Vector2D> positions();
+        // for testing purposes
+        std::vector<Particle> get();
+
+    private:
+        struct Cohort
+        {
+            size_t begin; // physical slot of the first particle
+            size_t count;
+            float minDeath;
+            float maxDeath;
+        };
+
+        CohortSoA particles;
+        std::deque<Cohort> cohorts_;
+        std::vector<Vector2D> positionsCache_;
+        size_t mask_ = 0;
+        size_t head_ = 0;
+        size_t size_ = 0;
+        double time_ = 0.0;
+        double epoch_ = 0.0;
+        float tolerance_;
+
+        // the clock in the units of the DeathTime column and the cohort bounds
+        float localTime() const { return static_cast<float>(time_ - epoch_); }
+        // whether a particle dying between minDeath and maxDeath may join the cohort
+        bool joins(const Cohort &c, float minDeath, float maxDeath) const
+        {
+            return c.count < MinCohortSize || (max(c.maxDeath, maxDeath) - min(c.minDeath, minDeath) <= tolerance_);
+        }
+        void rebase();
+        void compactDead();
+        void integrate(size_t begin, size_t end, float dt, bool checkDeath);
+        const auto fields()
+        {
+            return tie(
+                particles.field<Position>(),
+                particles.field<Velocity>(),
+                particles.field<Acceleration>(),
+                particles.field<DeathTime>());
+        }
+    };
+
+    // SoA compressed to 14 bytes per particle (30 for ParticleSystemDataSoA) for memory bound updates.
+    // Precision, with step = world extent / 65535 per axis and q = lifetimeQuantum:
+    //  - positions are fixed point over the world bounds and saturate at its edges. Each step rounds
+    //    with a per-particle dither, so the error is below one step per frame and zero on average
+    //  - velocity and acceleration are fp16 with 2^-11 relative error. The new velocity is rounded
+    //    every frame, so under constant acceleration it can drift by up to |v| / 4096 per frame
+    //  - lifetime counts down in ticks of q and saturates at 65535 ticks; deaths land within one tick
+    // With PARTICLESIM_USE_SIMD on an F16C target update() converts eight particles at a time.
+    class ParticleSystemDataQuantized
+    {
+    public:
+        ParticleSystemDataQuantized(size_t capacity = 100000, const WorldBounds &world = {}, float lifetimeQuantum = 1.f / 60.f);
+
+        void update(float dt, bool compact = false);
+        size_t add(const Particle &p);
+        size_t size() const;
+        // world units per fixed-point step
+        Vector2D positionStep() const { return {stepX_, stepY_}; }
+
+        span<const core::Vector2D> positions();
+        // for testing purposes
+        std::vector<Particle> get();
+
+    private:
+        QuantizedSoA particles;
+        std::vector<Vector2D> positionsCache_;
+        WorldBounds world_;
+        float stepX_;
+        float stepY_;
+        float quantum_;
+        double clock_ = 0.0;
+        uint32_t frame_ = 0;
+
+        void compactDead();
+        const auto fields()
+        {
+            return tie(
+                particles.field<Position>(),
+                particles.field<Velocity>(),
+                particles.field<Acceleration>(),
+                particles.field<Lifetime>());
+        }
+    };
+
+    // Free-list backed particles with a timing wheel of expiry ticks filled at add(), so deaths
+    // are found in O(deaths) and lifetime is never written in the update loop. Deaths are
+    // quantized to expiryResolution seconds (never early, at most one tick late); a particle
+    // that expires during update k is returned to the pool at the start of update k + 1.
     class ParticleSystemDataAllocated
     {
     public:
-        explicit ParticleSystemDataAllocated(size_t capacity) : pool_(capacity)
+        explicit ParticleSystemDataAllocated(size_t capacity, float expiryResolution = 1.f / 240.f)
+            : pool_(capacity), activeSlot_(capacity, INVALID_INDEX), deathTime_(capacity, 0.0), resolution_(expiryResolution)
         {
             activeIndices_.reserve(capacity);
         }
@@ -124,6 +647,13 @@ namespace particlesim
             return activeIndices_.size();
         }
 
+        void applyAcceleration(span<const core::Vector2D> acc, float dt);
+
+        // pool indices that expired during the last update
+        span<const size_t> expired() const { return expired_; }
+        // compaction moves are the swap-removes that return dead particles to the pool
+        const LayoutCounters &counters() const { return counters_; }
+
         span<const core::Vector2D> positions();
         // for testing purposes
         std::vector<Particle> get();
@@ -131,6 +661,16 @@ namespace particlesim
     private:
         core::FreeListPool<Particle> pool_;
         std::vector<size_t> activeIndices_;
+        std::vector<size_t> activeSlot_;  // pool index -> position in activeIndices_
+        std::vector<double> deathTime_;   // pool index -> absolute time of death
+        core::TimingWheel<size_t> expiry_;
+        std::vector<size_t> expired_;     // died during the last update
+        std::vector<size_t> pendingFree_; // added already dead
         std::vector<Vector2D> positionsCache_;
+        LayoutCounters counters_;
+        double time_ = 0.0;
+        double resolution_;
+
+        void release(size_t index);
     };
 }
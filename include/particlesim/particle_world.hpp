@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "core/vector.hpp"
+#include "core/free_list.hpp"
+#include "particle.hpp"
+#include "parallel_scheduler.hpp"
+
+namespace particlesim
+{
+    using namespace core;
+    using namespace std;
+
+    using EmitterID = uint32_t;
+
+    struct EmitterParams
+    {
+        Vector2D gravity{0.0f, 0.0f}; // added to every particle's own acceleration
+        float drag = 0.0f;            // linear drag, per second
+    };
+
+    // Many small emitters packed into one shared SoA.
+    // Every emitter owns a fixed range of capacity slots, reserved when it is created; its live
+    // particles are kept at the front of the range, so compaction never crosses emitters and
+    // whole emitters can go to different workers. One update() integrates all of them, reading
+    // the emitter parameters once per range.
+    class ParticleWorld
+    {
+    public:
+        // with a placement scheduler the reserved storage is first touched by its workers in
+        // contiguous slices - the pages each worker's emitters live on when emitters have similar capacities
+        explicit ParticleWorld(size_t capacity = 100000, PageBacking backing = defaultPageBacking(),
+                               ParallelScheduler *placement = nullptr);
+
+        // reserves capacity slots, views of earlier emitters are invalidated when storage grows
+        EmitterID createEmitter(size_t capacity, const EmitterParams &params = {});
+        void setParams(EmitterID id, const EmitterParams &params) { emitters[id].params = params; }
+        const EmitterParams &params(EmitterID id) const { return emitters[id].params; }
+
+        // INVALID_INDEX once the emitter's range is full, else the index within the emitter
+        size_t add(EmitterID id, const Particle &p);
+
+        // emitters are spread over the scheduler's workers, nullptr runs on the calling thread
+        void update(float dt, bool compact = false, ParallelScheduler *scheduler = nullptr);
+
+        size_t emitterCount() const { return emitters.size(); }
+        size_t size(EmitterID id) const { return emitters[id].count; }
+        // particles over all emitters
+        size_t size() const;
+
+        // columns of one emitter's range, valid until the next createEmitter()
+        ParticleSoAView view(EmitterID id);
+
+        // for testing purposes
+        std::vector<Particle> get(EmitterID id);
+
+    private:
+        struct Emitter
+        {
+            uint32_t begin;
+            uint32_t capacity;
+            uint32_t count;
+            EmitterParams params;
+        };
+
+        ParticleSoA particles;
+        vector<Emitter> emitters;
+
+        void updateEmitter(Emitter &e, float dt, bool compact);
+        const auto fields()
+        {
+            return tie(
+                particles.field<Position>(),
+                particles.field<Velocity>(),
+                particles.field<Acceleration>(),
+                particles.field<Lifetime>(),
+                particles.field<Alive>());
+        }
+    };
+}
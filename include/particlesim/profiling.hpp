@@ -0,0 +1,165 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(PARTICLESIM_ENABLE_PROFILING) && defined(PARTICLESIM_ENABLE_TRACY)
+#include "tracy/Tracy.hpp"
+#endif
+
+namespace particlesim
+{
+    enum class Stage : uint8_t
+    {
+        LayoutUpdate,
+        CompactDead,
+        Positions,
+        PartitionBuild,
+        PartitionQuery, // batches of queries, e.g. a neighbor list rebuild; single queries are not timed
+        Interactions,
+        Collisions,
+        Export, // recorder, publisher and shared memory export
+        Count
+    };
+
+    inline constexpr size_t StageCount = static_cast<size_t>(Stage::Count);
+
+    const char *stageName(Stage stage);
+
+    // Time spent in each stage during one frame, summed over all threads. A stage opened inside
+    // another counts toward both.
+    struct FrameStats
+    {
+        uint64_t frame = 0;
+        uint64_t frameNanoseconds = 0;
+        std::array<uint64_t, StageCount> nanoseconds{};
+        std::array<uint32_t, StageCount> calls{};
+
+        uint64_t stageNanoseconds(Stage stage) const { return nanoseconds[static_cast<size_t>(stage)]; }
+        uint32_t stageCalls(Stage stage) const { return calls[static_cast<size_t>(stage)]; }
+    };
+
+    // Collects the zones of PARTICLESIM_ZONE and keeps the last HistorySize frames of them.
+    // Every thread adds to its own counters; endFrame(), run by PARTICLESIM_FRAME between frames,
+    // folds them into the history. Without PARTICLESIM_ENABLE_PROFILING nothing reports to it
+    // and the history stays empty.
+    //
+    // There is one profiler per process and every PARTICLESIM_FRAME ends a frame, so a frame is
+    // one ParticleSystem::update. With several systems each of their updates is a frame of its
+    // own, and systems updating at the same time on different threads fold into each other's.
+    class FrameProfiler
+    {
+    public:
+        static constexpr size_t HistorySize = 256;
+
+        static FrameProfiler &instance();
+
+        static constexpr bool enabled()
+        {
+#ifdef PARTICLESIM_ENABLE_PROFILING
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void addStage(Stage stage, uint64_t nanoseconds);
+        void endFrame(uint64_t frameNanoseconds);
+
+        // frames ended so far, i.e. updates of any system; the history holds the last HistorySize of them
+        uint64_t frameCount() const;
+        // the last ended frame, empty before the first
+        FrameStats latest() const;
+        // oldest first
+        std::vector<FrameStats> history() const;
+        // drops the history and whatever the current frame collected so far
+        void reset();
+        // counter sets handed out so far, one per live thread that reported a stage; a thread that
+        // exits leaves its set to the next new thread
+        size_t threadCount() const;
+
+    private:
+        struct ThreadStages
+        {
+            std::array<std::atomic<uint64_t>, StageCount> nanoseconds{};
+            std::array<std::atomic<uint32_t>, StageCount> calls{};
+            std::atomic<bool> inUse{true}; // cleared when the owning thread exits
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadStages>> threads_; // never shrinks, free sets are reused
+        std::array<FrameStats, HistorySize> history_{};
+        uint64_t frames_ = 0;
+
+        ThreadStages &local();
+    };
+
+    namespace profiling
+    {
+        using Clock = std::chrono::steady_clock;
+
+        inline uint64_t since(Clock::time_point start)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        class StageZone
+        {
+        public:
+            explicit StageZone(Stage stage) : stage_(stage), start_(Clock::now()) {}
+            ~StageZone() { FrameProfiler::instance().addStage(stage_, since(start_)); }
+
+            StageZone(const StageZone &) = delete;
+            StageZone &operator=(const StageZone &) = delete;
+
+        private:
+            Stage stage_;
+            Clock::time_point start_;
+        };
+
+        class FrameZone
+        {
+        public:
+            FrameZone() : start_(Clock::now()) {}
+            ~FrameZone()
+            {
+                FrameProfiler::instance().endFrame(since(start_));
+#if defined(PARTICLESIM_ENABLE_PROFILING) && defined(PARTICLESIM_ENABLE_TRACY)
+                FrameMark;
+#endif
+            }
+
+            FrameZone(const FrameZone &) = delete;
+            FrameZone &operator=(const FrameZone &) = delete;
+
+        private:
+            Clock::time_point start_;
+        };
+    }
+}
+
+// PARTICLESIM_ZONE(Name) times the rest of the enclosing block as Stage::Name, PARTICLESIM_FRAME()
+// times the enclosing block as a whole frame and ends the frame with it. Both compile to nothing
+// unless PARTICLESIM_ENABLE_PROFILING is defined; with PARTICLESIM_ENABLE_TRACY they also become
+// Tracy zones and frame marks.
+#ifdef PARTICLESIM_ENABLE_PROFILING
+#define PARTICLESIM_CONCAT_IMPL(a, b) a##b
+#define PARTICLESIM_CONCAT(a, b) PARTICLESIM_CONCAT_IMPL(a, b)
+#ifdef PARTICLESIM_ENABLE_TRACY
+#define PARTICLESIM_TRACY_ZONE(name) ZoneScopedN(name)
+#else
+#define PARTICLESIM_TRACY_ZONE(name) ((void)0)
+#endif
+#define PARTICLESIM_ZONE(name)                                                                                   \
+    ::particlesim::profiling::StageZone PARTICLESIM_CONCAT(particlesimZone_, __LINE__)(::particlesim::Stage::name); \
+    PARTICLESIM_TRACY_ZONE(#name)
+#define PARTICLESIM_FRAME() ::particlesim::profiling::FrameZone PARTICLESIM_CONCAT(particlesimFrame_, __LINE__)
+#else
+#define PARTICLESIM_ZONE(name) ((void)0)
+#define PARTICLESIM_FRAME() ((void)0)
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "core/triple_buffer.hpp"
+#include "core/vector.hpp"
+#include "particle.hpp"
+
+namespace particlesim
+{
+    struct PublishedFrame
+    {
+        uint64_t index = 0; // publish() calls before this one
+        std::vector<float> posX, posY;
+        std::vector<float> lifetime;
+        std::vector<uint8_t> alive;
+
+        size_t size() const { return posX.size(); }
+    };
+
+    // Hands each simulated frame to one consumer thread through a core::TripleBuffer.
+    // publish() copies the frame into the back buffer and swaps it in without waiting for the
+    // consumer; latest() gives the consumer the newest complete frame without waiting for the
+    // simulation. Frames published in between two latest() calls are skipped.
+    // Every consumer thread needs its own publisher.
+    class FramePublisher
+    {
+    public:
+        // capacity - particles preallocated in each of the three buffers, frames above it grow them once
+        explicit FramePublisher(size_t capacity = 0);
+
+        FramePublisher(const FramePublisher &) = delete;
+        FramePublisher &operator=(const FramePublisher &) = delete;
+
+        // simulation thread
+        void publish(const ParticleSoAView &frame);
+        // layouts without columns: positions only, every particle alive and lifetime 0
+        void publish(std::span<const core::Vector2D> positions);
+        uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+
+        // consumer thread: the newest frame, nullptr until the first publish(). The frame stays
+        // untouched until the consumer calls latest() again.
+        const PublishedFrame *latest();
+
+    private:
+        core::TripleBuffer<PublishedFrame> frames_;
+        std::atomic<uint64_t> published_{0};
+        bool any_ = false; // consumer only
+    };
+}
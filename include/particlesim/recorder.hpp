@@ -0,0 +1,196 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/vector.hpp"
+#include "particle.hpp"
+
+namespace particlesim
+{
+    // Recording file, native byte order:
+    //   RecordingHeader | frame | frame | ... | keyframe index | RecordingTrailer
+    // Every frame is a FrameRecordHeader followed by its payload: x, y and the alive bits, each as
+    // core::packBlocks of zigzagged differences. Positions are quantized to multiples of quantum
+    // first, so the differences are exact and replay never drifts. Keyframes hold differences to
+    // zero, every other frame differences to the frame before it - particles past the previous
+    // count start from zero there too.
+    inline constexpr char RecordingMagic[8] = {'P', 'S', 'I', 'M', 'R', 'E', 'C', '1'};
+    inline constexpr uint32_t RecordingVersion = 1;
+
+    struct RecordingHeader
+    {
+        char magic[8];
+        uint32_t version;
+        float quantum;
+        uint32_t keyframeInterval;
+        uint32_t reserved = 0;
+    };
+
+    struct FrameRecordHeader
+    {
+        static constexpr uint32_t Frame = 0x4d415246u; // "FRAM"
+        static constexpr uint32_t Index = 0x58444e49u; // "INDX"
+        static constexpr uint32_t Keyframe = 1u;
+
+        uint32_t marker;
+        uint32_t flags;
+        uint64_t index;        // frame number, total frames for the index record
+        uint32_t count;        // particles, keyframes for the index record
+        uint32_t payloadBytes;
+    };
+
+    struct KeyframeEntry
+    {
+        uint64_t frame;
+        uint64_t offset; // of its FrameRecordHeader
+    };
+
+    struct RecordingTrailer
+    {
+        uint64_t indexOffset;
+        char magic[8];
+    };
+
+    struct RecorderConfig
+    {
+        float quantum = 1.f / 1024.f;  // position resolution, coordinates are kept within +-2^30 quanta
+        uint32_t keyframeInterval = 60; // frames between two keyframes, where replay can seek to
+        size_t queueDepth = 4;          // frames in flight before record() waits for the writer
+    };
+
+    struct RecorderStats
+    {
+        uint64_t frames = 0;       // written so far
+        uint64_t keyframes = 0;
+        uint64_t rawBytes = 0;     // the same frames as positions() spans, 8 bytes per particle
+        uint64_t encodedBytes = 0; // frame headers and payloads
+        uint64_t stalls = 0;       // record() calls that found the queue full
+        double recordSeconds = 0;  // spent inside record(), on the simulation thread
+        double encodeSeconds = 0;  // spent encoding and writing, on the writer thread
+
+        double compressionRatio() const { return encodedBytes ? double(rawBytes) / double(encodedBytes) : 0.0; }
+    };
+
+    // Streams frames to a recording file. record() only quantizes the frame into a queue slot;
+    // a background thread computes the differences, packs and writes them. At most queueDepth
+    // frames are in flight, record() blocks while the writer is that far behind.
+    // Writer errors surface as std::runtime_error from the next record(), flush() or close().
+    class FrameRecorder
+    {
+    public:
+        FrameRecorder(const std::string &path, const RecorderConfig &config = {});
+        // closes, dropping any error
+        ~FrameRecorder();
+
+        FrameRecorder(const FrameRecorder &) = delete;
+        FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+        // live particles of the view, e.g. ParticleSystemDataSoA::view() after update()
+        void record(const ParticleSoAView &frame);
+        // every particle counts as alive
+        void record(std::span<const core::Vector2D> positions);
+
+        // waits until every recorded frame is written
+        void flush();
+        // writes the keyframe index and closes the file; record() must not be called afterwards
+        void close();
+
+        const RecorderConfig &config() const { return config_; }
+        RecorderStats stats() const;
+
+    private:
+        struct Slot
+        {
+            uint64_t index = 0;
+            std::vector<int32_t> x, y;
+            std::vector<uint8_t> alive;
+        };
+
+        RecorderConfig config_;
+        std::string path_;
+        std::ofstream out_;
+        std::vector<Slot> slots_;
+        std::thread writer_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable slotFree_;
+        std::condition_variable frameReady_;
+        uint64_t submitted_ = 0; // frames handed to the writer, slot submitted_ % queueDepth is next
+        uint64_t written_ = 0;
+        bool stopping_ = false;
+        bool closed_ = false;
+        std::exception_ptr error_;
+        RecorderStats stats_;
+
+        // writer thread only
+        uint64_t offset_ = 0;
+        std::vector<int32_t> baseX_, baseY_;
+        std::vector<uint32_t> baseAlive_;
+        std::vector<uint32_t> scratch_;
+        std::vector<uint8_t> payload_;
+        std::vector<KeyframeEntry> keyframes_;
+
+        Slot &acquireSlot();
+        void submit(std::chrono::steady_clock::time_point start);
+        void writerLoop();
+        // encoded bytes, header included
+        size_t writeFrame(const Slot &slot, bool keyframe);
+        void encodeAxis(const std::vector<int32_t> &values, std::vector<int32_t> &base, bool keyframe);
+        void writeBytes(const void *data, size_t bytes);
+    };
+
+    struct RecordedFrame
+    {
+        uint64_t index = 0;
+        bool keyframe = false;
+        std::vector<float> x, y;
+        std::vector<uint8_t> alive;
+
+        size_t size() const { return x.size(); }
+    };
+
+    // Reads a recording front to back, or from the keyframe before any frame. Recordings that were
+    // never closed have no index; it is rebuilt by scanning them once, leaving out a last frame that
+    // was cut off. Throws std::runtime_error on files that are not recordings or hold corrupt frames.
+    class FrameReplay
+    {
+    public:
+        explicit FrameReplay(const std::string &path);
+
+        float quantum() const { return header_.quantum; }
+        uint64_t frameCount() const { return frameCount_; }
+        const std::vector<KeyframeEntry> &keyframes() const { return keyframes_; }
+
+        // the next frame, false past the last one
+        bool next(RecordedFrame &frame);
+        // the next call to next() returns the given frame, decoding forward from the keyframe before it
+        void seek(uint64_t frame);
+
+    private:
+        std::string path_;
+        std::ifstream in_;
+        RecordingHeader header_{};
+        uint64_t frameCount_ = 0;
+        std::vector<KeyframeEntry> keyframes_;
+
+        // decoding state: the previous frame in quanta
+        std::vector<int32_t> x_, y_;
+        std::vector<uint32_t> alive_;
+        std::vector<uint8_t> payload_;
+        std::vector<uint32_t> scratch_;
+        uint64_t expected_ = 0; // index of the frame next() reads
+        bool haveBase_ = false;
+
+        // decodes the frame at the read position, into frame unless it is nullptr
+        bool readFrame(RecordedFrame *frame);
+        void scan(uint64_t size);
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include "core/vector.hpp"
+#include "particle.hpp"
+
+namespace particlesim
+{
+    // POSIX shared memory segment, native byte order:
+    //   SharedFrameHeader | slot | slot | ...
+    // A slot is a SharedSlotHeader followed by posX, posY and alive columns of capacity particles,
+    // each starting on a cache line. Frame f goes to slot f % slotCount under that slot's seqlock:
+    // sequence is odd while the writer is inside. Readers map the segment read-only and read
+    // columns in place, then check the sequence did not move - with several slots the writer only
+    // comes back to a slot slotCount frames later, so readers rarely have to retry.
+    inline constexpr char SharedFrameMagic[8] = {'P', 'S', 'I', 'M', 'S', 'H', 'M', '1'};
+    inline constexpr uint32_t SharedFrameVersion = 2;
+
+    struct SharedFrameHeader
+    {
+        std::atomic<uint64_t> magic; // SharedFrameMagic's bytes, stored last once the header is complete
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t capacity;  // particles per slot
+        uint64_t slotBytes; // distance between two slots
+        uint64_t slotsOffset;
+        int64_t writerPid; // process that created the segment
+        alignas(64) std::atomic<uint64_t> published; // frames completed, the newest is published - 1
+    };
+
+    struct alignas(64) SharedSlotHeader
+    {
+        std::atomic<uint64_t> sequence;
+        uint64_t frame;
+        uint64_t count;      // particles in the columns
+        uint64_t totalCount; // particles the system had, above count when it exceeded capacity
+        uint64_t aliveCount;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock is shared between processes");
+
+    // Creates the segment and exports frames into it. The name follows shm_open, e.g. "/particles".
+    // A segment whose writer has exited, e.g. after a crash, is replaced; one whose writer is still
+    // running is left alone and the constructor fails with EEXIST.
+    // Throws std::runtime_error when the segment cannot be created or mapped.
+    class SharedFrameExport
+    {
+    public:
+        SharedFrameExport(const std::string &name, size_t capacity, uint32_t slotCount = 4);
+        // unmaps and unlinks the name, readers that still map it keep their mapping
+        ~SharedFrameExport();
+
+        SharedFrameExport(const SharedFrameExport &) = delete;
+        SharedFrameExport &operator=(const SharedFrameExport &) = delete;
+
+        // the first capacity() particles of the frame
+        void publish(const ParticleSoAView &frame);
+        // every particle counts as alive
+        void publish(std::span<const core::Vector2D> positions);
+
+        const std::string &name() const { return name_; }
+        size_t capacity() const { return header()->capacity; }
+        uint64_t published() const { return header()->published.load(std::memory_order_relaxed); }
+
+    private:
+        std::string name_;
+        unsigned char *base_ = nullptr;
+        size_t bytes_ = 0;
+
+        SharedFrameHeader *header() const { return reinterpret_cast<SharedFrameHeader *>(base_); }
+        // opens the slot of the next frame for writing, returns its columns
+        SharedSlotHeader *beginSlot(float *&x, float *&y, uint8_t *&alive);
+        void endSlot(SharedSlotHeader *slot, size_t count, size_t totalCount, size_t aliveCount);
+    };
+
+    // Read-only mapping of a segment some other process exports into.
+    class SharedFrameReader
+    {
+    public:
+        // columns of one slot, in place in the mapping
+        struct Frame
+        {
+            uint64_t frame = 0;
+            size_t count = 0;
+            size_t totalCount = 0;
+            size_t aliveCount = 0;
+            const float *posX = nullptr;
+            const float *posY = nullptr;
+            const uint8_t *alive = nullptr;
+
+            size_t slot = 0;
+            uint64_t sequence = 0;
+        };
+
+        // throws std::runtime_error when there is no such segment or it is not a frame export
+        explicit SharedFrameReader(const std::string &name);
+        ~SharedFrameReader();
+
+        SharedFrameReader(const SharedFrameReader &) = delete;
+        SharedFrameReader &operator=(const SharedFrameReader &) = delete;
+
+        uint64_t published() const { return header()->published.load(std::memory_order_acquire); }
+
+        // the newest frame, false when nothing was published yet or its slot is being written
+        bool latest(Frame &frame) const;
+        // whether the columns of frame were left alone since latest() returned it; reads of them
+        // only count once this says so
+        bool unchanged(const Frame &frame) const;
+
+        // fn(const Frame &) on the newest frame until it ran on columns that stayed intact,
+        // at most attempts times; false when no attempt succeeded
+        template <typename Fn>
+        bool read(Fn &&fn, int attempts = 8) const
+        {
+            Frame frame;
+            for (int i = 0; i < attempts; ++i)
+            {
+                if (!latest(frame))
+                    continue;
+                fn(frame);
+                if (unchanged(frame))
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        const unsigned char *base_ = nullptr;
+        size_t bytes_ = 0;
+
+        const SharedFrameHeader *header() const { return reinterpret_cast<const SharedFrameHeader *>(base_); }
+        const SharedSlotHeader *slot(size_t index) const;
+    };
+}
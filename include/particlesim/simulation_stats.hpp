@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "spatial_partitioning.hpp"
+
+namespace particlesim
+{
+    // running totals of layouts that count their deaths as they integrate
+    struct LayoutCounters
+    {
+        uint64_t deaths = 0;          // lifetimes that ran out during an update
+        uint64_t compactionMoves = 0; // particles moved into the slot of a dead one
+        size_t dead = 0;              // dead particles still holding a slot
+    };
+
+    // One ParticleSystem::update(), gathered by the passes that run anyway. Births are the growth
+    // since the previous update; deaths, moves and the alive count need a layout with counters,
+    // for the others deaths and moves stay 0 and alive equals particles.
+    struct SimulationStats
+    {
+        uint64_t frame = 0; // updates so far
+        size_t particles = 0;
+        size_t alive = 0;
+        size_t births = 0;
+        size_t deaths = 0;
+        size_t compactionMoves = 0;
+        PartitionStats partition; // the last build and the queries made since
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "particle.hpp"
+
+namespace particlesim
+{
+    class ParticleSystemDataSoA;
+
+    // Columnar snapshot file, native byte order:
+    //   SnapshotHeader | SnapshotSection[sectionCount] | padding | column | padding | column ...
+    // One section per component of every ParticleSoA field, each column starting on a
+    // SnapshotAlignment boundary so a mapping of the file can be read in place.
+    inline constexpr char SnapshotMagic[8] = {'P', 'S', 'I', 'M', 'S', 'N', 'A', 'P'};
+    inline constexpr uint32_t SnapshotVersion = 1;
+    inline constexpr uint32_t SnapshotByteOrder = 0x01020304u;
+    inline constexpr size_t SnapshotAlignment = 4096;
+
+    enum class SnapshotField : uint32_t
+    {
+        Position,
+        Velocity,
+        Acceleration,
+        Lifetime,
+        Alive,
+        Tier,
+        Count
+    };
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t particleCount;
+        uint32_t sectionCount;
+        uint32_t reserved = 0;
+    };
+
+    struct SnapshotSection
+    {
+        uint32_t field;       // SnapshotField
+        uint32_t component;   // 0 = x, 1 = y for vector fields
+        uint32_t elementSize; // bytes per particle
+        uint32_t reserved = 0;
+        uint64_t offset;      // from the start of the file
+        uint64_t bytes;
+    };
+
+    // writes every column of the layout with a single writev, throws std::runtime_error on failure
+    void writeSnapshot(const std::string &path, ParticleSystemDataSoA &layout);
+
+    // Read-only mapping of a snapshot file. Columns can be read in place for as long as the
+    // mapping lives, or copied into a layout without touching particles one by one.
+    class MappedSnapshot
+    {
+    public:
+        // maps and validates the file, throws std::runtime_error when it is not a readable snapshot
+        explicit MappedSnapshot(const std::string &path);
+        ~MappedSnapshot();
+
+        MappedSnapshot(MappedSnapshot &&other) noexcept;
+        MappedSnapshot &operator=(MappedSnapshot &&other) noexcept;
+        MappedSnapshot(const MappedSnapshot &) = delete;
+        MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+        size_t size() const { return header().particleCount; }
+        uint32_t version() const { return header().version; }
+
+        // one component of a field, nullptr when the file does not have it
+        const void *column(SnapshotField field, uint32_t component = 0) const;
+
+        template <typename T>
+        const T *column(SnapshotField field, uint32_t component = 0) const
+        {
+            const SnapshotSection *s = section(field, component);
+            return s && s->elementSize == sizeof(T) ? static_cast<const T *>(column(field, component)) : nullptr;
+        }
+
+        // replaces the layout's particles with the snapshot's, tier 1 where the file has none
+        void restore(ParticleSystemDataSoA &layout) const;
+
+    private:
+        const unsigned char *data_ = nullptr;
+        size_t bytes_ = 0;
+
+        const SnapshotHeader &header() const { return *reinterpret_cast<const SnapshotHeader *>(data_); }
+        const SnapshotSection *section(SnapshotField field, uint32_t component) const;
+        void unmap();
+    };
+}
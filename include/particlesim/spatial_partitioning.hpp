@@ -5,6 +5,8 @@
 #include <cstdio>
 #include "core/vector.hpp"
 #include "core/memory_arena.hpp"
+#include "core/log2_histogram.hpp"
+#include "parallel_scheduler.hpp"
 namespace particlesim
 {
     using namespace core;
@@ -30,8 +32,21 @@ namespace particlesim
     struct PartitionData
     {
         span<const Vector2D> positions = {};
-        FrameArena arena = {};
+        FrameArena *arena = nullptr; // not owned, backs arena-allocated query results
     };
+
+    // gathered while building and querying, reset by clear()
+    struct PartitionStats
+    {
+        size_t particles = 0;         // in the last build
+        size_t cells = 0;             // 0 for partitions without cells
+        Log2Histogram occupancy;      // particles per non-empty cell, total() is the non-empty cell count
+        Log2Histogram neighborCounts; // result sizes of queryNeighborhood()
+
+        size_t nonEmptyCells() const { return static_cast<size_t>(occupancy.total()); }
+        uint32_t maxOccupancy() const { return occupancy.max(); }
+    };
+
     class ISpatialPartition
     {
     public:
@@ -40,6 +55,8 @@ namespace particlesim
         virtual void build() = 0;
         virtual span<const uint32_t> queryNeighborhood(uint32_t particleID) = 0;
         virtual void clear() = 0;
+        // partitions that keep no statistics only report the particle count, or nothing
+        virtual PartitionStats stats() const { return {}; }
     };
 
     class UniformGrid : public ISpatialPartition
@@ -49,16 +66,77 @@ namespace particlesim
 
         // update grid dimensions when world bounds or cellSize change
         void resizeGrid(float cellSize, const WorldBounds &world);
+        const WorldBounds &world() const { return bounds; }
 
         // ISpatialPartition interface
         void setData(const PartitionData &data) override { this->data = data; }
         virtual void build() override;
         virtual span<const uint32_t> queryNeighborhood(uint32_t particleID) override;
         virtual void clear() override;
+        PartitionStats stats() const override;
 
         uint32_t toCellIndex(float x, float y) const;
         void worldToCell(float x, float y, int &outX, int &outY) const;
 
+        uint32_t width() const { return gridWidth; }
+        uint32_t height() const { return gridHeight; }
+        span<const uint32_t> cellParticles(uint32_t cx, uint32_t cy) const { return buckets[cy * gridWidth + cx]; }
+
+        // Visits every unordered pair of neighbouring cells whose first cell lies in [rowBegin, rowEnd):
+        // the cell with itself plus the forward half of its 3x3 block (E, NW, N, NE).
+        // fn(span a, span b, bool sameCell). A row only reaches into the row above it, so rows of
+        // equal parity never share a particle and can be processed concurrently.
+        template <typename F>
+        void forEachCellPair(uint32_t rowBegin, uint32_t rowEnd, F &&fn) const
+        {
+            static constexpr int forward[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+            for (uint32_t cy = rowBegin; cy < rowEnd; ++cy)
+            {
+                for (uint32_t cx = 0; cx < gridWidth; ++cx)
+                {
+                    const auto &a = buckets[cy * gridWidth + cx];
+                    if (a.empty())
+                        continue;
+
+                    fn(span<const uint32_t>(a), span<const uint32_t>(a), true);
+                    for (const auto &offset : forward)
+                    {
+                        const int nx = static_cast<int>(cx) + offset[0];
+                        const int ny = static_cast<int>(cy) + offset[1];
+                        if (nx < 0 || nx >= static_cast<int>(gridWidth) || ny >= static_cast<int>(gridHeight))
+                            continue;
+
+                        const auto &b = buckets[ny * gridWidth + nx];
+                        if (!b.empty())
+                            fn(span<const uint32_t>(a), span<const uint32_t>(b), false);
+                    }
+                }
+            }
+        }
+
+        // fn(row, worker) for every row, even rows first then odd rows - each pass is safe to
+        // combine with forEachCellPair(row, row + 1) writing to the particles it visits
+        template <typename F>
+        void forEachRowColored(ParallelScheduler *scheduler, F &&fn) const
+        {
+            for (uint32_t parity = 0; parity < 2; ++parity)
+            {
+                const size_t rows = (gridHeight + 1 - parity) / 2;
+                if (!scheduler)
+                {
+                    for (size_t r = 0; r < rows; ++r)
+                        fn(static_cast<uint32_t>(2 * r + parity), size_t{0});
+                    continue;
+                }
+
+                scheduler->parallelFor(rows, [&](size_t begin, size_t end, size_t worker)
+                                       {
+                    for (size_t r = begin; r < end; ++r)
+                        fn(static_cast<uint32_t>(2 * r + parity), worker); });
+            }
+        }
+
         PartitioningConfig config;
 
     protected:
@@ -66,6 +144,8 @@ namespace particlesim
         uint32_t gridWidth = 0;
         uint32_t gridHeight = 0;
         vector<vector<uint32_t>> buckets;
+        Log2Histogram occupancy_;
+        Log2Histogram neighborCounts_;
 
     private:
         WorldBounds bounds;
@@ -80,6 +160,10 @@ namespace particlesim
         UniformGridAllocated(const PartitioningConfig &cfg) : UniformGrid(cfg) {};
 
         span<const uint32_t> queryNeighborhood(uint32_t particleID) override;
+        // result goes to the given arena instead of the shared one, so threads can query
+        // the same built grid concurrently as long as each passes its own arena. Not counted in
+        // stats().neighborCounts, which only the single-threaded overload updates
+        span<const uint32_t> queryNeighborhood(uint32_t particleID, FrameArena &arena) const;
         void clear() override;
     };
 
@@ -95,6 +179,7 @@ namespace particlesim
         span<const uint32_t> queryNeighborhood(uint32_t particleID) override;
 
         void clear() override { neighborBuffer.clear(); }
+        PartitionStats stats() const override;
 
         PartitioningConfig config;
 
@@ -103,4 +188,52 @@ namespace particlesim
         mutable vector<uint32_t> neighborBuffer;
     };
 
+    // Static implicit kd-tree rebuilt from scratch on every build().
+    // Slots are stored in build order: the median of [lo, hi) sits at mid and its subtrees
+    // are [lo, mid) and [mid + 1, hi), so no child pointers are needed.
+    class KDTree final : public ISpatialPartition
+    {
+    public:
+        static constexpr uint32_t InvalidID = UINT32_MAX;
+        static constexpr uint32_t LeafSize = 8;
+
+        explicit KDTree(const PartitioningConfig &cfg) : config(cfg) { neighborBuffer.reserve(cfg.neighborReserve); }
+
+        void setData(const PartitionData &data) override { this->data = data; }
+        void build() override;
+        // all particles within config.cellSize of the queried one
+        span<const uint32_t> queryNeighborhood(uint32_t particleID) override;
+        void clear() override;
+        PartitionStats stats() const override;
+
+        // k nearest particles ordered by distance, allocated from the arena (valid until its reset)
+        span<const uint32_t> queryKNearest(uint32_t particleID, uint32_t k);
+        span<const uint32_t> queryKNearest(const Vector2D &point, uint32_t k);
+
+        // k results per requested particle in row-major order, missing entries are InvalidID
+        span<const uint32_t> queryKNearestBatch(span<const uint32_t> particleIDs, uint32_t k, ParallelScheduler &scheduler);
+
+        PartitioningConfig config;
+
+    private:
+        struct Candidate
+        {
+            float distSq;
+            uint32_t id;
+        };
+
+        PartitionData data = {};
+        vector<Vector2D> points; // positions in tree order
+        vector<uint32_t> ids;    // particle index per tree slot
+        vector<uint8_t> splitAxis;
+        vector<Candidate> heapScratch;
+        mutable vector<uint32_t> neighborBuffer;
+
+        void buildRange(uint32_t lo, uint32_t hi);
+        uint32_t searchKNearest(const Vector2D &point, uint32_t k, uint32_t exclude, Candidate *heap) const;
+        void searchKNearest(uint32_t lo, uint32_t hi, const Vector2D &point, uint32_t k, uint32_t exclude, Candidate *heap, uint32_t &count) const;
+        void searchRadius(uint32_t lo, uint32_t hi, const Vector2D &point, float radiusSq, uint32_t exclude);
+        span<const uint32_t> writeResults(const Candidate *heap, uint32_t count);
+    };
+
 }
@@ -0,0 +1,133 @@
+#include "particlesim/collision.hpp"
+#include <cassert>
+#include <cmath>
+
+using namespace particlesim;
+
+void CollisionSolver::generateContacts(const UniformGrid &grid, const ParticleSoAView &particles, ParallelScheduler *scheduler)
+{
+    const float contactDist = 2.f * config.radius + config.contactMargin;
+    const float contactDistSq = contactDist * contactDist;
+    const float *px = particles.posX;
+    const float *py = particles.posY;
+    const uint8_t *alive = particles.alive;
+
+    rowContacts.resize(grid.height());
+
+    // each row owns its contact list, so rows can be generated in any order
+    grid.forEachRowColored(scheduler, [&](uint32_t row, size_t)
+                           {
+        auto &out = rowContacts[row];
+        out.clear();
+        grid.forEachCellPair(row, row + 1, [&](span<const uint32_t> a, span<const uint32_t> b, bool sameCell)
+                             {
+            for (size_t ia = 0; ia < a.size(); ++ia)
+            {
+                const uint32_t i = a[ia];
+                if (!alive[i])
+                    continue;
+
+                for (size_t ib = sameCell ? ia + 1 : 0; ib < b.size(); ++ib)
+                {
+                    const uint32_t j = b[ib];
+                    const float dx = px[i] - px[j];
+                    const float dy = py[i] - py[j];
+                    if (alive[j] && dx * dx + dy * dy < contactDistSq)
+                        out.push_back({i, j});
+                }
+            } }); });
+
+    contacts = 0;
+    for (const auto &row : rowContacts)
+        contacts += row.size();
+}
+
+void CollisionSolver::solve(const UniformGrid &grid, ParticleSoAView particles, float dt, ParallelScheduler *scheduler)
+{
+    assert(grid.config.cellSize >= 2.f * config.radius && "grid cells must cover a contact");
+
+    const size_t n = particles.count;
+    resolved = 0;
+    displacedIds.clear();
+    if (n == 0)
+        return;
+
+    generateContacts(grid, particles, scheduler);
+    if (contacts == 0)
+        return;
+
+    moved.assign(n, 0);
+
+    float *px = particles.posX;
+    float *py = particles.posY;
+
+    const bool fixVelocities = config.updateVelocities && dt > 0.f;
+    if (fixVelocities)
+    {
+        startX.assign(px, px + n);
+        startY.assign(py, py + n);
+    }
+
+    counters.assign(scheduler ? scheduler->workerCount() : 1, {});
+    const float contactDist = 2.f * config.radius;
+    const float contactDistSq = contactDist * contactDist;
+    const float halfRelax = 0.5f * config.relaxation;
+
+    for (uint32_t it = 0; it < config.iterations; ++it)
+    {
+        grid.forEachRowColored(scheduler, [&](uint32_t row, size_t worker)
+                               {
+            uint64_t local = 0;
+            for (const Contact &c : rowContacts[row])
+            {
+                const float dx = px[c.a] - px[c.b];
+                const float dy = py[c.a] - py[c.b];
+                const float distSq = dx * dx + dy * dy;
+                if (distSq >= contactDistSq)
+                    continue;
+
+                const float dist = sqrt(distSq);
+                if (dist < 1e-6f)
+                {
+                    // coincident - separate along x
+                    const float push = halfRelax * contactDist;
+                    px[c.a] += push;
+                    px[c.b] -= push;
+                    moved[c.a] = moved[c.b] = 1;
+                    ++local;
+                    continue;
+                }
+
+                // equal masses - each particle takes half of the overlap
+                const float s = halfRelax * (contactDist - dist) / dist;
+                px[c.a] += dx * s;
+                py[c.a] += dy * s;
+                px[c.b] -= dx * s;
+                py[c.b] -= dy * s;
+                moved[c.a] = moved[c.b] = 1;
+                ++local;
+            }
+            counters[worker].resolved += local; });
+    }
+
+    for (const auto &c : counters)
+        resolved += c.resolved;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (moved[i])
+            displacedIds.push_back(static_cast<uint32_t>(i));
+    }
+
+    if (fixVelocities)
+    {
+        const float invDt = 1.f / dt;
+        float *vx = particles.velX;
+        float *vy = particles.velY;
+        for (size_t i = 0; i < n; ++i)
+        {
+            vx[i] += (px[i] - startX[i]) * invDt;
+            vy[i] += (py[i] - startY[i]) * invDt;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "particlesim/grid_tuner.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace particlesim;
+
+bool GridAutoTuner::observe(UniformGrid &grid, float minCellSize)
+{
+    if (cooldown_ > 0)
+    {
+        --cooldown_;
+        return false;
+    }
+
+    const PartitionStats stats = grid.stats();
+    if (stats.nonEmptyCells() == 0)
+        return false;
+
+    // other particles per cell around the average particle: a query sees 3x3 cells, and without
+    // queries the cell a particle sits in counts it and its companions
+    const float selfCounted = grid.config.excludeSelfFromQuery ? 0.f : 1.f;
+    const float occupancy = stats.neighborCounts.total() > 0
+                                ? (float(stats.neighborCounts.mean()) - selfCounted) / 9.f
+                                : float(stats.occupancy.weightedMean()) - 1.f;
+    occupancySum_ += occupancy;
+    windowMax_ = max(windowMax_, stats.maxOccupancy());
+    if (++frames_ < config.window)
+        return false;
+
+    const float average = float(occupancySum_ / frames_);
+    lastOccupancy_ = average;
+    const float cellSize = chooseCellSize(grid, average, minCellSize);
+    occupancySum_ = 0.0;
+    windowMax_ = 0;
+    frames_ = 0;
+
+    // under 5% is not worth emptying the grid for
+    if (abs(cellSize - grid.config.cellSize) < 0.05f * grid.config.cellSize)
+        return false;
+
+    grid.resizeGrid(cellSize, grid.world());
+    cooldown_ = config.cooldown;
+    ++resizes_;
+    return true;
+}
+
+float GridAutoTuner::chooseCellSize(const UniformGrid &grid, float occupancy, float minCellSize) const
+{
+    const float current = grid.config.cellSize;
+    const float target = config.targetOccupancy;
+    if (occupancy <= 0.f || (occupancy >= target / config.hysteresis && occupancy <= target * config.hysteresis))
+        return current;
+
+    float scale = sqrt(target / occupancy);
+    // the hottest cell grows with the area, scale^2
+    if (scale > 1.f && float(windowMax_) * scale * scale > float(config.maxOccupancy))
+        scale = max(1.f, sqrt(float(config.maxOccupancy) / float(max(windowMax_, 1u))));
+
+    const WorldBounds &world = grid.world();
+    const float cellsFloor = sqrt(world.width() * world.height() / float(config.maxCells));
+    const float lo = max({config.minCellSize, minCellSize, cellsFloor});
+    const float hi = max(lo, config.maxCellSize);
+    return clamp(current * scale, lo, hi);
+}
@@ -0,0 +1,106 @@
+#include "particlesim/interactions.hpp"
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+using namespace particlesim;
+
+template <typename PairFn>
+void ParticleInteractions::forEachPair(const UniformGrid &grid, span<const Vector2D> positions, ParallelScheduler *scheduler, PairFn &&fn)
+{
+    const float radiusSq = config.radius * config.radius;
+
+    grid.forEachRowColored(scheduler, [&](uint32_t row, size_t worker)
+                           {
+        uint64_t local = 0;
+        grid.forEachCellPair(row, row + 1, [&](span<const uint32_t> a, span<const uint32_t> b, bool sameCell)
+                             {
+            for (size_t ia = 0; ia < a.size(); ++ia)
+            {
+                const uint32_t i = a[ia];
+                const Vector2D pi = positions[i];
+
+                for (size_t ib = sameCell ? ia + 1 : 0; ib < b.size(); ++ib)
+                {
+                    const uint32_t j = b[ib];
+                    float dx = pi.x - positions[j].x;
+                    float dy = pi.y - positions[j].y;
+                    float distSq = dx * dx + dy * dy;
+                    if (distSq >= radiusSq)
+                        continue;
+
+                    if (distSq < 1e-12f)
+                    {
+                        // coincident particles - pick a fixed direction so they can separate
+                        dx = 1e-6f;
+                        dy = 0.f;
+                        distSq = dx * dx;
+                    }
+
+                    fn(i, j, dx, dy, distSq);
+                    ++local;
+                }
+            } });
+        counters[worker].pairs += local; });
+}
+
+void ParticleInteractions::compute(const UniformGrid &grid, span<const Vector2D> positions, ParallelScheduler *scheduler)
+{
+    assert(config.radius <= grid.config.cellSize && "interaction radius must fit in one grid cell");
+
+    const size_t n = positions.size();
+    accel.assign(n, Vector2D{});
+    counters.assign(scheduler ? scheduler->workerCount() : 1, {});
+
+    const float h = config.radius;
+
+    if (config.model == InteractionModel::SoftRepulsion)
+    {
+        const float stiffness = config.stiffness;
+        forEachPair(grid, positions, scheduler, [&](uint32_t i, uint32_t j, float dx, float dy, float distSq)
+                    {
+            const float dist = sqrt(distSq);
+            const float s = stiffness * (1.f - dist / h) / dist;
+            const Vector2D f(dx * s, dy * s);
+            accel[i] += f;
+            accel[j] -= f; });
+        density.clear();
+    }
+    else
+    {
+        // 2D poly6 for density, spiky gradient for pressure
+        const float pi = numbers::pi_v<float>;
+        const float h2 = h * h;
+        const float poly6 = 4.f / (pi * h2 * h2 * h2 * h2);
+        const float spiky = 30.f / (pi * h2 * h2 * h);
+        const float mass = config.particleMass;
+
+        density.assign(n, mass * poly6 * h2 * h2 * h2);
+        forEachPair(grid, positions, scheduler, [&](uint32_t i, uint32_t j, float, float, float distSq)
+                    {
+            const float q = h2 - distSq;
+            const float w = mass * poly6 * q * q * q;
+            density[i] += w;
+            density[j] += w; });
+
+        pressureTerm.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const float pressure = max(0.f, config.pressureStiffness * (density[i] - config.restDensity));
+            pressureTerm[i] = pressure / (density[i] * density[i]);
+        }
+
+        forEachPair(grid, positions, scheduler, [&](uint32_t i, uint32_t j, float dx, float dy, float distSq)
+                    {
+            const float dist = sqrt(distSq);
+            const float q = h - dist;
+            const float g = mass * (pressureTerm[i] + pressureTerm[j]) * spiky * q * q / dist;
+            const Vector2D f(dx * g, dy * g);
+            accel[i] += f;
+            accel[j] -= f; });
+    }
+
+    pairs = 0;
+    for (const auto &c : counters)
+        pairs += c.pairs;
+}
@@ -0,0 +1,105 @@
+#include "particlesim/neighbor_list.hpp"
+#include "particlesim/profiling.hpp"
+#include <algorithm>
+#include <cassert>
+
+using namespace particlesim;
+
+static PartitioningConfig listGridConfig(PartitioningConfig cfg, const NeighborListConfig &lists)
+{
+    // a 3x3 cell block has to cover the whole list radius
+    cfg.cellSize = max(cfg.cellSize, lists.radius + lists.skin);
+    cfg.excludeSelfFromQuery = true;
+    return cfg;
+}
+
+NeighborListCache::NeighborListCache(const PartitioningConfig &gridConfig, const NeighborListConfig &cfg)
+    : config(cfg), grid(listGridConfig(gridConfig, cfg))
+{
+    assert(cfg.radius > 0.f && cfg.skin >= 0.f);
+}
+
+bool NeighborListCache::update(span<const Vector2D> positions)
+{
+    if (valid && positions.size() == reference.size())
+    {
+        const float limit = 0.5f * config.skin;
+        if (maxDisplacementSq(positions) <= limit * limit)
+            return false;
+    }
+
+    rebuild(positions);
+    return true;
+}
+
+float NeighborListCache::maxDisplacementSq(span<const Vector2D> positions) const
+{
+    assert(positions.size() == reference.size());
+
+    // independent lanes so the max reduction vectorizes without reassociating float ops
+    constexpr size_t Lanes = 8;
+    float lanes[Lanes] = {};
+
+    const Vector2D *cur = positions.data();
+    const Vector2D *ref = reference.data();
+    const size_t n = positions.size();
+    const size_t blocked = n - n % Lanes;
+
+    for (size_t i = 0; i < blocked; i += Lanes)
+    {
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            const float dx = cur[i + l].x - ref[i + l].x;
+            const float dy = cur[i + l].y - ref[i + l].y;
+            const float d = dx * dx + dy * dy;
+            lanes[l] = lanes[l] < d ? d : lanes[l];
+        }
+    }
+    for (size_t i = blocked; i < n; ++i)
+    {
+        const float dx = cur[i].x - ref[i].x;
+        const float dy = cur[i].y - ref[i].y;
+        const float d = dx * dx + dy * dy;
+        lanes[0] = lanes[0] < d ? d : lanes[0];
+    }
+
+    return *max_element(lanes, lanes + Lanes);
+}
+
+void NeighborListCache::rebuild(span<const Vector2D> positions)
+{
+    const uint32_t n = static_cast<uint32_t>(positions.size());
+    const float cutoff = config.radius + config.skin;
+    const float cutoffSq = cutoff * cutoff;
+
+    grid.clear();
+    grid.setData({positions, nullptr});
+    grid.build();
+
+    offsets_.resize(n + 1);
+    indices_.clear();
+    lengths_.clear();
+    offsets_[0] = 0;
+
+    {
+        // one zone for the whole pass, a zone per query would cost more than many of the queries
+        PARTICLESIM_ZONE(PartitionQuery);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const Vector2D &p = positions[i];
+            for (uint32_t j : grid.queryNeighborhood(i))
+            {
+                const float dx = positions[j].x - p.x;
+                const float dy = positions[j].y - p.y;
+                if (dx * dx + dy * dy <= cutoffSq)
+                    indices_.push_back(j);
+            }
+            offsets_[i + 1] = static_cast<uint32_t>(indices_.size());
+            lengths_.record(offsets_[i + 1] - offsets_[i]);
+        }
+    }
+
+    reference.assign(positions.begin(), positions.end());
+    valid = true;
+    ++rebuilds;
+}
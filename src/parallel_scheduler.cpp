@@ -0,0 +1,98 @@
+#include "particlesim/parallel_scheduler.hpp"
+
+using namespace particlesim;
+
+ParallelScheduler::ParallelScheduler(size_t workerCount, size_t arenaSize)
+{
+    if (workerCount == 0)
+        workerCount = std::thread::hardware_concurrency();
+    workerCount_ = workerCount > 0 ? workerCount : 1;
+
+    arenas_.reserve(workerCount_);
+    for (size_t w = 0; w < workerCount_; ++w)
+        arenas_.push_back({core::FrameArena(arenaSize)});
+
+    threads_.reserve(workerCount_ - 1);
+    for (size_t w = 1; w < workerCount_; ++w)
+        threads_.emplace_back([this, w]
+                              { workerLoop(w); });
+}
+
+ParallelScheduler::~ParallelScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeWorkers_.notify_all();
+    for (auto &t : threads_)
+        t.join();
+}
+
+void ParallelScheduler::resetArenas()
+{
+    for (auto &a : arenas_)
+        a.arena.reset();
+}
+
+void ParallelScheduler::parallelFor(size_t count, const RangeTask &task)
+{
+    if (count == 0)
+        return;
+
+    if (workerCount_ == 1)
+    {
+        task(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        pending_ = workerCount_ - 1;
+        ++generation_;
+    }
+    wakeWorkers_.notify_all();
+
+    auto [begin, end] = chunkRange(count, workerCount_, 0);
+    if (begin < end)
+        task(begin, end, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(lock, [this]
+                   { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+void ParallelScheduler::workerLoop(size_t worker)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        const RangeTask *task = nullptr;
+        size_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeWorkers_.wait(lock, [&]
+                              { return stopping_ || generation_ != seen; });
+            if (stopping_)
+                return;
+            seen = generation_;
+            task = task_;
+            count = count_;
+        }
+
+        auto [begin, end] = chunkRange(count, workerCount_, worker);
+        if (begin < end)
+            (*task)(begin, end, worker);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last = (--pending_ == 0);
+        }
+        if (last)
+            workDone_.notify_one();
+    }
+}
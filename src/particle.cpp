@@ -9,6 +9,7 @@ void Particle::reset()
     acceleration = {0.0f, 0.0f};
     lifetime = 0.0f;
     alive = true;
+    updateTier = 1;
 }
 
 void Particle::kill()
@@ -1,6 +1,17 @@
 #include "particlesim/particle_system.hpp"
 #include <sstream>
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <bit>
+
+#if defined(PARTICLESIM_USE_SIMD) && defined(__AVX2__) && (defined(__F16C__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define PARTICLESIM_F16C 1
+#else
+#define PARTICLESIM_F16C 0
+#endif
 
 namespace particlesim
 {
@@ -14,6 +25,7 @@ namespace particlesim
 
     void ParticleSystemDataAoS::update(float dt, bool compact)
     {
+        PARTICLESIM_ZONE(LayoutUpdate);
         auto it = remove_if(particles.begin(), particles.end(), [&](Particle &p)
                             {
         if (!p.alive) 
@@ -35,8 +47,16 @@ namespace particlesim
         return particles.size();
     }
 
+    void ParticleSystemDataAoS::applyAcceleration(span<const Vector2D> acc, float dt)
+    {
+        assert(acc.size() == particles.size());
+        for (size_t i = 0; i < particles.size(); ++i)
+            particles[i].velocity += acc[i] * dt;
+    }
+
     span<const Vector2D> particlesim::ParticleSystemDataAoS::positions()
     {
+        PARTICLESIM_ZONE(Positions);
         const size_t count = particles.size();
 
         if (positionsCache_.size() < count)
@@ -62,10 +82,50 @@ namespace particlesim
         acc.push_back(p.acceleration.x, p.acceleration.y);
         life.push_back(p.lifetime);
         alive.push_back(p.alive ? 1 : 0);
+        counters_.dead += !p.alive;
+
+        const uint8_t tier = bit_floor(max<uint8_t>(p.updateTier, 1));
+        particles.field<Tier>().push_back(tier);
+        maxTier_ = max(maxTier_, tier);
+
+        if (rest_.enabled)
+        {
+            const size_t block = (particles.size() - 1) / BlockSize;
+            if (block < blocks_.size() && blocks_[block].sleeping)
+                flushBlock(block);
+            restFrames_.push_back(0);
+            blocks_.resize(block + 1);
+        }
 
         return particles.size() - 1;
     }
 
+    ParticleSoAView ParticleSystemDataSoA::append(size_t count)
+    {
+        const size_t first = particles.size();
+        if (rest_.enabled)
+        {
+            // the sleeping tail block settles its skipped time before new members join it
+            const size_t block = first / BlockSize;
+            if (block < blocks_.size() && blocks_[block].sleeping)
+                flushBlock(block);
+        }
+
+        particles.resize(first + count);
+        auto &[pos, vel, acc, life, alive] = fields();
+        fill_n(alive.data() + first, count, uint8_t{1});
+        fill_n(particles.field<Tier>().data() + first, count, uint8_t{1});
+
+        if (rest_.enabled)
+        {
+            restFrames_.resize(first + count, 0);
+            blocks_.resize((first + count + BlockSize - 1) / BlockSize);
+        }
+
+        return {pos.x() + first, pos.y() + first, vel.x() + first, vel.y() + first,
+                acc.x() + first, acc.y() + first, life.data() + first, alive.data() + first, count};
+    }
+
     size_t ParticleSystemDataSoA::size() const
     {
         return particles.size();
@@ -73,6 +133,7 @@ namespace particlesim
 
     void ParticleSystemDataSoA::update(float dt, bool compact)
     {
+        PARTICLESIM_ZONE(LayoutUpdate);
         auto &[pos, vel, acc, life, alive] = fields();
 
         const size_t n = particles.size();
@@ -89,31 +150,329 @@ namespace particlesim
         float *life_p = life.data();
         uint8_t *alive_p = reinterpret_cast<uint8_t *>(alive.data());
 
-        for (size_t i = 0; i < n; ++i)
+        if (rest_.enabled)
         {
-            if (alive_p[i] == 0)
-                continue;
+            updateBlocks(dt);
+        }
+        else if (maxTier_ > 1)
+        {
+            updateTiered(dt);
+        }
+        else
+        {
+            size_t died = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (alive_p[i] == 0)
+                    continue;
 
-            float vx = vel_x[i] + acc_x[i] * dt;
-            float vy = vel_y[i] + acc_y[i] * dt;
-            vel_x[i] = vx;
-            vel_y[i] = vy;
+                float vx = vel_x[i] + acc_x[i] * dt;
+                float vy = vel_y[i] + acc_y[i] * dt;
+                vel_x[i] = vx;
+                vel_y[i] = vy;
 
-            pos_x[i] += vx * dt;
-            pos_y[i] += vy * dt;
+                pos_x[i] += vx * dt;
+                pos_y[i] += vy * dt;
 
-            float l = life_p[i] - dt;
-            life_p[i] = l;
-            if (l <= 0.0f)
-                alive_p[i] = 0;
+                float l = life_p[i] - dt;
+                life_p[i] = l;
+                if (l <= 0.0f)
+                {
+                    alive_p[i] = 0;
+                    ++died;
+                }
+            }
+            counters_.deaths += died;
+            counters_.dead += died;
         }
 
+        ++frame_;
         if (compact)
             compactDead();
     }
 
+    void ParticleSystemDataSoA::updateTiered(float dt)
+    {
+        auto &[pos, vel, acc, life, alive] = fields();
+
+        float *pos_x = pos.x();
+        float *pos_y = pos.y();
+        float *vel_x = vel.x();
+        float *vel_y = vel.y();
+        const float *acc_x = acc.x();
+        const float *acc_y = acc.y();
+        float *life_p = life.data();
+        uint8_t *alive_p = reinterpret_cast<uint8_t *>(alive.data());
+        const uint8_t *tier_p = particles.field<Tier>().data();
+
+        const size_t n = particles.size();
+        size_t died = 0;
+        for (size_t begin = 0; begin < n; begin += BlockSize)
+        {
+            const uint32_t phase = frame_ + static_cast<uint32_t>(begin / BlockSize);
+            const size_t end = min(n, begin + BlockSize);
+
+            const uint8_t level = blockLevel(begin / BlockSize, phase);
+            const uint8_t due = dueTier(phase, level);
+
+            // a cache line of tiers decides whether the other columns are touched at all
+            uint8_t minTier = 255;
+            for (size_t i = begin; i < end; ++i)
+                minTier = min(minTier, tier_p[i]);
+            if (minTier > due)
+                continue;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (alive_p[i] == 0 || tier_p[i] > due)
+                    continue;
+
+                const float step = dt * static_cast<float>(stride(tier_p[i], level));
+                float vx = vel_x[i] + acc_x[i] * step;
+                float vy = vel_y[i] + acc_y[i] * step;
+                vel_x[i] = vx;
+                vel_y[i] = vy;
+
+                pos_x[i] += vx * step;
+                pos_y[i] += vy * step;
+
+                float l = life_p[i] - step;
+                life_p[i] = l;
+                if (l <= 0.0f)
+                {
+                    alive_p[i] = 0;
+                    ++died;
+                }
+            }
+        }
+        counters_.deaths += died;
+        counters_.dead += died;
+    }
+
+    void ParticleSystemDataSoA::updateBlocks(float dt)
+    {
+        auto &[pos, vel, acc, life, alive] = fields();
+
+        float *pos_x = pos.x();
+        float *pos_y = pos.y();
+        float *vel_x = vel.x();
+        float *vel_y = vel.y();
+        const float *acc_x = acc.x();
+        const float *acc_y = acc.y();
+        float *life_p = life.data();
+        uint8_t *alive_p = reinterpret_cast<uint8_t *>(alive.data());
+        uint8_t *rest_p = restFrames_.data();
+        const uint8_t *tier_p = particles.field<Tier>().data();
+
+        const size_t n = particles.size();
+        const float speedSq = rest_.sleepSpeed * rest_.sleepSpeed;
+        const float accelSq = rest_.sleepAcceleration * rest_.sleepAcceleration;
+        // 0 would count moving particles as resting, a particle has to be still for one frame at least
+        const uint8_t sleepFrames = max<uint8_t>(rest_.sleepFrames, 1);
+        size_t died = 0;
+
+        for (size_t b = 0; b < blocks_.size(); ++b)
+        {
+            const uint32_t phase = frame_ + static_cast<uint32_t>(b);
+            const uint8_t level = blockLevel(b, phase);
+            const uint8_t due = dueTier(phase, level);
+            BlockState &state = blocks_[b];
+            if (state.sleeping)
+            {
+                state.sleepTime += dt;
+                if (state.sleepTime >= state.minLifetime)
+                    flushBlock(b); // someone's lifetime ran out
+                continue;
+            }
+
+            const size_t begin = b * BlockSize;
+            const size_t end = min(n, begin + BlockSize);
+            uint32_t live = 0;
+            uint32_t resting = 0;
+            float minLifetime = numeric_limits<float>::max();
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (alive_p[i] == 0)
+                    continue;
+
+                if (tier_p[i] > due)
+                {
+                    // not this particle's frame, it keeps its resting state
+                    ++live;
+                    resting += rest_p[i] >= sleepFrames;
+                    minLifetime = min(minLifetime, life_p[i]);
+                    continue;
+                }
+
+                const float step = dt * static_cast<float>(stride(tier_p[i], level));
+                float vx = vel_x[i] + acc_x[i] * step;
+                float vy = vel_y[i] + acc_y[i] * step;
+                vel_x[i] = vx;
+                vel_y[i] = vy;
+
+                pos_x[i] += vx * step;
+                pos_y[i] += vy * step;
+
+                float l = life_p[i] - step;
+                life_p[i] = l;
+                if (l <= 0.0f)
+                {
+                    alive_p[i] = 0;
+                    ++died;
+                    continue;
+                }
+
+                const bool still = vx * vx + vy * vy < speedSq && acc_x[i] * acc_x[i] + acc_y[i] * acc_y[i] < accelSq;
+                const uint8_t frames = still ? static_cast<uint8_t>(min<int>(rest_p[i] + 1, 255)) : 0;
+                rest_p[i] = frames;
+
+                ++live;
+                resting += frames >= sleepFrames;
+                minLifetime = min(minLifetime, l);
+            }
+
+            if (live > 0 && resting == live)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    vel_x[i] = 0.f;
+                    vel_y[i] = 0.f;
+                }
+                state = {true, live, 0.f, minLifetime};
+            }
+        }
+        counters_.deaths += died;
+        counters_.dead += died;
+    }
+
+    void ParticleSystemDataSoA::flushBlock(size_t block)
+    {
+        BlockState &state = blocks_[block];
+        if (!state.sleeping)
+            return;
+
+        auto &life = particles.field<Lifetime>();
+        auto &alive = particles.field<Alive>();
+
+        const size_t begin = block * BlockSize;
+        const size_t end = min(particles.size(), begin + BlockSize);
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (alive[i] == 0)
+                continue;
+
+            life[i] -= state.sleepTime;
+            if (life[i] <= 0.0f)
+            {
+                alive[i] = 0;
+                ++counters_.deaths;
+                ++counters_.dead;
+            }
+        }
+
+        state = {};
+    }
+
+    void ParticleSystemDataSoA::setRestConfig(const RestConfig &cfg)
+    {
+        if (!cfg.enabled)
+        {
+            for (size_t b = 0; b < blocks_.size(); ++b)
+                flushBlock(b);
+            blocks_.clear();
+            restFrames_.clear();
+        }
+        else if (!rest_.enabled)
+        {
+            restFrames_.assign(particles.size(), 0);
+            blocks_.assign((particles.size() + BlockSize - 1) / BlockSize, {});
+        }
+
+        rest_ = cfg;
+    }
+
+    void ParticleSystemDataSoA::wake(span<const uint32_t> ids)
+    {
+        if (!rest_.enabled)
+            return;
+
+        for (uint32_t id : ids)
+        {
+            assert(id < particles.size());
+            restFrames_[id] = 0;
+            flushBlock(id / BlockSize);
+        }
+    }
+
+    size_t ParticleSystemDataSoA::sleepingCount() const
+    {
+        size_t count = 0;
+        for (const BlockState &state : blocks_)
+        {
+            if (state.sleeping)
+                count += state.sleepers;
+        }
+        return count;
+    }
+
+    void ParticleSystemDataSoA::applyAcceleration(span<const Vector2D> acc, float dt)
+    {
+        auto &vel = particles.field<Velocity>();
+        assert(acc.size() == vel.size());
+
+        float *vel_x = vel.x();
+        float *vel_y = vel.y();
+
+        if (!rest_.enabled)
+        {
+            for (size_t i = 0; i < acc.size(); ++i)
+            {
+                vel_x[i] += acc[i].x * dt;
+                vel_y[i] += acc[i].y * dt;
+            }
+            return;
+        }
+
+        const float accelSq = rest_.sleepAcceleration * rest_.sleepAcceleration;
+        for (size_t b = 0; b < blocks_.size(); ++b)
+        {
+            const size_t begin = b * BlockSize;
+            const size_t end = min(acc.size(), begin + BlockSize);
+
+            if (blocks_[b].sleeping)
+            {
+                bool pushed = false;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (acc[i].x * acc[i].x + acc[i].y * acc[i].y >= accelSq)
+                    {
+                        restFrames_[i] = 0;
+                        pushed = true;
+                    }
+                }
+                if (!pushed)
+                    continue;
+                flushBlock(b);
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                vel_x[i] += acc[i].x * dt;
+                vel_y[i] += acc[i].y * dt;
+            }
+        }
+    }
+
+    ParticleSoAView ParticleSystemDataSoA::view()
+    {
+        auto &[pos, vel, acc, life, alive] = fields();
+        return {pos.x(), pos.y(), vel.x(), vel.y(), acc.x(), acc.y(), life.data(), alive.data(), particles.size()};
+    }
+
     span<const Vector2D> ParticleSystemDataSoA::positions()
     {
+        PARTICLESIM_ZONE(Positions);
         auto &[pos, vel, acc, life, alive] = fields();
         const size_t count = pos.size();
 
@@ -126,9 +485,38 @@ namespace particlesim
         return {positionsCache_.data(), count};
     }
 
+    ParticleSoA &ParticleSystemDataSoA::columns()
+    {
+        for (size_t b = 0; b < blocks_.size(); ++b)
+            flushBlock(b);
+        return particles;
+    }
+
+    void ParticleSystemDataSoA::columnsReplaced()
+    {
+        const size_t n = particles.size();
+        const uint8_t *tier = particles.field<Tier>().data();
+        const auto *alive = particles.field<Alive>().data();
+        maxTier_ = 1;
+        counters_.dead = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            maxTier_ = max(maxTier_, tier[i]);
+            counters_.dead += alive[i] == 0;
+        }
+
+        if (rest_.enabled)
+        {
+            restFrames_.assign(n, 0);
+            blocks_.assign((n + BlockSize - 1) / BlockSize, {});
+        }
+    }
+
     void ParticleSystemDataSoA::compactDead()
     {
+        PARTICLESIM_ZONE(CompactDead);
         auto &[pos, vel, acc, life, alive] = fields();
+        auto &tier = particles.field<Tier>();
 
         size_t n = particles.size();
         size_t i = 0;
@@ -141,6 +529,14 @@ namespace particlesim
 
                 if (i != last)
                 {
+                    // skipped time is tracked per block, settle it before a particle changes blocks
+                    if (rest_.enabled)
+                    {
+                        flushBlock(i / BlockSize);
+                        flushBlock(last / BlockSize);
+                        restFrames_[i] = restFrames_[last];
+                    }
+
                     for (int8_t k = 0; k < 2; ++k)
                     {
                         pos.storage[k][i] = pos.storage[k][last];
@@ -149,6 +545,8 @@ namespace particlesim
                     }
                     life.storage[0][i] = life.storage[0][last];
                     alive.storage[0][i] = alive.storage[0][last];
+                    tier.storage[0][i] = tier.storage[0][last];
+                    ++counters_.compactionMoves;
                 }
 
                 for (int8_t k = 0; k < 2; ++k)
@@ -159,6 +557,142 @@ namespace particlesim
                 }
                 life.storage[0].pop_back();
                 alive.storage[0].pop_back();
+                tier.storage[0].pop_back();
+
+                --n;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        counters_.dead = 0;
+        if (rest_.enabled)
+        {
+            restFrames_.resize(n);
+            blocks_.resize((n + BlockSize - 1) / BlockSize);
+        }
+    }
+    ParticleSystemDataBallistic::ParticleSystemDataBallistic(size_t capacity)
+    {
+        particles.reserve(capacity);
+    }
+
+    size_t ParticleSystemDataBallistic::add(const Particle &p)
+    {
+        auto &[pos, vel, acc, spawn, death] = fields();
+
+        pos.push_back(p.position.x, p.position.y);
+        vel.push_back(p.velocity.x, p.velocity.y);
+        acc.push_back(p.acceleration.x, p.acceleration.y);
+        const float now = localTime();
+        spawn.push_back(now);
+        death.push_back(p.alive ? now + p.lifetime : now);
+
+        return particles.size() - 1;
+    }
+
+    size_t ParticleSystemDataBallistic::size() const
+    {
+        return particles.size();
+    }
+
+    void ParticleSystemDataBallistic::update(float dt, bool compact)
+    {
+        PARTICLESIM_ZONE(LayoutUpdate);
+        time_ += dt;
+        if (localTime() >= RebaseInterval)
+            rebase();
+
+        if (compact)
+            compactDead();
+    }
+
+    void ParticleSystemDataBallistic::rebase()
+    {
+        // subtracting RebaseInterval is exact for times of at least RebaseInterval / 2, which covers
+        // every live death time as they lie past the current one. Older spawn times round to the
+        // precision of their new negative value, i.e. of the particle's age, not of its death
+        auto &[pos, vel, acc, spawn, death] = fields();
+        float *spawn_p = spawn.data();
+        float *death_p = death.data();
+        for (size_t i = 0; i < particles.size(); ++i)
+        {
+            spawn_p[i] -= RebaseInterval;
+            death_p[i] -= RebaseInterval;
+        }
+        epoch_ += RebaseInterval;
+    }
+
+    span<const Vector2D> ParticleSystemDataBallistic::positions()
+    {
+        PARTICLESIM_ZONE(Positions);
+        auto &[pos, vel, acc, spawn, death] = fields();
+        const size_t count = particles.size();
+
+        if (positionsCache_.size() < count)
+            positionsCache_.resize(count);
+
+        const float *p0x = pos.x();
+        const float *p0y = pos.y();
+        const float *v0x = vel.x();
+        const float *v0y = vel.y();
+        const float *ax = acc.x();
+        const float *ay = acc.y();
+        const float *spawn_p = spawn.data();
+        const float *death_p = death.data();
+        Vector2D *out = positionsCache_.data();
+        const float now = localTime();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // dead particles stay where they died
+            const float end = death_p[i] < now ? death_p[i] : now;
+            const float t = end - spawn_p[i];
+            const float ht2 = 0.5f * t * t;
+            out[i] = Vector2D(p0x[i] + v0x[i] * t + ax[i] * ht2,
+                              p0y[i] + v0y[i] * t + ay[i] * ht2);
+        }
+
+        return {positionsCache_.data(), count};
+    }
+
+    void ParticleSystemDataBallistic::compactDead()
+    {
+        PARTICLESIM_ZONE(CompactDead);
+        auto &[pos, vel, acc, spawn, death] = fields();
+
+        size_t n = particles.size();
+        size_t i = 0;
+        const float now = localTime();
+
+        while (i < n)
+        {
+            if (death[i] <= now)
+            {
+                size_t last = n - 1;
+
+                if (i != last)
+                {
+                    for (int8_t k = 0; k < 2; ++k)
+                    {
+                        pos.storage[k][i] = pos.storage[k][last];
+                        vel.storage[k][i] = vel.storage[k][last];
+                        acc.storage[k][i] = acc.storage[k][last];
+                    }
+                    spawn.storage[0][i] = spawn.storage[0][last];
+                    death.storage[0][i] = death.storage[0][last];
+                }
+
+                for (int8_t k = 0; k < 2; ++k)
+                {
+                    pos.storage[k].pop_back();
+                    vel.storage[k].pop_back();
+                    acc.storage[k].pop_back();
+                }
+                spawn.storage[0].pop_back();
+                death.storage[0].pop_back();
 
                 --n;
             }
@@ -168,6 +702,449 @@ namespace particlesim
             }
         }
     }
+
+    ParticleSystemDataCohort::ParticleSystemDataCohort(size_t capacity, float cohortTolerance)
+        : tolerance_(cohortTolerance)
+    {
+        size_t ring = 1;
+        while (ring < capacity)
+            ring <<= 1;
+        mask_ = ring - 1;
+        particles.resize(ring);
+    }
+
+    size_t ParticleSystemDataCohort::add(const Particle &p)
+    {
+        if (size_ == mask_ + 1)
+            return INVALID_INDEX;
+
+        auto &[pos, vel, acc, death] = fields();
+        const size_t slot = (head_ + size_) & mask_;
+        const float now = localTime();
+        const float dies = p.alive ? now + p.lifetime : now;
+
+        pos.x()[slot] = p.position.x;
+        pos.y()[slot] = p.position.y;
+        vel.x()[slot] = p.velocity.x;
+        vel.y()[slot] = p.velocity.y;
+        acc.x()[slot] = p.acceleration.x;
+        acc.y()[slot] = p.acceleration.y;
+        death[slot] = dies;
+
+        Cohort *last = cohorts_.empty() ? nullptr : &cohorts_.back();
+        if (last && joins(*last, dies, dies))
+        {
+            ++last->count;
+            last->minDeath = min(last->minDeath, dies);
+            last->maxDeath = max(last->maxDeath, dies);
+        }
+        else
+        {
+            cohorts_.push_back({slot, 1, dies, dies});
+        }
+
+        return size_++;
+    }
+
+    void ParticleSystemDataCohort::integrate(size_t begin, size_t end, float dt, bool checkDeath)
+    {
+        auto &[pos, vel, acc, death] = fields();
+
+        float *pos_x = pos.x();
+        float *pos_y = pos.y();
+        float *vel_x = vel.x();
+        float *vel_y = vel.y();
+        const float *acc_x = acc.x();
+        const float *acc_y = acc.y();
+        const float *death_p = death.data();
+        const float now = localTime();
+
+        if (!checkDeath)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                float vx = vel_x[i] + acc_x[i] * dt;
+                float vy = vel_y[i] + acc_y[i] * dt;
+                vel_x[i] = vx;
+                vel_y[i] = vy;
+                pos_x[i] += vx * dt;
+                pos_y[i] += vy * dt;
+            }
+            return;
+        }
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (death_p[i] <= now)
+                continue;
+
+            float vx = vel_x[i] + acc_x[i] * dt;
+            float vy = vel_y[i] + acc_y[i] * dt;
+            vel_x[i] = vx;
+            vel_y[i] = vy;
+            pos_x[i] += vx * dt;
+            pos_y[i] += vy * dt;
+        }
+    }
+
+    void ParticleSystemDataCohort::update(float dt, bool compact)
+    {
+        PARTICLESIM_ZONE(LayoutUpdate);
+        const size_t ring = mask_ + 1;
+        const float now = localTime();
+
+        for (const Cohort &c : cohorts_)
+        {
+            // whole cohort expired - nothing to integrate
+            if (c.maxDeath <= now)
+                continue;
+
+            const bool checkDeath = c.minDeath <= now;
+            const size_t end = c.begin + c.count;
+            if (end <= ring)
+            {
+                integrate(c.begin, end, dt, checkDeath);
+            }
+            else
+            {
+                integrate(c.begin, ring, dt, checkDeath);
+                integrate(0, end - ring, dt, checkDeath);
+            }
+        }
+
+        time_ += dt;
+        if (localTime() >= RebaseInterval)
+            rebase();
+
+        if (compact)
+            compactDead();
+    }
+
+    void ParticleSystemDataCohort::rebase()
+    {
+        // exact for the deaths of live particles, which lie past the current time and so at or above
+        // RebaseInterval; only deaths already passed may round
+        float *death = particles.field<DeathTime>().data();
+        for (size_t i = 0; i < size_; ++i)
+            death[(head_ + i) & mask_] -= RebaseInterval;
+        for (Cohort &c : cohorts_)
+        {
+            c.minDeath -= RebaseInterval;
+            c.maxDeath -= RebaseInterval;
+        }
+        epoch_ += RebaseInterval;
+    }
+
+    void ParticleSystemDataCohort::compactDead()
+    {
+        PARTICLESIM_ZONE(CompactDead);
+        const float now = localTime();
+
+        // expired cohorts at the front only move the head
+        while (!cohorts_.empty() && cohorts_.front().maxDeath <= now)
+        {
+            head_ = (head_ + cohorts_.front().count) & mask_;
+            size_ -= cohorts_.front().count;
+            cohorts_.pop_front();
+        }
+
+        auto &[pos, vel, acc, death] = fields();
+        float *death_p = death.data();
+
+        // the rest in ring order: whole expired cohorts are dropped, partly expired ones keep their
+        // live particles, and everything behind a gap slides down to close it
+        size_t read = 0;  // logical index of the cohort being read
+        size_t write = 0; // logical index its first kept particle goes to
+        size_t kept = 0;
+        for (size_t i = 0; i < cohorts_.size(); ++i)
+        {
+            const Cohort c = cohorts_[i];
+            const size_t begin = read;
+            read += c.count;
+            if (c.maxDeath <= now)
+                continue;
+
+            Cohort out = c;
+            if (c.minDeath <= now || begin != write)
+            {
+                // bounds start inverted and narrow to the deaths of the particles kept
+                out = {(head_ + write) & mask_, 0, c.maxDeath, c.minDeath};
+                for (size_t k = begin; k < begin + c.count; ++k)
+                {
+                    const size_t from = (head_ + k) & mask_;
+                    if (death_p[from] <= now)
+                        continue;
+
+                    const size_t to = (head_ + write + out.count) & mask_;
+                    if (from != to)
+                    {
+                        pos.x()[to] = pos.x()[from];
+                        pos.y()[to] = pos.y()[from];
+                        vel.x()[to] = vel.x()[from];
+                        vel.y()[to] = vel.y()[from];
+                        acc.x()[to] = acc.x()[from];
+                        acc.y()[to] = acc.y()[from];
+                        death_p[to] = death_p[from];
+                    }
+                    out.minDeath = min(out.minDeath, death_p[from]);
+                    out.maxDeath = max(out.maxDeath, death_p[from]);
+                    ++out.count;
+                }
+            }
+            write += out.count;
+
+            // cohorts thinned by deaths merge back under the add() rule
+            Cohort *previous = kept ? &cohorts_[kept - 1] : nullptr;
+            if (previous && joins(*previous, out.minDeath, out.maxDeath))
+            {
+                previous->count += out.count;
+                previous->minDeath = min(previous->minDeath, out.minDeath);
+                previous->maxDeath = max(previous->maxDeath, out.maxDeath);
+            }
+            else
+            {
+                cohorts_[kept++] = out;
+            }
+        }
+        cohorts_.resize(kept);
+        size_ = write;
+    }
+
+    span<const Vector2D> ParticleSystemDataCohort::positions()
+    {
+        PARTICLESIM_ZONE(Positions);
+        auto &[pos, vel, acc, death] = fields();
+
+        if (positionsCache_.size() < size_)
+            positionsCache_.resize(size_);
+
+        const float *pos_x = pos.x();
+        const float *pos_y = pos.y();
+        const size_t ring = mask_ + 1;
+        const size_t firstRun = min(size_, ring - head_);
+
+        for (size_t i = 0; i < firstRun; ++i)
+            positionsCache_[i] = Vector2D(pos_x[head_ + i], pos_y[head_ + i]);
+        for (size_t i = firstRun; i < size_; ++i)
+            positionsCache_[i] = Vector2D(pos_x[i - firstRun], pos_y[i - firstRun]);
+
+        return {positionsCache_.data(), size_};
+    }
+
+    namespace
+    {
+        // floor to a fixed-point step, saturating at the ends of the range
+        inline uint16_t toFixed(float steps)
+        {
+            return static_cast<uint16_t>(clamp(floor(steps), 0.f, 65535.f));
+        }
+
+        // per-particle rounding offsets in [0, 1) that change every frame
+        inline uint32_t ditherHash(uint32_t i, uint32_t frameTerm) { return i * 0x9E3779B1u + frameTerm; }
+        inline float ditherX(uint32_t h) { return static_cast<float>(h >> 8) * (1.f / 16777216.f); }
+        inline float ditherY(uint32_t h) { return static_cast<float>((h * 0xC2B2AE3Du) >> 8) * (1.f / 16777216.f); }
+    }
+
+    ParticleSystemDataQuantized::ParticleSystemDataQuantized(size_t capacity, const WorldBounds &world, float lifetimeQuantum)
+        : world_(world), stepX_(world.width() / 65535.f), stepY_(world.height() / 65535.f), quantum_(lifetimeQuantum)
+    {
+        assert(world.width() > 0.f && world.height() > 0.f && lifetimeQuantum > 0.f);
+        particles.reserve(capacity);
+    }
+
+    size_t ParticleSystemDataQuantized::add(const Particle &p)
+    {
+        auto &[pos, vel, acc, life] = fields();
+
+        pos.push_back(toFixed((p.position.x - world_.minX) / stepX_ + 0.5f),
+                      toFixed((p.position.y - world_.minY) / stepY_ + 0.5f));
+        vel.push_back(floatToHalf(p.velocity.x), floatToHalf(p.velocity.y));
+        acc.push_back(floatToHalf(p.acceleration.x), floatToHalf(p.acceleration.y));
+
+        // any positive lifetime keeps at least one tick
+        uint16_t ticks = 0;
+        if (p.alive && p.lifetime > 0.f)
+            ticks = static_cast<uint16_t>(min(ceil(p.lifetime / quantum_), 65535.f));
+        life.push_back(ticks);
+
+        return particles.size() - 1;
+    }
+
+    size_t ParticleSystemDataQuantized::size() const
+    {
+        return particles.size();
+    }
+
+    void ParticleSystemDataQuantized::update(float dt, bool compact)
+    {
+        PARTICLESIM_ZONE(LayoutUpdate);
+        auto &[pos, vel, acc, life] = fields();
+
+        // ticks crossed this frame, the same for every particle
+        const uint64_t before = static_cast<uint64_t>(clock_ / quantum_);
+        clock_ += dt;
+        const uint64_t after = static_cast<uint64_t>(clock_ / quantum_);
+        const uint16_t elapsed = static_cast<uint16_t>(min<uint64_t>(after - before, 65535));
+
+        const size_t n = particles.size();
+        const uint32_t frameTerm = frame_++ * 0x85EBCA77u;
+        if (n == 0)
+            return;
+
+        uint16_t *pos_x = pos.x();
+        uint16_t *pos_y = pos.y();
+        uint16_t *vel_x = vel.x();
+        uint16_t *vel_y = vel.y();
+        const uint16_t *acc_x = acc.x();
+        const uint16_t *acc_y = acc.y();
+        uint16_t *life_p = life.data();
+
+        // velocity in fixed-point steps per second
+        const float dtX = dt / stepX_;
+        const float dtY = dt / stepY_;
+
+        size_t i = 0;
+#if PARTICLESIM_F16C
+        {
+            const __m256 dtv = _mm256_set1_ps(dt);
+            const __m256 dtXv = _mm256_set1_ps(dtX);
+            const __m256 dtYv = _mm256_set1_ps(dtY);
+            const __m256 lo = _mm256_setzero_ps();
+            const __m256 hi = _mm256_set1_ps(65535.f);
+            const __m256 ditherScale = _mm256_set1_ps(1.f / 16777216.f);
+            const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i mulX = _mm256_set1_epi32(static_cast<int>(0x9E3779B1u));
+            const __m256i mulY = _mm256_set1_epi32(static_cast<int>(0xC2B2AE3Du));
+            const __m256i frameV = _mm256_set1_epi32(static_cast<int>(frameTerm));
+            const __m128i elapsedV = _mm_set1_epi16(static_cast<short>(elapsed));
+            const __m128i zero16 = _mm_setzero_si128();
+
+            auto load = [](const uint16_t *p)
+            { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); };
+            auto store = [](uint16_t *p, __m128i v)
+            { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); };
+            auto pack = [](__m256 steps)
+            {
+                const __m256i q = _mm256_cvttps_epi32(steps);
+                return _mm_packus_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+            };
+
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m128i ticks = load(life_p + i);
+                const __m128i dead = _mm_cmpeq_epi16(ticks, zero16);
+                if (_mm_movemask_epi8(dead) == 0xffff)
+                    continue;
+
+                const __m128i oldVx = load(vel_x + i);
+                const __m128i oldVy = load(vel_y + i);
+                const __m256 vx = _mm256_add_ps(_mm256_cvtph_ps(oldVx), _mm256_mul_ps(_mm256_cvtph_ps(load(acc_x + i)), dtv));
+                const __m256 vy = _mm256_add_ps(_mm256_cvtph_ps(oldVy), _mm256_mul_ps(_mm256_cvtph_ps(load(acc_y + i)), dtv));
+                store(vel_x + i, _mm_blendv_epi8(_mm256_cvtps_ph(vx, _MM_FROUND_TO_NEAREST_INT), oldVx, dead));
+                store(vel_y + i, _mm_blendv_epi8(_mm256_cvtps_ph(vy, _MM_FROUND_TO_NEAREST_INT), oldVy, dead));
+
+                const __m256i h = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lane), mulX), frameV);
+                const __m256 rx = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(h, 8)), ditherScale);
+                const __m256 ry = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(_mm256_mullo_epi32(h, mulY), 8)), ditherScale);
+
+                const __m128i oldPx = load(pos_x + i);
+                const __m128i oldPy = load(pos_y + i);
+                __m256 px = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(oldPx));
+                __m256 py = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(oldPy));
+                px = _mm256_floor_ps(_mm256_add_ps(_mm256_add_ps(px, _mm256_mul_ps(vx, dtXv)), rx));
+                py = _mm256_floor_ps(_mm256_add_ps(_mm256_add_ps(py, _mm256_mul_ps(vy, dtYv)), ry));
+                px = _mm256_min_ps(_mm256_max_ps(px, lo), hi);
+                py = _mm256_min_ps(_mm256_max_ps(py, lo), hi);
+                store(pos_x + i, _mm_blendv_epi8(pack(px), oldPx, dead));
+                store(pos_y + i, _mm_blendv_epi8(pack(py), oldPy, dead));
+
+                store(life_p + i, _mm_subs_epu16(ticks, elapsedV));
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            const uint16_t ticks = life_p[i];
+            if (ticks == 0)
+                continue;
+
+            const float vx = halfToFloat(vel_x[i]) + halfToFloat(acc_x[i]) * dt;
+            const float vy = halfToFloat(vel_y[i]) + halfToFloat(acc_y[i]) * dt;
+            vel_x[i] = floatToHalf(vx);
+            vel_y[i] = floatToHalf(vy);
+
+            const uint32_t h = ditherHash(static_cast<uint32_t>(i), frameTerm);
+            pos_x[i] = toFixed(static_cast<float>(pos_x[i]) + vx * dtX + ditherX(h));
+            pos_y[i] = toFixed(static_cast<float>(pos_y[i]) + vy * dtY + ditherY(h));
+
+            life_p[i] = ticks > elapsed ? static_cast<uint16_t>(ticks - elapsed) : 0;
+        }
+
+        if (compact)
+            compactDead();
+    }
+
+    span<const Vector2D> ParticleSystemDataQuantized::positions()
+    {
+        PARTICLESIM_ZONE(Positions);
+        auto &[pos, vel, acc, life] = fields();
+        const size_t count = particles.size();
+
+        if (positionsCache_.size() < count)
+            positionsCache_.resize(count);
+
+        const uint16_t *pos_x = pos.x();
+        const uint16_t *pos_y = pos.y();
+        for (size_t i = 0; i < count; ++i)
+            positionsCache_[i] = Vector2D(world_.minX + static_cast<float>(pos_x[i]) * stepX_,
+                                          world_.minY + static_cast<float>(pos_y[i]) * stepY_);
+
+        return {positionsCache_.data(), count};
+    }
+
+    void ParticleSystemDataQuantized::compactDead()
+    {
+        PARTICLESIM_ZONE(CompactDead);
+        auto &[pos, vel, acc, life] = fields();
+
+        size_t n = particles.size();
+        size_t i = 0;
+
+        while (i < n)
+        {
+            if (life[i] == 0)
+            {
+                size_t last = n - 1;
+
+                if (i != last)
+                {
+                    for (int8_t k = 0; k < 2; ++k)
+                    {
+                        pos.storage[k][i] = pos.storage[k][last];
+                        vel.storage[k][i] = vel.storage[k][last];
+                        acc.storage[k][i] = acc.storage[k][last];
+                    }
+                    life.storage[0][i] = life.storage[0][last];
+                }
+
+                for (int8_t k = 0; k < 2; ++k)
+                {
+                    pos.storage[k].pop_back();
+                    vel.storage[k].pop_back();
+                    acc.storage[k].pop_back();
+                }
+                life.storage[0].pop_back();
+
+                --n;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
     size_t ParticleSystemDataAllocated::add(const Particle &p)
     {
         size_t index = pool_.allocate();
@@ -175,33 +1152,74 @@ namespace particlesim
             return INVALID_INDEX;
 
         pool_.get(index) = p;
+        activeSlot_[index] = activeIndices_.size();
         activeIndices_.push_back(index);
+
+        if (!p.alive)
+        {
+            deathTime_[index] = time_;
+            pendingFree_.push_back(index);
+            ++counters_.dead;
+            return index;
+        }
+
+        // every live particle is integrated at least once, like Particle::update
+        deathTime_[index] = time_ + p.lifetime;
+        const uint64_t tick = static_cast<uint64_t>(ceil(deathTime_[index] / resolution_));
+        expiry_.schedule(max(tick, expiry_.now() + 1), index);
         return index;
     }
 
+    void ParticleSystemDataAllocated::release(size_t index)
+    {
+        const size_t slot = activeSlot_[index];
+        const size_t last = activeIndices_.back();
+        counters_.compactionMoves += slot + 1 != activeIndices_.size();
+        activeIndices_[slot] = last;
+        activeSlot_[last] = slot;
+        activeIndices_.pop_back();
+        activeSlot_[index] = INVALID_INDEX;
+        pool_.deallocate(index);
+    }
+
     void ParticleSystemDataAllocated::update(float dt, bool /*compact*/)
     {
-        for (size_t i = 0; i < activeIndices_.size();)
+        PARTICLESIM_ZONE(LayoutUpdate);
+        for (size_t index : expired_)
+            release(index);
+        for (size_t index : pendingFree_)
+            release(index);
+        expired_.clear();
+        pendingFree_.clear();
+        counters_.dead = 0;
+
+        for (size_t index : activeIndices_)
         {
-            size_t index = activeIndices_[i];
             Particle &p = pool_.get(index);
-
-            if (!p.alive)
-            {
-                pool_.deallocate(index);
-                activeIndices_[i] = activeIndices_.back();
-                activeIndices_.pop_back();
-            }
-            else
-            {
-                ++i;
-                p.update(dt);
-            }
+            p.velocity += p.acceleration * dt;
+            p.position += p.velocity * dt;
         }
+
+        time_ += dt;
+        const uint64_t now = static_cast<uint64_t>(floor(time_ / resolution_));
+        expiry_.advance(now, [&](size_t index, uint64_t)
+                        {
+            pool_.get(index).alive = false;
+            expired_.push_back(index); });
+        counters_.deaths += expired_.size();
+        counters_.dead = expired_.size();
+    }
+
+    void ParticleSystemDataAllocated::applyAcceleration(span<const Vector2D> acc, float dt)
+    {
+        assert(acc.size() == activeIndices_.size());
+        for (size_t i = 0; i < activeIndices_.size(); ++i)
+            pool_.get(activeIndices_[i]).velocity += acc[i] * dt;
     }
 
     span<const Vector2D> ParticleSystemDataAllocated::positions()
     {
+        PARTICLESIM_ZONE(Positions);
         const size_t count = activeIndices_.size();
 
         if (positionsCache_.size() < count)
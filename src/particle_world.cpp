@@ -0,0 +1,145 @@
+#include "particlesim/particle_world.hpp"
+#include "particlesim/profiling.hpp"
+#include <cassert>
+
+using namespace particlesim;
+
+ParticleWorld::ParticleWorld(size_t capacity, PageBacking backing, ParallelScheduler *placement)
+{
+    particles.setPageBacking(backing);
+    particles.reserve(capacity);
+
+    if (placement)
+    {
+        particles.forEachColumn([&](auto *column, size_t n)
+                                { placement->firstTouch(column, n); });
+    }
+}
+
+EmitterID ParticleWorld::createEmitter(size_t capacity, const EmitterParams &params)
+{
+    const size_t begin = particles.size();
+    assert(begin + capacity <= UINT32_MAX);
+
+    particles.resize(begin + capacity);
+    emitters.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(capacity), 0, params});
+    return static_cast<EmitterID>(emitters.size() - 1);
+}
+
+size_t ParticleWorld::add(EmitterID id, const Particle &p)
+{
+    Emitter &e = emitters[id];
+    if (e.count == e.capacity)
+        return INVALID_INDEX;
+
+    auto &[pos, vel, acc, life, alive] = fields();
+    const size_t slot = e.begin + e.count;
+
+    pos.x()[slot] = p.position.x;
+    pos.y()[slot] = p.position.y;
+    vel.x()[slot] = p.velocity.x;
+    vel.y()[slot] = p.velocity.y;
+    acc.x()[slot] = p.acceleration.x;
+    acc.y()[slot] = p.acceleration.y;
+    life[slot] = p.lifetime;
+    alive[slot] = p.alive ? 1 : 0;
+
+    return e.count++;
+}
+
+size_t ParticleWorld::size() const
+{
+    size_t total = 0;
+    for (const Emitter &e : emitters)
+        total += e.count;
+    return total;
+}
+
+void ParticleWorld::update(float dt, bool compact, ParallelScheduler *scheduler)
+{
+    PARTICLESIM_ZONE(LayoutUpdate);
+    if (!scheduler)
+    {
+        for (Emitter &e : emitters)
+            updateEmitter(e, dt, compact);
+        return;
+    }
+
+    scheduler->parallelFor(emitters.size(), [&](size_t begin, size_t end, size_t)
+                           {
+        for (size_t i = begin; i < end; ++i)
+            updateEmitter(emitters[i], dt, compact); });
+}
+
+void ParticleWorld::updateEmitter(Emitter &e, float dt, bool compact)
+{
+    auto &[pos, vel, acc, life, alive] = fields();
+
+    const size_t begin = e.begin;
+    const size_t end = e.begin + e.count;
+
+    float *pos_x = pos.x();
+    float *pos_y = pos.y();
+    float *vel_x = vel.x();
+    float *vel_y = vel.y();
+    const float *acc_x = acc.x();
+    const float *acc_y = acc.y();
+    float *life_p = life.data();
+    uint8_t *alive_p = alive.data();
+
+    // gathered once per range
+    const float gx = e.params.gravity.x;
+    const float gy = e.params.gravity.y;
+    const float drag = e.params.drag;
+
+    // branch free so the range vectorizes - dead particles take a zero step
+    for (size_t i = begin; i < end; ++i)
+    {
+        const float step = alive_p[i] ? dt : 0.0f;
+
+        float vx = vel_x[i] + (acc_x[i] + gx - drag * vel_x[i]) * step;
+        float vy = vel_y[i] + (acc_y[i] + gy - drag * vel_y[i]) * step;
+        vel_x[i] = vx;
+        vel_y[i] = vy;
+
+        pos_x[i] += vx * step;
+        pos_y[i] += vy * step;
+
+        float l = life_p[i] - step;
+        life_p[i] = l;
+        alive_p[i] = static_cast<uint8_t>(alive_p[i] & (l > 0.0f));
+    }
+
+    if (!compact)
+        return;
+
+    // swap-remove inside the range
+    size_t n = end;
+    size_t i = begin;
+    while (i < n)
+    {
+        if (alive_p[i])
+        {
+            ++i;
+            continue;
+        }
+
+        const size_t last = --n;
+        pos_x[i] = pos_x[last];
+        pos_y[i] = pos_y[last];
+        vel_x[i] = vel_x[last];
+        vel_y[i] = vel_y[last];
+        acc.x()[i] = acc_x[last];
+        acc.y()[i] = acc_y[last];
+        life_p[i] = life_p[last];
+        alive_p[i] = alive_p[last];
+    }
+    e.count = static_cast<uint32_t>(n - begin);
+}
+
+ParticleSoAView ParticleWorld::view(EmitterID id)
+{
+    auto &[pos, vel, acc, life, alive] = fields();
+    const size_t b = emitters[id].begin;
+    return {pos.x() + b, pos.y() + b, vel.x() + b, vel.y() + b, acc.x() + b, acc.y() + b, life.data() + b, alive.data() + b, emitters[id].count};
+}
@@ -0,0 +1,140 @@
+#include "particlesim/profiling.hpp"
+
+using namespace particlesim;
+
+const char *particlesim::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::LayoutUpdate:
+        return "LayoutUpdate";
+    case Stage::CompactDead:
+        return "CompactDead";
+    case Stage::Positions:
+        return "Positions";
+    case Stage::PartitionBuild:
+        return "PartitionBuild";
+    case Stage::PartitionQuery:
+        return "PartitionQuery";
+    case Stage::Interactions:
+        return "Interactions";
+    case Stage::Collisions:
+        return "Collisions";
+    case Stage::Export:
+        return "Export";
+    case Stage::Count:
+        break;
+    }
+    return "?";
+}
+
+FrameProfiler &FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::ThreadStages &FrameProfiler::local()
+{
+    // gives the set back when the thread exits, whatever it still holds is folded by the next endFrame()
+    struct Owner
+    {
+        ThreadStages *stages = nullptr;
+        ~Owner()
+        {
+            if (stages)
+                stages->inUse.store(false, std::memory_order_release);
+        }
+    };
+    thread_local Owner mine;
+    if (!mine.stages)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &t : threads_)
+        {
+            if (!t->inUse.load(std::memory_order_acquire))
+            {
+                t->inUse.store(true, std::memory_order_relaxed);
+                mine.stages = t.get();
+                break;
+            }
+        }
+        if (!mine.stages)
+        {
+            threads_.push_back(std::make_unique<ThreadStages>());
+            mine.stages = threads_.back().get();
+        }
+    }
+    return *mine.stages;
+}
+
+void FrameProfiler::addStage(Stage stage, uint64_t nanoseconds)
+{
+    // uncontended, only endFrame() touches another thread's counters
+    ThreadStages &t = local();
+    const size_t s = static_cast<size_t>(stage);
+    t.nanoseconds[s].fetch_add(nanoseconds, std::memory_order_relaxed);
+    t.calls[s].fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameProfiler::endFrame(uint64_t frameNanoseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameStats stats;
+    stats.frame = frames_;
+    stats.frameNanoseconds = frameNanoseconds;
+    for (const auto &t : threads_)
+    {
+        for (size_t s = 0; s < StageCount; ++s)
+        {
+            stats.nanoseconds[s] += t->nanoseconds[s].exchange(0, std::memory_order_relaxed);
+            stats.calls[s] += t->calls[s].exchange(0, std::memory_order_relaxed);
+        }
+    }
+    history_[frames_ % HistorySize] = stats;
+    ++frames_;
+}
+
+uint64_t FrameProfiler::frameCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_;
+}
+
+FrameStats FrameProfiler::latest() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_ ? history_[(frames_ - 1) % HistorySize] : FrameStats{};
+}
+
+std::vector<FrameStats> FrameProfiler::history() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t count = frames_ < HistorySize ? frames_ : HistorySize;
+    std::vector<FrameStats> out;
+    out.reserve(count);
+    for (uint64_t f = frames_ - count; f < frames_; ++f)
+        out.push_back(history_[f % HistorySize]);
+    return out;
+}
+
+void FrameProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &t : threads_)
+    {
+        for (size_t s = 0; s < StageCount; ++s)
+        {
+            t->nanoseconds[s].store(0, std::memory_order_relaxed);
+            t->calls[s].store(0, std::memory_order_relaxed);
+        }
+    }
+    history_ = {};
+    frames_ = 0;
+}
+
+size_t FrameProfiler::threadCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+}
@@ -0,0 +1,54 @@
+#include "particlesim/publisher.hpp"
+#include <algorithm>
+
+using namespace particlesim;
+
+FramePublisher::FramePublisher(size_t capacity)
+{
+    frames_.forEach([capacity](PublishedFrame &f)
+                    {
+                        f.posX.reserve(capacity);
+                        f.posY.reserve(capacity);
+                        f.lifetime.reserve(capacity);
+                        f.alive.reserve(capacity);
+                    });
+}
+
+void FramePublisher::publish(const ParticleSoAView &frame)
+{
+    PublishedFrame &f = frames_.back();
+    const size_t n = frame.count;
+    f.index = published_.load(std::memory_order_relaxed);
+    f.posX.assign(frame.posX, frame.posX + n);
+    f.posY.assign(frame.posY, frame.posY + n);
+    f.lifetime.assign(frame.lifetime, frame.lifetime + n);
+    f.alive.assign(frame.alive, frame.alive + n);
+
+    frames_.publish();
+    published_.store(f.index + 1, std::memory_order_relaxed);
+}
+
+void FramePublisher::publish(std::span<const core::Vector2D> positions)
+{
+    PublishedFrame &f = frames_.back();
+    const size_t n = positions.size();
+    f.index = published_.load(std::memory_order_relaxed);
+    f.posX.resize(n);
+    f.posY.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        f.posX[i] = positions[i].x;
+        f.posY[i] = positions[i].y;
+    }
+    f.lifetime.assign(n, 0.f);
+    f.alive.assign(n, 1);
+
+    frames_.publish();
+    published_.store(f.index + 1, std::memory_order_relaxed);
+}
+
+const PublishedFrame *FramePublisher::latest()
+{
+    any_ = frames_.acquire() || any_;
+    return any_ ? &frames_.front() : nullptr;
+}
@@ -0,0 +1,468 @@
+#include "particlesim/recorder.hpp"
+#include "core/bit_packing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using namespace particlesim;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float QuantumLimit = 1073741824.f; // 2^30, keeps differences of two values within int32
+
+    // rounds half away from zero; clamping after the rounding keeps the loops vectorizable
+    inline int32_t quantize(float v)
+    {
+        float r = v + std::copysign(0.5f, v);
+        r = r < -QuantumLimit ? -QuantumLimit : r;
+        r = QuantumLimit < r ? QuantumLimit : r;
+        return static_cast<int32_t>(r);
+    }
+
+    inline size_t aliveWords(size_t count) { return (count + 31) / 32; }
+
+    // base becomes the reference for this frame: zeros on keyframes, zeros past the previous count
+    template <typename T>
+    void resetBase(std::vector<T> &base, size_t count, bool keyframe)
+    {
+        if (keyframe)
+            base.assign(count, 0);
+        else
+            base.resize(count, 0);
+    }
+}
+
+FrameRecorder::FrameRecorder(const std::string &path, const RecorderConfig &config)
+    : config_(config), path_(path), out_(path, std::ios::binary | std::ios::trunc)
+{
+    if (!(config_.quantum > 0.f))
+        throw std::invalid_argument("recorder quantum must be positive");
+    config_.keyframeInterval = std::max<uint32_t>(config_.keyframeInterval, 1);
+    config_.queueDepth = std::max<size_t>(config_.queueDepth, 1);
+
+    if (!out_)
+        throw std::runtime_error("cannot create recording '" + path + "'");
+
+    RecordingHeader header{};
+    std::memcpy(header.magic, RecordingMagic, sizeof(header.magic));
+    header.version = RecordingVersion;
+    header.quantum = config_.quantum;
+    header.keyframeInterval = config_.keyframeInterval;
+    writeBytes(&header, sizeof(header));
+
+    slots_.resize(config_.queueDepth);
+    writer_ = std::thread([this]
+                          { writerLoop(); });
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+FrameRecorder::Slot &FrameRecorder::acquireSlot()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!error_ && submitted_ - written_ >= slots_.size())
+    {
+        ++stats_.stalls;
+        slotFree_.wait(lock, [this]
+                       { return error_ || submitted_ - written_ < slots_.size(); });
+    }
+    if (error_)
+        std::rethrow_exception(error_);
+
+    Slot &slot = slots_[submitted_ % slots_.size()];
+    slot.index = submitted_;
+    return slot;
+}
+
+void FrameRecorder::submit(std::chrono::steady_clock::time_point start)
+{
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++submitted_;
+        stats_.recordSeconds += elapsed.count();
+    }
+    frameReady_.notify_one();
+}
+
+void FrameRecorder::record(const ParticleSoAView &frame)
+{
+    const auto start = Clock::now();
+    Slot &slot = acquireSlot();
+
+    // the only per-particle work on this thread, and it vectorizes
+    const size_t n = frame.count;
+    const float inv = 1.f / config_.quantum;
+    slot.x.resize(n);
+    slot.y.resize(n);
+    slot.alive.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        slot.x[i] = quantize(frame.posX[i] * inv);
+        slot.y[i] = quantize(frame.posY[i] * inv);
+    }
+    std::copy_n(frame.alive, n, slot.alive.data());
+
+    submit(start);
+}
+
+void FrameRecorder::record(std::span<const core::Vector2D> positions)
+{
+    const auto start = Clock::now();
+    Slot &slot = acquireSlot();
+
+    const size_t n = positions.size();
+    const float inv = 1.f / config_.quantum;
+    slot.x.resize(n);
+    slot.y.resize(n);
+    slot.alive.assign(n, 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+        slot.x[i] = quantize(positions[i].x * inv);
+        slot.y[i] = quantize(positions[i].y * inv);
+    }
+
+    submit(start);
+}
+
+void FrameRecorder::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    slotFree_.wait(lock, [this]
+                   { return error_ || written_ == submitted_ || closed_; });
+    if (error_)
+        std::rethrow_exception(error_);
+    // the writer is idle until the next record()
+    if (!closed_)
+        out_.flush();
+}
+
+void FrameRecorder::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_)
+            return;
+        stopping_ = true;
+    }
+    frameReady_.notify_all();
+    writer_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    if (!error_)
+    {
+        try
+        {
+            const uint64_t indexOffset = offset_;
+            const FrameRecordHeader index{FrameRecordHeader::Index, 0, written_, static_cast<uint32_t>(keyframes_.size()),
+                                          static_cast<uint32_t>(keyframes_.size() * sizeof(KeyframeEntry))};
+            writeBytes(&index, sizeof(index));
+            writeBytes(keyframes_.data(), keyframes_.size() * sizeof(KeyframeEntry));
+
+            RecordingTrailer trailer{};
+            trailer.indexOffset = indexOffset;
+            std::memcpy(trailer.magic, RecordingMagic, sizeof(trailer.magic));
+            writeBytes(&trailer, sizeof(trailer));
+
+            out_.close();
+            if (!out_)
+                throw std::runtime_error("cannot write recording '" + path_ + "'");
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+        }
+    }
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+RecorderStats FrameRecorder::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FrameRecorder::writerLoop()
+{
+    for (;;)
+    {
+        const Slot *slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            frameReady_.wait(lock, [this]
+                             { return stopping_ || written_ < submitted_; });
+            // stopping still drains what was recorded
+            if (written_ == submitted_)
+                return;
+            slot = &slots_[written_ % slots_.size()];
+        }
+
+        const bool keyframe = slot->index % config_.keyframeInterval == 0;
+        const auto start = Clock::now();
+        size_t bytes = 0;
+        try
+        {
+            bytes = writeFrame(*slot, keyframe);
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+            }
+            slotFree_.notify_all();
+            return;
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++written_;
+            ++stats_.frames;
+            stats_.keyframes += keyframe ? 1 : 0;
+            stats_.rawBytes += slot->x.size() * sizeof(core::Vector2D);
+            stats_.encodedBytes += bytes;
+            stats_.encodeSeconds += elapsed.count();
+        }
+        slotFree_.notify_all();
+    }
+}
+
+void FrameRecorder::encodeAxis(const std::vector<int32_t> &values, std::vector<int32_t> &base, bool keyframe)
+{
+    const size_t n = values.size();
+    resetBase(base, n, keyframe);
+    scratch_.resize(n);
+    // differences wrap in uint32, the decoder wraps them back
+    for (size_t i = 0; i < n; ++i)
+        scratch_[i] = core::zigzagEncode(static_cast<int32_t>(static_cast<uint32_t>(values[i]) - static_cast<uint32_t>(base[i])));
+    base.assign(values.begin(), values.end());
+    core::packBlocks(scratch_.data(), n, payload_);
+}
+
+size_t FrameRecorder::writeFrame(const Slot &slot, bool keyframe)
+{
+    const size_t n = slot.x.size();
+    payload_.clear();
+    encodeAxis(slot.x, baseX_, keyframe);
+    encodeAxis(slot.y, baseY_, keyframe);
+
+    // alive bits, xor against the previous frame's - deaths are rare, so mostly all-zero blocks
+    const size_t words = aliveWords(n);
+    resetBase(baseAlive_, words, keyframe);
+    scratch_.resize(words);
+    for (size_t w = 0; w < words; ++w)
+    {
+        const size_t begin = w * 32;
+        const size_t bitCount = std::min<size_t>(32, n - begin);
+        uint32_t bits = 0;
+        for (size_t b = 0; b < bitCount; ++b)
+            bits |= uint32_t(slot.alive[begin + b] != 0) << b;
+        scratch_[w] = bits;
+    }
+    for (size_t w = 0; w < words; ++w)
+    {
+        const uint32_t bits = scratch_[w];
+        scratch_[w] ^= baseAlive_[w];
+        baseAlive_[w] = bits;
+    }
+    core::packBlocks(scratch_.data(), words, payload_);
+
+    const FrameRecordHeader header{FrameRecordHeader::Frame, keyframe ? FrameRecordHeader::Keyframe : 0u, slot.index,
+                                   static_cast<uint32_t>(n), static_cast<uint32_t>(payload_.size())};
+    if (keyframe)
+        keyframes_.push_back({slot.index, offset_});
+    writeBytes(&header, sizeof(header));
+    writeBytes(payload_.data(), payload_.size());
+    return sizeof(header) + payload_.size();
+}
+
+void FrameRecorder::writeBytes(const void *data, size_t bytes)
+{
+    out_.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    if (!out_)
+        throw std::runtime_error("cannot write recording '" + path_ + "'");
+    offset_ += bytes;
+}
+
+FrameReplay::FrameReplay(const std::string &path)
+    : path_(path), in_(path, std::ios::binary)
+{
+    if (!in_)
+        throw std::runtime_error("cannot open recording '" + path + "'");
+
+    in_.seekg(0, std::ios::end);
+    const uint64_t size = static_cast<uint64_t>(in_.tellg());
+    in_.seekg(0);
+    if (size < sizeof(RecordingHeader) || !in_.read(reinterpret_cast<char *>(&header_), sizeof(header_)) ||
+        std::memcmp(header_.magic, RecordingMagic, sizeof(header_.magic)) != 0)
+        throw std::runtime_error("'" + path + "' is not a recording");
+    if (header_.version != RecordingVersion || !(header_.quantum > 0.f))
+        throw std::runtime_error("'" + path + "' is a recording of an unsupported version");
+
+    // a closed recording ends in its keyframe index
+    bool indexed = false;
+    if (size >= sizeof(RecordingHeader) + sizeof(FrameRecordHeader) + sizeof(RecordingTrailer))
+    {
+        RecordingTrailer trailer{};
+        FrameRecordHeader index{};
+        in_.seekg(static_cast<std::streamoff>(size - sizeof(trailer)));
+        in_.read(reinterpret_cast<char *>(&trailer), sizeof(trailer));
+        if (in_ && std::memcmp(trailer.magic, RecordingMagic, sizeof(trailer.magic)) == 0 &&
+            trailer.indexOffset >= sizeof(RecordingHeader) && trailer.indexOffset <= size - sizeof(trailer) - sizeof(index))
+        {
+            in_.seekg(static_cast<std::streamoff>(trailer.indexOffset));
+            in_.read(reinterpret_cast<char *>(&index), sizeof(index));
+            if (in_ && index.marker == FrameRecordHeader::Index &&
+                uint64_t{index.count} * sizeof(KeyframeEntry) == index.payloadBytes &&
+                trailer.indexOffset + sizeof(index) + index.payloadBytes + sizeof(trailer) == size)
+            {
+                keyframes_.resize(index.count);
+                in_.read(reinterpret_cast<char *>(keyframes_.data()), index.payloadBytes);
+                frameCount_ = index.index;
+                indexed = static_cast<bool>(in_);
+            }
+        }
+        in_.clear();
+    }
+
+    if (!indexed)
+    {
+        keyframes_.clear();
+        scan(size);
+    }
+    in_.seekg(sizeof(RecordingHeader));
+}
+
+void FrameReplay::scan(uint64_t size)
+{
+    // frames cut off at the end, e.g. by a crash, are left out
+    uint64_t pos = sizeof(RecordingHeader);
+    frameCount_ = 0;
+    in_.seekg(static_cast<std::streamoff>(pos));
+    FrameRecordHeader header{};
+    while (size - pos >= sizeof(header) && in_.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        if (header.marker != FrameRecordHeader::Frame || header.index != frameCount_ ||
+            size - pos - sizeof(header) < header.payloadBytes)
+            break;
+        if (header.flags & FrameRecordHeader::Keyframe)
+            keyframes_.push_back({header.index, pos});
+        ++frameCount_;
+        pos += sizeof(header) + header.payloadBytes;
+        in_.seekg(static_cast<std::streamoff>(pos));
+    }
+    in_.clear();
+}
+
+bool FrameReplay::next(RecordedFrame &frame)
+{
+    return readFrame(&frame);
+}
+
+void FrameReplay::seek(uint64_t frame)
+{
+    if (frame >= frameCount_)
+    {
+        expected_ = frameCount_;
+        return;
+    }
+
+    // keep decoding from where we are when that is not further than from the keyframe
+    auto key = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame,
+                                [](uint64_t f, const KeyframeEntry &k)
+                                { return f < k.frame; });
+    if (key == keyframes_.begin())
+        throw std::runtime_error("'" + path_ + "' has no keyframe before frame " + std::to_string(frame));
+    --key;
+    if (!(haveBase_ && expected_ <= frame && expected_ > key->frame))
+    {
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(key->offset));
+        expected_ = key->frame;
+        haveBase_ = false;
+    }
+
+    while (expected_ < frame)
+        readFrame(nullptr);
+}
+
+bool FrameReplay::readFrame(RecordedFrame *frame)
+{
+    if (expected_ >= frameCount_)
+        return false;
+
+    auto corrupt = [this]()
+    {
+        return std::runtime_error("'" + path_ + "' is corrupt at frame " + std::to_string(expected_));
+    };
+
+    FrameRecordHeader header{};
+    if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.marker != FrameRecordHeader::Frame ||
+        header.index != expected_)
+        throw corrupt();
+    const bool keyframe = (header.flags & FrameRecordHeader::Keyframe) != 0;
+    if (!keyframe && !haveBase_)
+        throw corrupt();
+
+    payload_.resize(header.payloadBytes);
+    if (!in_.read(reinterpret_cast<char *>(payload_.data()), header.payloadBytes))
+        throw corrupt();
+
+    const size_t n = header.count;
+    const uint8_t *p = payload_.data();
+    const uint8_t *end = p + payload_.size();
+    for (std::vector<int32_t> *axis : {&x_, &y_})
+    {
+        resetBase(*axis, n, keyframe);
+        scratch_.resize(n);
+        if (!core::unpackBlocks(p, end, n, scratch_.data()))
+            throw corrupt();
+        int32_t *base = axis->data();
+        for (size_t i = 0; i < n; ++i)
+            base[i] = static_cast<int32_t>(static_cast<uint32_t>(base[i]) + static_cast<uint32_t>(core::zigzagDecode(scratch_[i])));
+    }
+
+    const size_t words = aliveWords(n);
+    resetBase(alive_, words, keyframe);
+    scratch_.resize(words);
+    if (!core::unpackBlocks(p, end, words, scratch_.data()))
+        throw corrupt();
+    for (size_t w = 0; w < words; ++w)
+        alive_[w] ^= scratch_[w];
+
+    haveBase_ = true;
+    ++expected_;
+
+    if (frame)
+    {
+        const float quantum = header_.quantum;
+        frame->index = header.index;
+        frame->keyframe = keyframe;
+        frame->x.resize(n);
+        frame->y.resize(n);
+        frame->alive.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            frame->x[i] = static_cast<float>(x_[i]) * quantum;
+            frame->y[i] = static_cast<float>(y_[i]) * quantum;
+            frame->alive[i] = static_cast<uint8_t>((alive_[i / 32] >> (i % 32)) & 1u);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,268 @@
+#include "particlesim/shm_export.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace particlesim;
+
+namespace
+{
+    constexpr size_t CacheLine = 64;
+
+    size_t alignUp(size_t v) { return (v + CacheLine - 1) & ~(CacheLine - 1); }
+
+    size_t floatColumnBytes(size_t capacity) { return alignUp(capacity * sizeof(float)); }
+
+    size_t slotBytesFor(size_t capacity)
+    {
+        return sizeof(SharedSlotHeader) + 2 * floatColumnBytes(capacity) + alignUp(capacity);
+    }
+
+    uint64_t magicWord()
+    {
+        uint64_t word;
+        std::memcpy(&word, SharedFrameMagic, sizeof(word));
+        return word;
+    }
+
+    std::runtime_error shmError(const char *what, const std::string &name)
+    {
+        return std::runtime_error(std::string(what) + " '" + name + "': " + std::strerror(errno));
+    }
+
+    // whether the segment under name is a frame export whose writer has exited. Anything else,
+    // including a header still being written, counts as in use
+    bool abandoned(const std::string &name)
+    {
+        const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return errno == ENOENT; // unlinked in the meantime
+        unsigned char bytes[sizeof(SharedFrameHeader)];
+        const ssize_t got = ::pread(fd, bytes, sizeof(bytes), 0);
+        ::close(fd);
+        if (got != static_cast<ssize_t>(sizeof(bytes)) || std::memcmp(bytes, SharedFrameMagic, sizeof(SharedFrameHeader::magic)) != 0)
+            return false;
+
+        uint32_t version;
+        int64_t pid;
+        std::memcpy(&version, bytes + offsetof(SharedFrameHeader, version), sizeof(version));
+        std::memcpy(&pid, bytes + offsetof(SharedFrameHeader, writerPid), sizeof(pid));
+        return version == SharedFrameVersion && pid > 0 && ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    }
+}
+
+SharedFrameExport::SharedFrameExport(const std::string &name, size_t capacity, uint32_t slotCount)
+    : name_(name)
+{
+    slotCount = std::max<uint32_t>(slotCount, 1);
+    const size_t slotsOffset = alignUp(sizeof(SharedFrameHeader));
+    const size_t slotBytes = slotBytesFor(capacity);
+    bytes_ = slotsOffset + slotCount * slotBytes;
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST)
+    {
+        if (!abandoned(name))
+        {
+            errno = EEXIST;
+            throw shmError("shared memory is exported by a running process", name);
+        }
+        // left behind by a crashed run, whoever still maps it keeps the old one
+        ::shm_unlink(name.c_str());
+        fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0)
+        throw shmError("cannot create shared memory", name);
+    if (::ftruncate(fd, static_cast<off_t>(bytes_)) != 0)
+    {
+        const std::runtime_error error = shmError("cannot size shared memory", name);
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw error;
+    }
+
+    void *p = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        const std::runtime_error error = shmError("cannot map shared memory", name);
+        ::shm_unlink(name.c_str());
+        throw error;
+    }
+    base_ = static_cast<unsigned char *>(p);
+
+    SharedFrameHeader *h = new (base_) SharedFrameHeader{};
+    h->version = SharedFrameVersion;
+    h->slotCount = slotCount;
+    h->capacity = capacity;
+    h->slotBytes = slotBytes;
+    h->slotsOffset = slotsOffset;
+    h->writerPid = ::getpid();
+    for (uint32_t s = 0; s < slotCount; ++s)
+        new (base_ + slotsOffset + s * slotBytes) SharedSlotHeader{};
+
+    // the magic goes last, readers that find it see a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic.store(magicWord(), std::memory_order_relaxed);
+}
+
+SharedFrameExport::~SharedFrameExport()
+{
+    ::munmap(base_, bytes_);
+    ::shm_unlink(name_.c_str());
+}
+
+SharedSlotHeader *SharedFrameExport::beginSlot(float *&x, float *&y, uint8_t *&alive)
+{
+    SharedFrameHeader *h = header();
+    // only this process writes published, so the relaxed load sees its own last store
+    const uint64_t frame = h->published.load(std::memory_order_relaxed);
+    unsigned char *base = base_ + h->slotsOffset + (frame % h->slotCount) * h->slotBytes;
+
+    auto *slot = reinterpret_cast<SharedSlotHeader *>(base);
+    slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->frame = frame;
+
+    x = reinterpret_cast<float *>(base + sizeof(SharedSlotHeader));
+    y = x + floatColumnBytes(h->capacity) / sizeof(float);
+    alive = reinterpret_cast<uint8_t *>(y + floatColumnBytes(h->capacity) / sizeof(float));
+    return slot;
+}
+
+void SharedFrameExport::endSlot(SharedSlotHeader *slot, size_t count, size_t totalCount, size_t aliveCount)
+{
+    slot->count = count;
+    slot->totalCount = totalCount;
+    slot->aliveCount = aliveCount;
+    slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    header()->published.store(slot->frame + 1, std::memory_order_release);
+}
+
+void SharedFrameExport::publish(const ParticleSoAView &frame)
+{
+    float *x, *y;
+    uint8_t *alive;
+    SharedSlotHeader *slot = beginSlot(x, y, alive);
+
+    const size_t n = std::min<size_t>(frame.count, capacity());
+    std::memcpy(x, frame.posX, n * sizeof(float));
+    std::memcpy(y, frame.posY, n * sizeof(float));
+    std::memcpy(alive, frame.alive, n);
+
+    size_t aliveCount = 0;
+    for (size_t i = 0; i < frame.count; ++i)
+        aliveCount += frame.alive[i] != 0;
+
+    endSlot(slot, n, frame.count, aliveCount);
+}
+
+void SharedFrameExport::publish(std::span<const core::Vector2D> positions)
+{
+    float *x, *y;
+    uint8_t *alive;
+    SharedSlotHeader *slot = beginSlot(x, y, alive);
+
+    const size_t n = std::min<size_t>(positions.size(), capacity());
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = positions[i].x;
+        y[i] = positions[i].y;
+    }
+    std::memset(alive, 1, n);
+
+    endSlot(slot, n, positions.size(), positions.size());
+}
+
+SharedFrameReader::SharedFrameReader(const std::string &name)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw shmError("cannot open shared memory", name);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        const std::runtime_error error = shmError("cannot stat shared memory", name);
+        ::close(fd);
+        throw error;
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < sizeof(SharedFrameHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("'" + name + "' is not a frame export");
+    }
+
+    void *p = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw shmError("cannot map shared memory", name);
+    base_ = static_cast<const unsigned char *>(p);
+
+    // the magic first: once it is there, the fence makes the rest of the header visible
+    const SharedFrameHeader *h = header();
+    bool valid = h->magic.load(std::memory_order_relaxed) == magicWord();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && h->version == SharedFrameVersion && h->slotCount > 0 &&
+            h->slotsOffset >= sizeof(SharedFrameHeader) && h->slotBytes >= slotBytesFor(h->capacity) &&
+            h->slotsOffset + h->slotCount * h->slotBytes <= bytes_;
+    if (!valid)
+    {
+        ::munmap(const_cast<unsigned char *>(base_), bytes_);
+        base_ = nullptr;
+        throw std::runtime_error("'" + name + "' is not a frame export of this version");
+    }
+}
+
+SharedFrameReader::~SharedFrameReader()
+{
+    if (base_)
+        ::munmap(const_cast<unsigned char *>(base_), bytes_);
+}
+
+const SharedSlotHeader *SharedFrameReader::slot(size_t index) const
+{
+    const SharedFrameHeader *h = header();
+    return reinterpret_cast<const SharedSlotHeader *>(base_ + h->slotsOffset + index * h->slotBytes);
+}
+
+bool SharedFrameReader::latest(Frame &frame) const
+{
+    const SharedFrameHeader *h = header();
+    const uint64_t published = h->published.load(std::memory_order_acquire);
+    if (published == 0)
+        return false;
+
+    frame.slot = (published - 1) % h->slotCount;
+    const SharedSlotHeader *s = slot(frame.slot);
+    frame.sequence = s->sequence.load(std::memory_order_acquire);
+    if (frame.sequence & 1)
+        return false;
+
+    // possibly torn until unchanged() says otherwise, so the count is kept inside the columns
+    frame.frame = s->frame;
+    frame.count = std::min<size_t>(s->count, h->capacity);
+    frame.totalCount = s->totalCount;
+    frame.aliveCount = s->aliveCount;
+
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(s);
+    frame.posX = reinterpret_cast<const float *>(base + sizeof(SharedSlotHeader));
+    frame.posY = frame.posX + floatColumnBytes(h->capacity) / sizeof(float);
+    frame.alive = reinterpret_cast<const uint8_t *>(frame.posY + floatColumnBytes(h->capacity) / sizeof(float));
+    return true;
+}
+
+bool SharedFrameReader::unchanged(const Frame &frame) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot(frame.slot)->sequence.load(std::memory_order_relaxed) == frame.sequence;
+}
@@ -0,0 +1,261 @@
+#include "particlesim/snapshot.hpp"
+#include "particlesim/particle_system.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace particlesim;
+
+namespace
+{
+    struct ColumnRef
+    {
+        SnapshotField field;
+        uint32_t component;
+        uint32_t elementSize;
+        const void *data;
+    };
+
+    template <typename Field>
+    void collect(Field &f, SnapshotField id, std::vector<ColumnRef> &out)
+    {
+        using T = typename Field::Column::value_type;
+        for (uint32_t k = 0; k < f.storage.size(); ++k)
+            out.push_back({id, k, sizeof(T), f.storage[k].data()});
+    }
+
+    std::vector<ColumnRef> collectAll(ParticleSoA &soa)
+    {
+        std::vector<ColumnRef> columns;
+        collect(soa.field<Position>(), SnapshotField::Position, columns);
+        collect(soa.field<Velocity>(), SnapshotField::Velocity, columns);
+        collect(soa.field<Acceleration>(), SnapshotField::Acceleration, columns);
+        collect(soa.field<Lifetime>(), SnapshotField::Lifetime, columns);
+        collect(soa.field<Alive>(), SnapshotField::Alive, columns);
+        collect(soa.field<Tier>(), SnapshotField::Tier, columns);
+        return columns;
+    }
+
+    // copies every component present in the file, the rest is set to fallback
+    template <typename Field>
+    void restoreField(Field &f, SnapshotField id, const MappedSnapshot &snapshot, typename Field::Column::value_type fallback)
+    {
+        using T = typename Field::Column::value_type;
+        const size_t n = snapshot.size();
+        for (uint32_t k = 0; k < f.storage.size(); ++k)
+        {
+            if (const T *src = snapshot.column<T>(id, k))
+                std::memcpy(f.storage[k].data(), src, n * sizeof(T));
+            else
+                std::fill_n(f.storage[k].data(), n, fallback);
+        }
+    }
+
+    size_t alignUp(size_t v) { return (v + SnapshotAlignment - 1) & ~(SnapshotAlignment - 1); }
+
+    std::runtime_error ioError(const char *what, const std::string &path)
+    {
+        return std::runtime_error(std::string(what) + " '" + path + "': " + std::strerror(errno));
+    }
+}
+
+void particlesim::writeSnapshot(const std::string &path, ParticleSystemDataSoA &layout)
+{
+    ParticleSoA &soa = layout.columns();
+    const size_t n = soa.size();
+    const std::vector<ColumnRef> columns = collectAll(soa);
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = SnapshotVersion;
+    header.byteOrder = SnapshotByteOrder;
+    header.particleCount = n;
+    header.sectionCount = static_cast<uint32_t>(columns.size());
+
+    const size_t tableEnd = sizeof(header) + columns.size() * sizeof(SnapshotSection);
+    std::vector<SnapshotSection> sections(columns.size());
+    size_t offset = alignUp(tableEnd);
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const ColumnRef &c = columns[i];
+        sections[i] = {static_cast<uint32_t>(c.field), c.component, c.elementSize, 0, offset, n * c.elementSize};
+        offset = alignUp(offset + sections[i].bytes);
+    }
+
+    // header, table and columns gathered straight from the SoA, zero padding in between
+    static const char zeros[SnapshotAlignment] = {};
+    std::vector<iovec> iov;
+    iov.reserve(2 + 2 * columns.size());
+    iov.push_back({&header, sizeof(header)});
+    iov.push_back({sections.data(), sections.size() * sizeof(SnapshotSection)});
+    size_t end = tableEnd;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        if (sections[i].offset > end)
+            iov.push_back({const_cast<char *>(zeros), sections[i].offset - end});
+        iov.push_back({const_cast<void *>(columns[i].data), sections[i].bytes});
+        end = sections[i].offset + sections[i].bytes;
+    }
+
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw ioError("cannot create snapshot", path);
+
+    // a single call unless the kernel writes short, then the rest is resumed
+    size_t first = 0;
+    while (first < iov.size())
+    {
+        const int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+        const ssize_t written = ::writev(fd, iov.data() + first, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            const std::runtime_error error = ioError("cannot write snapshot", path);
+            ::close(fd);
+            throw error;
+        }
+
+        size_t left = static_cast<size_t>(written);
+        while (first < iov.size() && left >= iov[first].iov_len)
+            left -= iov[first++].iov_len;
+        if (left > 0)
+        {
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+
+    if (::close(fd) != 0)
+        throw ioError("cannot write snapshot", path);
+}
+
+MappedSnapshot::MappedSnapshot(const std::string &path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw ioError("cannot open snapshot", path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        const std::runtime_error error = ioError("cannot stat snapshot", path);
+        ::close(fd);
+        throw error;
+    }
+
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < sizeof(SnapshotHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("'" + path + "' is too short for a snapshot");
+    }
+
+    void *p = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw ioError("cannot map snapshot", path);
+    data_ = static_cast<const unsigned char *>(p);
+    // columns are read front to back, start reading ahead right away
+    ::madvise(p, bytes_, MADV_WILLNEED);
+
+    auto fail = [&](const char *why)
+    {
+        unmap();
+        throw std::runtime_error("'" + path + "' is not a valid snapshot: " + why);
+    };
+
+    const SnapshotHeader &h = header();
+    if (std::memcmp(h.magic, SnapshotMagic, sizeof(h.magic)) != 0)
+        fail("bad magic");
+    if (h.byteOrder != SnapshotByteOrder)
+        fail("written with another byte order");
+    if (h.version != SnapshotVersion)
+        fail("unsupported version");
+    if (h.sectionCount > (bytes_ - sizeof(SnapshotHeader)) / sizeof(SnapshotSection))
+        fail("truncated section table");
+    // every particle takes at least a byte of the file, which also keeps the products below in range
+    if (h.particleCount > bytes_)
+        fail("particle count larger than the file");
+
+    const auto *sections = reinterpret_cast<const SnapshotSection *>(data_ + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < h.sectionCount; ++i)
+    {
+        const SnapshotSection &s = sections[i];
+        if (s.offset % SnapshotAlignment != 0)
+            fail("misaligned column");
+        if (s.elementSize == 0 || s.elementSize > bytes_ / (h.particleCount ? h.particleCount : 1))
+            fail("bad element size");
+        if (s.bytes != h.particleCount * s.elementSize)
+            fail("column size does not match the particle count");
+        if (s.offset > bytes_ || s.bytes > bytes_ - s.offset)
+            fail("truncated column");
+    }
+}
+
+MappedSnapshot::~MappedSnapshot() { unmap(); }
+
+MappedSnapshot::MappedSnapshot(MappedSnapshot &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), bytes_(std::exchange(other.bytes_, 0))
+{
+}
+
+MappedSnapshot &MappedSnapshot::operator=(MappedSnapshot &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+}
+
+void MappedSnapshot::unmap()
+{
+    if (data_)
+        ::munmap(const_cast<unsigned char *>(data_), bytes_);
+    data_ = nullptr;
+    bytes_ = 0;
+}
+
+const SnapshotSection *MappedSnapshot::section(SnapshotField field, uint32_t component) const
+{
+    const auto *sections = reinterpret_cast<const SnapshotSection *>(data_ + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < header().sectionCount; ++i)
+    {
+        if (sections[i].field == static_cast<uint32_t>(field) && sections[i].component == component)
+            return &sections[i];
+    }
+    return nullptr;
+}
+
+const void *MappedSnapshot::column(SnapshotField field, uint32_t component) const
+{
+    const SnapshotSection *s = section(field, component);
+    return s ? data_ + s->offset : nullptr;
+}
+
+void MappedSnapshot::restore(ParticleSystemDataSoA &layout) const
+{
+    ParticleSoA &soa = layout.columns();
+    soa.resize(size());
+
+    restoreField(soa.field<Position>(), SnapshotField::Position, *this, 0.f);
+    restoreField(soa.field<Velocity>(), SnapshotField::Velocity, *this, 0.f);
+    restoreField(soa.field<Acceleration>(), SnapshotField::Acceleration, *this, 0.f);
+    restoreField(soa.field<Lifetime>(), SnapshotField::Lifetime, *this, 0.f);
+    restoreField(soa.field<Alive>(), SnapshotField::Alive, *this, uint8_t{0});
+    restoreField(soa.field<Tier>(), SnapshotField::Tier, *this, uint8_t{1});
+
+    layout.columnsReplaced();
+}
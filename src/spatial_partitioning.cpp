@@ -1,8 +1,10 @@
 #include "particlesim/spatial_partitioning.hpp"
+#include "particlesim/profiling.hpp"
 #include <algorithm>
 #include <assert.h>
 #include <cstdint>
 #include <cmath>
+#include <cstring>
 
 using namespace particlesim;
 
@@ -28,18 +30,22 @@ void UniformGrid::ensureBucketsSize()
 {
     buckets.clear();
     buckets.resize(gridWidth * gridHeight);
+    occupancy_.clear();
+    neighborCounts_.clear();
 }
 
 void UniformGrid::build()
 {
+    PARTICLESIM_ZONE(PartitionBuild);
     if (data.positions.empty())
         return;
 
     for (uint32_t i = 0; i < data.positions.size(); ++i)
     {
         auto &p = data.positions[i];
-        uint32_t idx = toCellIndex(p.x, p.y);
-        buckets[idx].push_back(i);
+        auto &bucket = buckets[toCellIndex(p.x, p.y)];
+        bucket.push_back(i);
+        occupancy_.grown(static_cast<uint32_t>(bucket.size()));
     }
 }
 
@@ -105,6 +111,7 @@ span<const uint32_t> UniformGrid::queryNeighborhood(uint32_t particleID)
         }
     }
 
+    neighborCounts_.record(static_cast<uint32_t>(neighborBuffer.size()));
     return {neighborBuffer.data(), neighborBuffer.size()};
 }
 
@@ -113,13 +120,27 @@ void UniformGrid::clear()
     for (auto &b : buckets)
         b.clear();
     neighborBuffer.clear();
+    occupancy_.clear();
+    neighborCounts_.clear();
+}
+
+PartitionStats UniformGrid::stats() const
+{
+    return {data.positions.size(), buckets.size(), occupancy_, neighborCounts_};
 }
 
 span<const uint32_t> particlesim::UniformGridAllocated::queryNeighborhood(uint32_t particleID)
+{
+    assert(data.arena && "FrameArena must be provided");
+    const auto neighbors = queryNeighborhood(particleID, *data.arena);
+    neighborCounts_.record(static_cast<uint32_t>(neighbors.size()));
+    return neighbors;
+}
+
+span<const uint32_t> particlesim::UniformGridAllocated::queryNeighborhood(uint32_t particleID, FrameArena &arena) const
 {
     assert(data.positions.data() != nullptr);
     assert(particleID < data.positions.size());
-    assert(&data.arena && "FrameArena must be provided");
 
     const auto &pos = data.positions[particleID];
     int cx, cy;
@@ -143,7 +164,7 @@ span<const uint32_t> particlesim::UniformGridAllocated::queryNeighborhood(uint32
         }
     }
 
-    uint32_t *out = data.arena.allocateArray<uint32_t>(maxCount);
+    uint32_t *out = arena.allocateArray<uint32_t>(maxCount);
     uint32_t count = 0;
 
     for (int dy = -1; dy <= 1; ++dy)
@@ -182,7 +203,16 @@ span<const uint32_t> particlesim::UniformGridAllocated::queryNeighborhood(uint32
 
 void particlesim::UniformGridAllocated::clear()
 {
-    data.arena.reset();
+    UniformGrid::clear();
+    if (data.arena)
+        data.arena->reset();
+}
+
+PartitionStats particlesim::NoPartition::stats() const
+{
+    PartitionStats s;
+    s.particles = data.positions.size();
+    return s;
 }
 
 span<const uint32_t> particlesim::NoPartition::queryNeighborhood(uint32_t particleID)
@@ -200,3 +230,234 @@ span<const uint32_t> particlesim::NoPartition::queryNeighborhood(uint32_t partic
 
     return neighborBuffer;
 }
+
+PartitionStats particlesim::KDTree::stats() const
+{
+    PartitionStats s;
+    s.particles = data.positions.size();
+    return s;
+}
+
+void particlesim::KDTree::build()
+{
+    PARTICLESIM_ZONE(PartitionBuild);
+    const uint32_t count = static_cast<uint32_t>(data.positions.size());
+    ids.resize(count);
+    splitAxis.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i)
+        ids[i] = i;
+
+    if (count > 0)
+        buildRange(0, count);
+
+    // gather positions in tree order so queries walk contiguous memory
+    points.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+        points[i] = data.positions[ids[i]];
+}
+
+void particlesim::KDTree::buildRange(uint32_t lo, uint32_t hi)
+{
+    if (hi - lo <= LeafSize)
+        return;
+
+    float minX = data.positions[ids[lo]].x, maxX = minX;
+    float minY = data.positions[ids[lo]].y, maxY = minY;
+    for (uint32_t i = lo + 1; i < hi; ++i)
+    {
+        const auto &p = data.positions[ids[i]];
+        minX = min(minX, p.x);
+        maxX = max(maxX, p.x);
+        minY = min(minY, p.y);
+        maxY = max(maxY, p.y);
+    }
+
+    // split along the wider extent - keeps clustered data balanced
+    const uint8_t axis = (maxY - minY) > (maxX - minX) ? 1 : 0;
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const auto &positions = data.positions;
+    nth_element(ids.begin() + lo, ids.begin() + mid, ids.begin() + hi, [&](uint32_t a, uint32_t b)
+                { return axis == 0 ? positions[a].x < positions[b].x : positions[a].y < positions[b].y; });
+
+    splitAxis[mid] = axis;
+    buildRange(lo, mid);
+    buildRange(mid + 1, hi);
+}
+
+void particlesim::KDTree::clear()
+{
+    ids.clear();
+    points.clear();
+    splitAxis.clear();
+    neighborBuffer.clear();
+    if (data.arena)
+        data.arena->reset();
+}
+
+span<const uint32_t> particlesim::KDTree::queryNeighborhood(uint32_t particleID)
+{
+    assert(particleID < data.positions.size());
+
+    neighborBuffer.clear();
+    if (points.empty())
+        return {};
+
+    const uint32_t exclude = config.excludeSelfFromQuery ? particleID : InvalidID;
+    searchRadius(0, static_cast<uint32_t>(points.size()), data.positions[particleID], config.cellSize * config.cellSize, exclude);
+    return {neighborBuffer.data(), neighborBuffer.size()};
+}
+
+void particlesim::KDTree::searchRadius(uint32_t lo, uint32_t hi, const Vector2D &point, float radiusSq, uint32_t exclude)
+{
+    auto consider = [&](uint32_t slot)
+    {
+        const float dx = points[slot].x - point.x;
+        const float dy = points[slot].y - point.y;
+        if (dx * dx + dy * dy <= radiusSq && ids[slot] != exclude)
+            neighborBuffer.push_back(ids[slot]);
+    };
+
+    if (hi - lo <= LeafSize)
+    {
+        for (uint32_t i = lo; i < hi; ++i)
+            consider(i);
+        return;
+    }
+
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const float diff = splitAxis[mid] == 0 ? point.x - points[mid].x : point.y - points[mid].y;
+    consider(mid);
+
+    if (diff <= 0.f || diff * diff <= radiusSq)
+        searchRadius(lo, mid, point, radiusSq, exclude);
+    if (diff >= 0.f || diff * diff <= radiusSq)
+        searchRadius(mid + 1, hi, point, radiusSq, exclude);
+}
+
+span<const uint32_t> particlesim::KDTree::queryKNearest(uint32_t particleID, uint32_t k)
+{
+    assert(particleID < data.positions.size());
+
+    const uint32_t exclude = config.excludeSelfFromQuery ? particleID : InvalidID;
+    heapScratch.resize(k);
+    const uint32_t count = searchKNearest(data.positions[particleID], k, exclude, heapScratch.data());
+    return writeResults(heapScratch.data(), count);
+}
+
+span<const uint32_t> particlesim::KDTree::queryKNearest(const Vector2D &point, uint32_t k)
+{
+    heapScratch.resize(k);
+    const uint32_t count = searchKNearest(point, k, InvalidID, heapScratch.data());
+    return writeResults(heapScratch.data(), count);
+}
+
+span<const uint32_t> particlesim::KDTree::writeResults(const Candidate *heap, uint32_t count)
+{
+    assert(data.arena && "FrameArena must be provided");
+
+    uint32_t *out = data.arena->allocateArray<uint32_t>(count);
+    for (uint32_t i = 0; i < count; ++i)
+        out[i] = heap[i].id;
+    return {out, count};
+}
+
+span<const uint32_t> particlesim::KDTree::queryKNearestBatch(span<const uint32_t> particleIDs, uint32_t k, ParallelScheduler &scheduler)
+{
+    PARTICLESIM_ZONE(PartitionQuery);
+    assert(data.arena && "FrameArena must be provided");
+
+    const size_t n = particleIDs.size();
+    if (n == 0 || k == 0)
+        return {};
+
+    // the shared arena is not thread safe - carve the output up front, heaps come from the workers' arenas
+    uint32_t *out = data.arena->allocateArray<uint32_t>(n * k);
+
+    scheduler.parallelFor(n, [&](size_t begin, size_t end, size_t worker)
+                          {
+        FrameArena &scratch = scheduler.workerArena(worker);
+        ScopedArenaMarker marker(scratch);
+        Candidate *heap = scratch.allocateArray<Candidate>(k);
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint32_t id = particleIDs[i];
+            assert(id < data.positions.size());
+            const uint32_t exclude = config.excludeSelfFromQuery ? id : InvalidID;
+            const uint32_t count = searchKNearest(data.positions[id], k, exclude, heap);
+
+            uint32_t *row = out + i * k;
+            for (uint32_t j = 0; j < count; ++j)
+                row[j] = heap[j].id;
+            for (uint32_t j = count; j < k; ++j)
+                row[j] = InvalidID;
+        } });
+
+    return {out, n * k};
+}
+
+uint32_t particlesim::KDTree::searchKNearest(const Vector2D &point, uint32_t k, uint32_t exclude, Candidate *heap) const
+{
+    uint32_t count = 0;
+    if (k == 0 || points.empty())
+        return 0;
+
+    searchKNearest(0, static_cast<uint32_t>(points.size()), point, k, exclude, heap, count);
+
+    // max-heap on distance - sorting it leaves the closest first
+    sort_heap(heap, heap + count, [](const Candidate &a, const Candidate &b)
+              { return a.distSq < b.distSq; });
+    return count;
+}
+
+void particlesim::KDTree::searchKNearest(uint32_t lo, uint32_t hi, const Vector2D &point, uint32_t k, uint32_t exclude,
+                                         Candidate *heap, uint32_t &count) const
+{
+    auto closer = [](const Candidate &a, const Candidate &b)
+    { return a.distSq < b.distSq; };
+
+    auto consider = [&](uint32_t slot)
+    {
+        if (ids[slot] == exclude)
+            return;
+
+        const float dx = points[slot].x - point.x;
+        const float dy = points[slot].y - point.y;
+        const float d = dx * dx + dy * dy;
+
+        if (count < k)
+        {
+            heap[count++] = {d, ids[slot]};
+            push_heap(heap, heap + count, closer);
+        }
+        else if (d < heap[0].distSq)
+        {
+            pop_heap(heap, heap + count, closer);
+            heap[count - 1] = {d, ids[slot]};
+            push_heap(heap, heap + count, closer);
+        }
+    };
+
+    if (hi - lo <= LeafSize)
+    {
+        for (uint32_t i = lo; i < hi; ++i)
+            consider(i);
+        return;
+    }
+
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const float diff = splitAxis[mid] == 0 ? point.x - points[mid].x : point.y - points[mid].y;
+    consider(mid);
+
+    if (diff < 0.f)
+    {
+        searchKNearest(lo, mid, point, k, exclude, heap, count);
+        if (count < k || diff * diff < heap[0].distSq)
+            searchKNearest(mid + 1, hi, point, k, exclude, heap, count);
+    }
+    else
+    {
+        searchKNearest(mid + 1, hi, point, k, exclude, heap, count);
+        if (count < k || diff * diff < heap[0].distSq)
+            searchKNearest(lo, mid, point, k, exclude, heap, count);
+    }
+}
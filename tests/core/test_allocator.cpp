@@ -27,6 +27,7 @@ TEST(FreeListPoolTest, DeallocateAndReuse)
 
     size_t a = pool.allocate();
     size_t b = pool.allocate();
+    (void)b;
 
     pool.deallocate(a);
     size_t c = pool.allocate();
@@ -134,7 +135,7 @@ TEST(FrameArenaTest, MixedTypeAllocations)
 
 TEST(FrameArenaTest, ThrowsOnOutOfMemory)
 {
-    FrameArena arena(sizeof(int) * 4);
+    FrameArena arena(sizeof(int) * 4, ArenaGrowth::Fixed);
 
     arena.allocateArray<int>(4);
 
@@ -143,6 +144,122 @@ TEST(FrameArenaTest, ThrowsOnOutOfMemory)
         std::bad_alloc);
 }
 
+TEST(FrameArenaTest, ChainsChunksOnOverflow)
+{
+    FrameArena arena(sizeof(int) * 4);
+
+    int *a = arena.allocateArray<int>(4);
+    int *b = arena.allocateArray<int>(16);
+    ASSERT_NE(b, nullptr);
+    for (int i = 0; i < 4; ++i)
+        a[i] = i;
+    for (int i = 0; i < 16; ++i)
+        b[i] = 100 + i;
+    EXPECT_EQ(a[3], 3);
+    EXPECT_EQ(b[15], 115);
+
+    const ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.chunks, 2u);
+    EXPECT_EQ(stats.overflows, 1u);
+    EXPECT_EQ(stats.bytesUsed, sizeof(int) * 20);
+    EXPECT_GE(stats.capacity, sizeof(int) * 20);
+}
+
+TEST(FrameArenaTest, KeepsChunksAcrossResetAndTracksHighWater)
+{
+    FrameArena arena(64);
+    arena.setRebalanceInterval(0);
+
+    arena.allocateArray<char>(48);
+    arena.allocateArray<char>(100);
+    arena.reset();
+
+    EXPECT_EQ(arena.stats().bytesUsed, 0u);
+    EXPECT_EQ(arena.stats().highWaterMark, 148u);
+
+    // the same frame again fits in the kept chunks without a new one
+    arena.allocateArray<char>(48);
+    arena.allocateArray<char>(100);
+    EXPECT_EQ(arena.stats().chunks, 2u);
+    EXPECT_EQ(arena.stats().overflows, 2u);
+}
+
+TEST(FrameArenaTest, RebalancesToObservedPeak)
+{
+    FrameArena arena(1024 * 1024);
+    arena.setRebalanceInterval(4);
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        arena.allocateArray<char>(10000);
+        arena.reset();
+    }
+
+    // shrunk to one chunk with headroom over the 10 KB peak
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.chunks, 1u);
+    EXPECT_GE(stats.capacity, 10000u);
+    EXPECT_LT(stats.capacity, 20000u);
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        arena.allocateArray<char>(8000);
+        arena.allocateArray<char>(30000);
+        arena.reset();
+    }
+
+    // grown back into a single chunk that holds the new peak
+    stats = arena.stats();
+    EXPECT_EQ(stats.chunks, 1u);
+    EXPECT_GE(stats.capacity, 38000u);
+    EXPECT_EQ(stats.highWaterMark, 38000u);
+
+    arena.allocateArray<char>(38000);
+    EXPECT_EQ(arena.stats().chunks, 1u);
+}
+
+TEST(FrameArenaTest, RewindReleasesLaterAllocations)
+{
+    FrameArena arena(1024);
+
+    int *kept = arena.allocateArray<int>(4);
+    const auto marker = arena.mark();
+    int *temp = arena.allocateArray<int>(16);
+    arena.rewind(marker);
+
+    EXPECT_EQ(arena.stats().bytesUsed, sizeof(int) * 4);
+    EXPECT_EQ(arena.stats().highWaterMark, sizeof(int) * 20);
+
+    // the space after the marker is handed out again
+    int *reused = arena.allocateArray<int>(16);
+    EXPECT_EQ(reused, temp);
+    EXPECT_NE(kept, reused);
+}
+
+TEST(FrameArenaTest, ScopedMarkerRewindsAcrossChunks)
+{
+    FrameArena arena(64);
+    arena.setRebalanceInterval(0);
+
+    arena.allocateArray<char>(32);
+    {
+        ScopedArenaMarker scope(arena);
+        arena.allocateArray<char>(200);
+        {
+            ScopedArenaMarker nested(arena);
+            arena.allocateArray<char>(16);
+        }
+        EXPECT_EQ(arena.stats().bytesUsed, 232u);
+    }
+
+    EXPECT_EQ(arena.stats().bytesUsed, 32u);
+    EXPECT_EQ(arena.stats().chunks, 3u);
+
+    // continues in the first chunk, the chained ones are kept for later overflows
+    arena.allocateArray<char>(16);
+    EXPECT_EQ(arena.stats().bytesUsed, 48u);
+}
+
 TEST(FrameArenaTest, LargeArrayAllocation)
 {
     FrameArena arena(1024);
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "core/bit_packing.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace core;
+
+TEST(BitPacking, Zigzag) {
+    EXPECT_EQ(zigzagEncode(0), 0u);
+    EXPECT_EQ(zigzagEncode(-1), 1u);
+    EXPECT_EQ(zigzagEncode(1), 2u);
+    EXPECT_EQ(zigzagEncode(-2), 3u);
+    EXPECT_EQ(zigzagEncode(std::numeric_limits<int32_t>::max()), 0xfffffffeu);
+    EXPECT_EQ(zigzagEncode(std::numeric_limits<int32_t>::min()), 0xffffffffu);
+    for (int32_t v : {0, 1, -1, 1000, -123456, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()})
+        EXPECT_EQ(zigzagDecode(zigzagEncode(v)), v);
+}
+
+TEST(BitPacking, RoundTripsEveryWidth) {
+    for (uint32_t width = 0; width <= 32; ++width)
+    {
+        // a partial last block as well
+        std::vector<uint32_t> values(3 * PackBlockSize + 17);
+        const uint32_t top = width == 0 ? 0u : width == 32 ? 0xffffffffu : (1u << width) - 1;
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = static_cast<uint32_t>(i * 2654435761u) & top;
+        values[5] = top;
+
+        std::vector<uint8_t> packed;
+        packBlocks(values.data(), values.size(), packed);
+        EXPECT_EQ(packed.size(), 3 * (1 + packedBlockBytes(PackBlockSize, width)) + 1 + packedBlockBytes(17, width));
+
+        std::vector<uint32_t> out(values.size(), 0xdeadbeef);
+        const uint8_t *p = packed.data();
+        ASSERT_TRUE(unpackBlocks(p, packed.data() + packed.size(), values.size(), out.data()));
+        EXPECT_EQ(p, packed.data() + packed.size());
+        EXPECT_EQ(out, values) << "width " << width;
+    }
+}
+
+TEST(BitPacking, BlocksPickTheirOwnWidth) {
+    std::vector<uint32_t> values(2 * PackBlockSize, 0);
+    values[PackBlockSize + 3] = 5;
+
+    std::vector<uint8_t> packed;
+    packBlocks(values.data(), values.size(), packed);
+    ASSERT_EQ(packed.size(), 1 + 1 + packedBlockBytes(PackBlockSize, 3));
+    EXPECT_EQ(packed[0], 0);
+    EXPECT_EQ(packed[1], 3);
+}
+
+TEST(BitPacking, RejectsShortOrBrokenInput) {
+    std::vector<uint32_t> values(200, 77);
+    std::vector<uint8_t> packed;
+    packBlocks(values.data(), values.size(), packed);
+
+    std::vector<uint32_t> out(values.size());
+    const uint8_t *p = packed.data();
+    EXPECT_FALSE(unpackBlocks(p, packed.data() + packed.size() - 1, values.size(), out.data()));
+
+    packed[0] = 33;
+    p = packed.data();
+    EXPECT_FALSE(unpackBlocks(p, packed.data() + packed.size(), values.size(), out.data()));
+    EXPECT_EQ(p, packed.data());
+}
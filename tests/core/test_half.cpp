@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "core/half.hpp"
+#include <cmath>
+#include <limits>
+
+using namespace core;
+
+TEST(Half, KnownEncodings) {
+    EXPECT_EQ(floatToHalf(0.0f), 0x0000);
+    EXPECT_EQ(floatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(floatToHalf(1.0f), 0x3c00);
+    EXPECT_EQ(floatToHalf(-2.0f), 0xc000);
+    EXPECT_EQ(floatToHalf(65504.0f), 0x7bff);
+    EXPECT_EQ(floatToHalf(5.9604645e-8f), 0x0001); // smallest subnormal
+}
+
+TEST(Half, OverflowAndSpecials) {
+    EXPECT_EQ(floatToHalf(65520.0f), 0x7c00);
+    EXPECT_EQ(floatToHalf(-1e9f), 0xfc00);
+    EXPECT_EQ(floatToHalf(std::numeric_limits<float>::infinity()), 0x7c00);
+    EXPECT_TRUE(std::isnan(halfToFloat(floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isinf(halfToFloat(0xfc00)));
+}
+
+TEST(Half, RoundsToNearestEven) {
+    // 1 + 2^-11 sits halfway between 1 and the next half, ties go to the even mantissa
+    EXPECT_EQ(floatToHalf(1.0f + 0.00048828125f), 0x3c00);
+    EXPECT_EQ(floatToHalf(1.0f + 3.f * 0.00048828125f), 0x3c02);
+    EXPECT_EQ(floatToHalf(1.0f + 0.0006f), 0x3c01);
+}
+
+TEST(Half, EveryHalfRoundTrips) {
+    for (uint32_t h = 0; h < 0x10000; ++h)
+    {
+        const float f = halfToFloat(static_cast<uint16_t>(h));
+        if (std::isnan(f))
+            continue;
+        EXPECT_EQ(floatToHalf(f), h);
+    }
+}
+
+TEST(Half, RelativeErrorWithinHalfUlp) {
+    for (float f = 1e-3f; f < 60000.f; f *= 1.37f)
+    {
+        const float r = halfToFloat(floatToHalf(f));
+        EXPECT_LE(std::fabs(r - f) / f, 1.f / 2048.f);
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "core/hdr_histogram.hpp"
+#include "core/log2_histogram.hpp"
+
+using namespace core;
+
+TEST(HdrHistogram, BucketsAreLogLinear)
+{
+    // one bucket per value up to 2 * SubBuckets
+    EXPECT_EQ(HdrHistogram::bucketOf(0), 0u);
+    EXPECT_EQ(HdrHistogram::bucketOf(63), 63u);
+    EXPECT_EQ(HdrHistogram::bucketUpperBound(63), 63u);
+
+    // then SubBuckets per power of two, each twice as wide as the ones below
+    EXPECT_EQ(HdrHistogram::bucketOf(64), HdrHistogram::bucketOf(65));
+    EXPECT_NE(HdrHistogram::bucketOf(65), HdrHistogram::bucketOf(66));
+    EXPECT_EQ(HdrHistogram::bucketLowerBound(HdrHistogram::bucketOf(1000)), 992u);
+    EXPECT_EQ(HdrHistogram::bucketUpperBound(HdrHistogram::bucketOf(1000)), 1007u);
+
+    for (uint64_t v : {uint64_t{100}, uint64_t{4096}, uint64_t{123456789}, uint64_t{1} << 50})
+    {
+        const size_t bucket = HdrHistogram::bucketOf(v);
+        EXPECT_LE(HdrHistogram::bucketLowerBound(bucket), v);
+        EXPECT_GE(HdrHistogram::bucketUpperBound(bucket), v);
+        // within 1 / SubBuckets of the value
+        EXPECT_LE(HdrHistogram::bucketUpperBound(bucket) - HdrHistogram::bucketLowerBound(bucket), v / HdrHistogram::SubBuckets);
+        EXPECT_EQ(HdrHistogram::bucketOf(HdrHistogram::bucketUpperBound(bucket) + 1), bucket + 1);
+    }
+}
+
+TEST(HdrHistogram, RecordsMomentsAndExtremes)
+{
+    HdrHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    EXPECT_EQ(h.stddev(), 0.0);
+
+    for (uint64_t v : {2u, 4u, 4u, 4u, 5u, 5u, 7u, 9u})
+        h.record(v);
+    EXPECT_EQ(h.total(), 8u);
+    EXPECT_EQ(h.min(), 2u);
+    EXPECT_EQ(h.max(), 9u);
+    EXPECT_DOUBLE_EQ(h.mean(), 5.0);
+    EXPECT_DOUBLE_EQ(h.stddev(), 2.0);
+    EXPECT_EQ(h.count(4), 3u);
+    EXPECT_EQ(h.bucketCount(), 10u);
+
+    h.clear();
+    EXPECT_EQ(h.total(), 0u);
+    EXPECT_EQ(h.bucketCount(), 0u);
+}
+
+TEST(HdrHistogram, PercentilesStayWithinABucket)
+{
+    // 1 .. 100000 once each
+    HdrHistogram h;
+    for (uint64_t v = 1; v <= 100000; ++v)
+        h.record(v);
+
+    for (double p : {0.5, 0.9, 0.99, 0.999})
+    {
+        const double exact = p * 100000.0;
+        const double got = double(h.percentile(p));
+        EXPECT_GE(got, exact);
+        EXPECT_LE(got, exact * (1.0 + 1.0 / HdrHistogram::SubBuckets)) << p;
+    }
+    EXPECT_EQ(h.percentile(1.0), 100000u);
+    EXPECT_EQ(h.percentile(0.0), 1u);
+}
+
+TEST(HdrHistogram, PercentilesMatchLog2HistogramBelowItsSubBuckets)
+{
+    // both share LogLinearBuckets and give values below 2 a bucket each
+    HdrHistogram h;
+    Log2Histogram log2;
+    for (uint32_t v : {0u, 1u})
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            h.record(v);
+            log2.record(v);
+        }
+    }
+
+    for (double p : {0.0, 0.25, 0.5, 0.5 + 5e-14, 0.75, 1.0})
+        EXPECT_EQ(h.percentile(p), log2.percentile(p)) << p;
+}
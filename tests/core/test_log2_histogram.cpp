@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "core/log2_histogram.hpp"
+
+using namespace core;
+
+TEST(Log2Histogram, BinsArePowersOfTwo)
+{
+    EXPECT_EQ(Log2Histogram::binOf(0), 0u);
+    EXPECT_EQ(Log2Histogram::binOf(1), 1u);
+    EXPECT_EQ(Log2Histogram::binOf(3), 2u);
+    EXPECT_EQ(Log2Histogram::binOf(4), 3u);
+    EXPECT_EQ(Log2Histogram::binOf(UINT32_MAX), 32u);
+    EXPECT_EQ(Log2Histogram::binUpperBound(0), 0u);
+    EXPECT_EQ(Log2Histogram::binUpperBound(3), 7u);
+    EXPECT_EQ(Log2Histogram::binUpperBound(32), UINT32_MAX);
+}
+
+TEST(Log2Histogram, RecordsCountSumAndMax)
+{
+    Log2Histogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+
+    for (uint32_t v : {0u, 1u, 2u, 3u, 5u, 9u})
+        h.record(v);
+    EXPECT_EQ(h.total(), 6u);
+    EXPECT_EQ(h.sum(), 20u);
+    EXPECT_EQ(h.max(), 9u);
+    EXPECT_EQ(h.count(2), 2u); // 2 and 3
+    EXPECT_DOUBLE_EQ(h.mean(), 20.0 / 6.0);
+    EXPECT_EQ(h.sumSquares(), 120u);
+    EXPECT_DOUBLE_EQ(h.weightedMean(), 6.0);
+
+    h.clear();
+    EXPECT_EQ(h.total(), 0u);
+    EXPECT_EQ(h.max(), 0u);
+}
+
+TEST(Log2Histogram, PercentilesAreBinUpperBounds)
+{
+    Log2Histogram h;
+    for (int i = 0; i < 90; ++i)
+        h.record(2);
+    for (int i = 0; i < 10; ++i)
+        h.record(100);
+
+    EXPECT_EQ(h.percentile(0.5), 3u);
+    EXPECT_EQ(h.percentile(0.9), 3u);
+    EXPECT_EQ(h.percentile(0.91), 100u); // bin [64, 127] capped at the max
+    EXPECT_EQ(h.percentile(1.0), 100u);
+    EXPECT_EQ(h.percentile(0.0), 3u);
+}
+
+TEST(Log2Histogram, PercentileRanksRoundUp)
+{
+    // p * total lands just above a whole rank, which takes the next value
+    Log2Histogram h;
+    for (uint32_t v : {0u, 1u})
+    {
+        for (int i = 0; i < 1000000; ++i)
+            h.record(v);
+    }
+
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    EXPECT_EQ(h.percentile(0.5 + 5e-14), 1u);
+}
+
+TEST(Log2Histogram, GrowingMatchesRecordingFinalSizes)
+{
+    // three buckets filled one element at a time end up as if recorded at 1, 4 and 9
+    Log2Histogram grown;
+    for (uint32_t size : {1u, 4u, 9u})
+    {
+        for (uint32_t s = 1; s <= size; ++s)
+            grown.grown(s);
+    }
+
+    Log2Histogram recorded;
+    for (uint32_t size : {1u, 4u, 9u})
+        recorded.record(size);
+
+    EXPECT_EQ(grown.total(), recorded.total());
+    EXPECT_EQ(grown.sum(), recorded.sum());
+    EXPECT_EQ(grown.sumSquares(), recorded.sumSquares());
+    EXPECT_EQ(grown.max(), recorded.max());
+    for (size_t bin = 0; bin < Log2Histogram::Bins; ++bin)
+        EXPECT_EQ(grown.count(bin), recorded.count(bin)) << bin;
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "core/page_allocator.hpp"
+#include "core/memory_arena.hpp"
+#include "core/free_list.hpp"
+#include "core/soa_field.hpp"
+#include "particlesim/parallel_scheduler.hpp"
+
+using namespace core;
+
+static const PageBacking AllBackings[] = {PageBacking::Default, PageBacking::SmallPages,
+                                          PageBacking::HugeAdvise, PageBacking::HugeExplicit};
+
+TEST(PageAllocatorTest, VectorsWorkOnEveryBacking)
+{
+    for (PageBacking backing : AllBackings)
+    {
+        // below and above the mapping threshold
+        for (size_t n : {size_t{100}, size_t{1} << 20})
+        {
+            std::vector<uint32_t, PageAllocator<uint32_t>> v{PageAllocator<uint32_t>(backing)};
+            for (size_t i = 0; i < n; ++i)
+                v.push_back(static_cast<uint32_t>(i));
+
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(v.data()) % 64, 0u);
+            EXPECT_EQ(v[n - 1], n - 1);
+        }
+    }
+}
+
+TEST(PageAllocatorTest, DefaultBackingIsPickedUpAtConstruction)
+{
+    setDefaultPageBacking(PageBacking::HugeAdvise);
+    PageAllocator<float> advised;
+    setDefaultPageBacking(PageBacking::Default);
+
+    EXPECT_EQ(advised.backing(), PageBacking::HugeAdvise);
+    EXPECT_EQ(PageAllocator<float>().backing(), PageBacking::Default);
+    EXPECT_TRUE(PageAllocator<int>(advised) == advised);
+}
+
+TEST(PageAllocatorTest, SoAColumnsKeepContentsWhenMoved)
+{
+    SoAFieldScalar<float, struct ValueTag> field;
+    field.reserve(1 << 16);
+    for (int i = 0; i < 1000; ++i)
+        field.push_back(static_cast<float>(i));
+
+    field.setPageBacking(PageBacking::HugeAdvise);
+
+    EXPECT_EQ(field.storage[0].get_allocator().backing(), PageBacking::HugeAdvise);
+    EXPECT_GE(field.storage[0].capacity(), size_t{1} << 16);
+    ASSERT_EQ(field.size(), 1000u);
+    EXPECT_EQ(field[999], 999.f);
+}
+
+TEST(PageAllocatorTest, ArenaAndPoolOnHugePages)
+{
+    FrameArena arena(1024 * 1024, ArenaGrowth::Chain, PageBacking::HugeAdvise);
+    int *values = arena.allocateArray<int>(400000);
+    values[399999] = 7;
+    EXPECT_EQ(values[399999], 7);
+    EXPECT_GT(arena.stats().chunks, 1u);
+
+    FreeListPool<double> pool(100000, PageBacking::HugeExplicit);
+    const size_t index = pool.allocate();
+    pool.get(index) = 2.5;
+    EXPECT_EQ(pool.get(index), 2.5);
+}
+
+TEST(PageAllocatorTest, FirstTouchZeroesWholeRange)
+{
+    particlesim::ParallelScheduler scheduler(3);
+    PageAllocator<float> allocator(PageBacking::SmallPages);
+    const size_t n = 300000;
+    float *data = allocator.allocate(n);
+    data[n / 2] = 1.f;
+
+    scheduler.firstTouch(data, n);
+
+    for (size_t i = 0; i < n; i += 997)
+        EXPECT_EQ(data[i], 0.f);
+    EXPECT_EQ(data[n / 2], 0.f);
+    allocator.deallocate(data, n);
+}
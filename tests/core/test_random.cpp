@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "core/random.hpp"
+
+using namespace core;
+
+// known answers from the Random123 distribution (kat_vectors)
+TEST(Philox4x32Test, MatchesKnownAnswers)
+{
+    EXPECT_EQ(Philox4x32::generate({0, 0, 0, 0}, {0, 0}),
+              (Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox4x32::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(Philox4x32Test, LanesMatchSingleBlocks)
+{
+    const auto key = Philox4x32::keyFromSeed(0x123456789abcdefull);
+    const uint64_t first = 0xfffffff8ull; // lanes cross into the high counter word
+
+    uint32_t out[4][16];
+    Philox4x32::generateLanes(first, 3, 7, key, out);
+
+    for (uint32_t l = 0; l < 16; ++l)
+    {
+        const uint64_t index = first + l;
+        const auto block = Philox4x32::generate({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), 3, 7}, key);
+        for (int w = 0; w < 4; ++w)
+            EXPECT_EQ(out[w][l], block[w]);
+    }
+}
+
+TEST(Philox4x32Test, UniformFloatStaysInUnitInterval)
+{
+    EXPECT_EQ(uniformFloat(0u), 0.f);
+    EXPECT_LT(uniformFloat(0xffffffffu), 1.f);
+    EXPECT_FLOAT_EQ(uniformFloat(0x80000000u), 0.5f);
+
+    double sum = 0.0;
+    const int n = 1 << 16;
+    for (int i = 0; i < n; ++i)
+        sum += uniformFloat(Philox4x32::generate({static_cast<uint32_t>(i), 0, 0, 0}, {1, 2})[0]);
+    EXPECT_NEAR(sum / n, 0.5, 0.01);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "core/timing_wheel.hpp"
+
+using namespace core;
+
+TEST(TimingWheelTest, ExpiresAtScheduledTick)
+{
+    TimingWheel<int> wheel;
+    wheel.schedule(3, 30);
+    wheel.schedule(1, 10);
+    wheel.schedule(3, 31);
+
+    std::vector<int> fired;
+    auto collect = [&](int v, uint64_t)
+    { fired.push_back(v); };
+
+    wheel.advance(0, collect);
+    EXPECT_TRUE(fired.empty());
+
+    wheel.advance(2, collect);
+    EXPECT_EQ(fired, std::vector<int>({10}));
+
+    wheel.advance(3, collect);
+    EXPECT_EQ(fired.size(), 3u);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, OverdueEntriesFireOnNextAdvance)
+{
+    TimingWheel<int> wheel(100);
+    wheel.schedule(50, 1);
+    wheel.schedule(100, 2);
+
+    int fired = 0;
+    wheel.advance(100, [&](int, uint64_t)
+                  { ++fired; });
+    EXPECT_EQ(fired, 2);
+}
+
+TEST(TimingWheelTest, CascadesAcrossLevelsAndOverflow)
+{
+    TimingWheel<uint64_t> wheel;
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> ticks = {63, 64, 65, 4095, 4096, 4097, 262143, 262144, 16777215, 16777216, 16777300};
+    for (int i = 0; i < 500; ++i)
+        ticks.push_back(1 + rng() % 20000000);
+
+    for (uint64_t t : ticks)
+        wheel.schedule(t, t);
+
+    std::vector<uint64_t> fired;
+    uint64_t now = 0;
+    while (wheel.size() > 0)
+    {
+        const uint64_t previous = now;
+        now += 1 + rng() % 5000;
+        wheel.advance(now, [&](uint64_t v, uint64_t due)
+                      {
+            EXPECT_EQ(v, due);
+            EXPECT_LE(due, now);
+            EXPECT_GT(due, previous);
+            fired.push_back(v); });
+    }
+
+    std::sort(ticks.begin(), ticks.end());
+    std::sort(fired.begin(), fired.end());
+    EXPECT_EQ(fired, ticks);
+}
+
+TEST(TimingWheelTest, JumpsWhenEmpty)
+{
+    TimingWheel<int> wheel;
+    wheel.advance(1000000, [](int, uint64_t) {});
+    EXPECT_EQ(wheel.now(), 1000000u);
+
+    wheel.schedule(1000001, 7);
+    int fired = 0;
+    wheel.advance(1000001, [&](int v, uint64_t)
+                  { fired = v; });
+    EXPECT_EQ(fired, 7);
+}
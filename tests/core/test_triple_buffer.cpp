@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "core/triple_buffer.hpp"
+#include <array>
+#include <atomic>
+#include <thread>
+
+using namespace core;
+
+TEST(TripleBuffer, ReaderSeesTheLatestPublish) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.acquire());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+    buffer.back() = 3; // not published
+
+    EXPECT_TRUE(buffer.acquire());
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_FALSE(buffer.acquire());
+    EXPECT_EQ(buffer.front(), 2);
+
+    buffer.publish();
+    EXPECT_TRUE(buffer.acquire());
+    EXPECT_EQ(buffer.front(), 3);
+}
+
+TEST(TripleBuffer, WriterNeverTouchesTheFrontBuffer) {
+    TripleBuffer<int> buffer;
+    buffer.back() = 7;
+    buffer.publish();
+    ASSERT_TRUE(buffer.acquire());
+    const int *front = &buffer.front();
+
+    // however often the writer publishes, it cycles through the two other buffers
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_NE(&buffer.back(), front);
+        buffer.back() = 100 + i;
+        buffer.publish();
+    }
+    EXPECT_EQ(*front, 7);
+}
+
+TEST(TripleBuffer, NoTearingAcrossThreads) {
+    using Block = std::array<uint64_t, 64>;
+    TripleBuffer<Block> buffer;
+    constexpr uint64_t Frames = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]
+                       {
+                           for (uint64_t f = 1; f <= Frames; ++f)
+                           {
+                               buffer.back().fill(f);
+                               buffer.publish();
+                           }
+                           done = true; });
+
+    uint64_t last = 0;
+    size_t seen = 0, torn = 0, backwards = 0;
+    for (;;)
+    {
+        const bool finished = done.load();
+        if (!buffer.acquire())
+        {
+            if (finished)
+                break;
+            continue;
+        }
+        const Block &b = buffer.front();
+        for (uint64_t v : b)
+            torn += v != b[0];
+        backwards += b[0] <= last;
+        last = b[0];
+        ++seen;
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(backwards, 0u);
+    EXPECT_EQ(buffer.front()[0], Frames);
+    EXPECT_GT(seen, 0u);
+}
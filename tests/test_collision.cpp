@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "particlesim/collision.hpp"
+#include "particlesim/particle_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+using namespace core;
+using namespace std;
+
+struct Columns
+{
+    vector<float> px, py, vx, vy, ax, ay, life;
+    vector<uint8_t> alive;
+
+    explicit Columns(size_t n) : px(n), py(n), vx(n), vy(n), ax(n), ay(n), life(n, 1.f), alive(n, 1) {}
+
+    ParticleSoAView view()
+    {
+        return {px.data(), py.data(), vx.data(), vy.data(), ax.data(), ay.data(), life.data(), alive.data(), px.size()};
+    }
+
+    vector<Vector2D> positions() const
+    {
+        vector<Vector2D> out(px.size());
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = {px[i], py[i]};
+        return out;
+    }
+};
+
+static PartitioningConfig collisionGrid()
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    cfg.world = {0, 0, 20, 20};
+    return cfg;
+}
+
+static void buildGrid(UniformGrid &grid, const vector<Vector2D> &pos)
+{
+    grid.clear();
+    grid.setData({pos, {}});
+    grid.build();
+}
+
+TEST(CollisionSolver, OverlappingPairIsPushedToContactDistance)
+{
+    Columns c(2);
+    c.px = {5.f, 5.6f};
+    c.py = {5.f, 5.f};
+
+    UniformGrid grid(collisionGrid());
+    auto pos = c.positions();
+    buildGrid(grid, pos);
+
+    CollisionSolver solver({0.5f, 0.f, 1, 1.f, false});
+    solver.solve(grid, c.view(), 0.1f);
+
+    EXPECT_EQ(solver.contactCount(), 1u);
+    EXPECT_EQ(solver.resolvedCount(), 1u);
+    EXPECT_NEAR(c.px[1] - c.px[0], 1.f, 1e-5f);
+    EXPECT_NEAR(c.px[0] + c.px[1], 10.6f, 1e-5f); // centre of mass is kept
+}
+
+TEST(CollisionSolver, DeadParticlesDoNotCollide)
+{
+    Columns c(2);
+    c.px = {5.f, 5.2f};
+    c.py = {5.f, 5.f};
+    c.alive[1] = 0;
+
+    UniformGrid grid(collisionGrid());
+    auto pos = c.positions();
+    buildGrid(grid, pos);
+
+    CollisionSolver solver({});
+    solver.solve(grid, c.view(), 0.1f);
+    EXPECT_EQ(solver.contactCount(), 0u);
+    EXPECT_FLOAT_EQ(c.px[1], 5.2f);
+}
+
+TEST(CollisionSolver, VelocityAbsorbsCorrection)
+{
+    Columns c(2);
+    c.px = {5.f, 5.6f};
+    c.py = {5.f, 5.f};
+
+    UniformGrid grid(collisionGrid());
+    auto pos = c.positions();
+    buildGrid(grid, pos);
+
+    CollisionSolver solver({0.5f, 0.f, 1, 1.f, true});
+    solver.solve(grid, c.view(), 0.1f);
+
+    EXPECT_NEAR(c.vx[0], -2.f, 1e-4f);
+    EXPECT_NEAR(c.vx[1], 2.f, 1e-4f);
+}
+
+TEST(CollisionSolver, ParallelMatchesSerialExactly)
+{
+    const size_t n = 3000;
+    Columns serial(n);
+    mt19937 rng(5);
+    uniform_real_distribution<float> dist(0.f, 20.f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        serial.px[i] = dist(rng);
+        serial.py[i] = dist(rng);
+    }
+    Columns parallel = serial;
+
+    UniformGrid grid(collisionGrid());
+    auto pos = serial.positions();
+    buildGrid(grid, pos);
+
+    CollisionSolver a({0.3f, 0.1f, 4, 1.f, true});
+    CollisionSolver b({0.3f, 0.1f, 4, 1.f, true});
+    ParallelScheduler scheduler(4);
+    a.solve(grid, serial.view(), 0.016f);
+    b.solve(grid, parallel.view(), 0.016f, &scheduler);
+
+    EXPECT_GT(a.contactCount(), 0u);
+    EXPECT_EQ(a.resolvedCount(), b.resolvedCount());
+    EXPECT_EQ(serial.px, parallel.px);
+    EXPECT_EQ(serial.py, parallel.py);
+}
+
+TEST(CollisionSolver, IterationsReduceOverlap)
+{
+    const size_t n = 1500;
+    Columns c(n);
+    mt19937 rng(8);
+    uniform_real_distribution<float> dist(5.f, 15.f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        c.px[i] = dist(rng);
+        c.py[i] = dist(rng);
+    }
+
+    auto totalOverlap = [&](const vector<Vector2D> &p)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < p.size(); ++i)
+            for (size_t j = i + 1; j < p.size(); ++j)
+            {
+                float d = std::hypot(p[i].x - p[j].x, p[i].y - p[j].y);
+                total += max(0.f, 0.2f - d);
+            }
+        return total;
+    };
+
+    UniformGrid grid(collisionGrid());
+    auto before = c.positions();
+    buildGrid(grid, before);
+
+    CollisionSolver solver({0.1f, 0.1f, 8, 1.f, false});
+    solver.solve(grid, c.view(), 0.016f);
+
+    EXPECT_LT(totalOverlap(c.positions()), 0.5 * totalOverlap(before));
+}
+
+TEST(CollisionSolver, ParticleSystemStageResolvesOverlap)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(16);
+    ps.setPartition(std::make_unique<UniformGrid>(collisionGrid()));
+    ps.setCollisionSolver(std::make_unique<CollisionSolver>(CollisionConfig{0.5f, 0.f, 2, 1.f, true}));
+
+    Particle a = make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f);
+    Particle b = a;
+    a.position = {5.f, 5.f};
+    b.position = {5.5f, 5.f};
+    ps.addParticle(a);
+    ps.addParticle(b);
+
+    ps.update(0.016f);
+
+    auto out = ps.get();
+    EXPECT_NEAR(out[1].position.x - out[0].position.x, 1.f, 1e-4f);
+}
+
+TEST(CollisionSolver, ParticleSystemGridHoldsResolvedPositions)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(16);
+    auto owned = std::make_unique<UniformGrid>(collisionGrid());
+    UniformGrid &grid = *owned;
+    ps.setPartition(std::move(owned));
+    ps.setCollisionSolver(std::make_unique<CollisionSolver>(CollisionConfig{0.5f, 0.f, 2, 1.f, true}));
+
+    // both start in cell (5, 5), the push moves the first one over into cell (4, 5)
+    Particle a = make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f);
+    Particle b = a;
+    a.position = {5.2f, 5.5f};
+    b.position = {5.6f, 5.5f};
+    ps.addParticle(a);
+    ps.addParticle(b);
+
+    ps.update(0.016f);
+
+    ASSERT_LT(ps.get()[0].position.x, 5.f);
+    const auto left = grid.cellParticles(4, 5);
+    const auto right = grid.cellParticles(5, 5);
+    ASSERT_EQ(left.size(), 1u);
+    EXPECT_EQ(left[0], 0u);
+    ASSERT_EQ(right.size(), 1u);
+    EXPECT_EQ(right[0], 1u);
+
+    const auto neighbors = grid.queryNeighborhood(0);
+    ASSERT_EQ(neighbors.size(), 1u);
+    EXPECT_EQ(neighbors[0], 1u);
+}
+
+TEST(CollisionSolver, DisplacedWakesSleepingParticles)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(16);
+    ps.setPartition(std::make_unique<UniformGrid>(collisionGrid()));
+    ps.setCollisionSolver(std::make_unique<CollisionSolver>(CollisionConfig{0.5f, 0.f, 2, 1.f, true}));
+    ps.layout().setRestConfig({true, 0.01f, 0.01f, 2});
+
+    Particle resting = make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f);
+    resting.position = {5.f, 5.f};
+    ps.addParticle(resting);
+    for (int i = 0; i < 3; ++i)
+        ps.update(0.016f);
+    ASSERT_EQ(ps.layout().sleepingCount(), 1u);
+
+    // lands on the sleeper - the block wakes on add, the push keeps the sleeper awake
+    Particle incoming = resting;
+    incoming.position = {5.5f, 5.f};
+    ps.addParticle(incoming);
+    ps.update(0.016f);
+
+    EXPECT_EQ(ps.layout().sleepingCount(), 0u);
+    auto out = ps.get();
+    EXPECT_LT(out[0].position.x, 5.f);
+    EXPECT_LT(out[0].velocity.x, 0.f);
+}
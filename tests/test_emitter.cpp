@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "particlesim/emitter.hpp"
+#include "particlesim/particle_system.hpp"
+
+using namespace particlesim;
+
+static bool same(const Vector2D &a, const Vector2D &b) { return a.x == b.x && a.y == b.y; }
+static float length(const Vector2D &v) { return std::hypot(v.x, v.y); }
+
+static EmitterConfig discConfig()
+{
+    EmitterConfig cfg;
+    cfg.shape = EmitterShape::Disc;
+    cfg.origin = {10.f, -5.f};
+    cfg.radius = 3.f;
+    cfg.minSpeed = 1.f;
+    cfg.maxSpeed = 2.f;
+    cfg.minLifetime = 0.5f;
+    cfg.maxLifetime = 4.f;
+    cfg.accelerationJitter = 0.25f;
+    cfg.seed = 42;
+    return cfg;
+}
+
+TEST(ParticleEmitter, SameParticlesWhateverTheSplit)
+{
+    ParticleEmitter emitter(discConfig());
+
+    ParticleSystemDataSoA whole(200);
+    emitter.emit(whole, 100);
+
+    ParticleEmitter pieces(discConfig());
+    ParticleSystemDataSoA split(200);
+    pieces.emit(split, 7);
+    pieces.emit(split, 50);
+    pieces.emit(split, 43);
+
+    ParticleEmitter threaded(discConfig());
+    ParticleSystemDataSoA parallel(200);
+    ParallelScheduler scheduler(3);
+    threaded.emit(parallel, 100, &scheduler);
+
+    auto a = whole.get();
+    auto b = split.get();
+    auto c = parallel.get();
+    ASSERT_EQ(a.size(), 100u);
+    ASSERT_EQ(b.size(), 100u);
+    ASSERT_EQ(c.size(), 100u);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_TRUE(same(a[i].position, b[i].position));
+        EXPECT_TRUE(same(a[i].velocity, c[i].velocity));
+        EXPECT_EQ(a[i].lifetime, c[i].lifetime);
+        EXPECT_TRUE(same(a[i].acceleration, b[i].acceleration));
+    }
+
+    // a single particle is the same element of the sequence
+    const Particle p = emitter.sample(uint64_t{37});
+    EXPECT_TRUE(same(p.position, a[37].position));
+    EXPECT_TRUE(same(p.velocity, a[37].velocity));
+}
+
+TEST(ParticleEmitter, SeedChangesTheSequence)
+{
+    EmitterConfig cfg = discConfig();
+    const Particle a = ParticleEmitter(cfg).sample(uint64_t{0});
+    cfg.seed = 43;
+    const Particle b = ParticleEmitter(cfg).sample(uint64_t{0});
+    EXPECT_FALSE(same(a.position, b.position));
+}
+
+TEST(ParticleEmitter, ShapesStayInsideTheirBounds)
+{
+    EmitterConfig cfg = discConfig();
+    for (EmitterShape shape : {EmitterShape::Point, EmitterShape::Box, EmitterShape::Disc, EmitterShape::Cone})
+    {
+        cfg.shape = shape;
+        cfg.direction = 1.f;
+        cfg.spread = 0.3f;
+        ParticleEmitter emitter(cfg);
+
+        for (uint64_t i = 0; i < 500; ++i)
+        {
+            const Particle p = emitter.sample(i);
+            const Vector2D d = p.position - cfg.origin;
+            const float speed = length(p.velocity);
+
+            EXPECT_TRUE(p.alive);
+            EXPECT_GE(p.lifetime, cfg.minLifetime);
+            EXPECT_LE(p.lifetime, cfg.maxLifetime);
+            EXPECT_GE(speed, cfg.minSpeed - 1e-4f);
+            EXPECT_LE(speed, cfg.maxSpeed + 1e-4f);
+            EXPECT_LE(std::abs(p.acceleration.x), cfg.accelerationJitter);
+
+            switch (shape)
+            {
+            case EmitterShape::Point:
+                EXPECT_TRUE(same(p.position, cfg.origin));
+                break;
+            case EmitterShape::Box:
+                EXPECT_LE(std::abs(d.x), cfg.halfExtents.x);
+                EXPECT_LE(std::abs(d.y), cfg.halfExtents.y);
+                break;
+            case EmitterShape::Disc:
+                EXPECT_LE(length(d), cfg.radius + 1e-4f);
+                break;
+            case EmitterShape::Cone:
+            {
+                // inside the sector and moving straight away from the origin
+                EXPECT_LE(length(d), cfg.radius + 1e-4f);
+                const float angle = std::atan2(d.y, d.x);
+                EXPECT_NEAR(angle, cfg.direction, cfg.spread + 1e-4f);
+                EXPECT_NEAR(std::atan2(p.velocity.y, p.velocity.x), angle, 1e-3f);
+                break;
+            }
+            }
+
+            if (shape != EmitterShape::Cone)
+            {
+                EXPECT_NEAR(std::atan2(p.velocity.y, p.velocity.x), cfg.direction, cfg.spread + 1e-4f);
+            }
+        }
+    }
+}
+
+TEST(ParticleSystemSoATest, AppendAddsZeroedLiveParticles)
+{
+    ParticleSystemDataSoA system(16);
+    Particle first;
+    first.lifetime = 3.f;
+    system.add(first);
+
+    ParticleSoAView out = system.append(4);
+    ASSERT_EQ(out.count, 4u);
+    ASSERT_EQ(system.size(), 5u);
+    out.lifetime[2] = 1.f;
+    out.velX[2] = 2.f;
+
+    auto particles = system.get();
+    EXPECT_EQ(particles[0].lifetime, 3.f);
+    EXPECT_TRUE(particles[1].alive);
+    EXPECT_EQ(particles[1].updateTier, 1);
+    EXPECT_EQ(particles[3].lifetime, 1.f);
+    EXPECT_EQ(particles[3].velocity.x, 2.f);
+
+    // zero lifetimes die on the next compacting update
+    system.update(0.1f, true);
+    EXPECT_EQ(system.size(), 2u);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "particlesim/grid_tuner.hpp"
+#include "particlesim/particle_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+
+namespace
+{
+    std::vector<Vector2D> uniformScene(size_t n, float extent, unsigned seed = 11)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(0.f, extent);
+        std::vector<Vector2D> pos(n);
+        for (auto &p : pos)
+            p = {dist(rng), dist(rng)};
+        return pos;
+    }
+
+    UniformGrid makeGrid(float cellSize)
+    {
+        PartitioningConfig cfg;
+        cfg.cellSize = cellSize;
+        cfg.world = {0.f, 0.f, 100.f, 100.f};
+        return UniformGrid(cfg);
+    }
+
+    // one frame as ParticleSystem runs it: build, then the tuner looks before the next clear()
+    bool frame(UniformGrid &grid, GridAutoTuner &tuner, const std::vector<Vector2D> &pos, bool query = false, float floor = 0.f)
+    {
+        grid.clear();
+        grid.setData({pos, nullptr});
+        grid.build();
+        if (query)
+        {
+            for (uint32_t i = 0; i < pos.size(); i += 7)
+                grid.queryNeighborhood(i);
+        }
+        return tuner.observe(grid, floor);
+    }
+
+    GridTunerConfig quickConfig()
+    {
+        GridTunerConfig cfg;
+        cfg.window = 4;
+        cfg.cooldown = 2;
+        return cfg;
+    }
+}
+
+TEST(GridAutoTuner, GrowsCellsOfASparseGrid)
+{
+    // 10000 particles over 100x100 at cell size 0.5 is 0.25 per cell, far below the target of 4
+    UniformGrid grid = makeGrid(0.5f);
+    GridAutoTuner tuner(quickConfig());
+    const auto pos = uniformScene(10000, 100.f);
+
+    bool resized = false;
+    for (int f = 0; f < 4; ++f)
+        resized = frame(grid, tuner, pos);
+    ASSERT_TRUE(resized);
+    EXPECT_EQ(tuner.resizeCount(), 1u);
+    // sqrt(4 / 1) per unit area, give or take the mean over non-empty cells
+    EXPECT_GT(grid.config.cellSize, 1.5f);
+    EXPECT_LT(grid.config.cellSize, 2.5f);
+    EXPECT_EQ(grid.stats().nonEmptyCells(), 0u); // empty until the next build
+}
+
+TEST(GridAutoTuner, ShrinksCellsOfADenseGrid)
+{
+    UniformGrid grid = makeGrid(10.f);
+    GridAutoTuner tuner(quickConfig());
+    const auto pos = uniformScene(10000, 100.f);
+
+    for (int f = 0; f < 4; ++f)
+        frame(grid, tuner, pos, true);
+    EXPECT_EQ(tuner.resizeCount(), 1u);
+    EXPECT_NEAR(tuner.lastOccupancy(), 100.f, 15.f);
+    EXPECT_NEAR(grid.config.cellSize, 2.f, 0.3f);
+}
+
+TEST(GridAutoTuner, SettlesWithoutOscillating)
+{
+    UniformGrid grid = makeGrid(8.f);
+    GridAutoTuner tuner(quickConfig());
+    const auto pos = uniformScene(10000, 100.f);
+
+    for (int f = 0; f < 200; ++f)
+        frame(grid, tuner, pos, f % 2 == 0);
+    EXPECT_LE(tuner.resizeCount(), 2u);
+
+    const float settled = grid.config.cellSize;
+    const uint32_t resizes = tuner.resizeCount();
+    for (int f = 0; f < 200; ++f)
+        frame(grid, tuner, pos, f % 2 == 0);
+    EXPECT_EQ(tuner.resizeCount(), resizes);
+    EXPECT_EQ(grid.config.cellSize, settled);
+    EXPECT_GE(tuner.lastOccupancy(), 4.f / 1.5f);
+    EXPECT_LE(tuner.lastOccupancy(), 4.f * 1.5f);
+}
+
+TEST(GridAutoTuner, FollowsDensityChanges)
+{
+    UniformGrid grid = makeGrid(2.f);
+    GridAutoTuner tuner(quickConfig());
+
+    // the same particles squeezed into a tenth of the width and height
+    auto pos = uniformScene(10000, 100.f);
+    for (int f = 0; f < 40; ++f)
+        frame(grid, tuner, pos, true);
+    const float spread = grid.config.cellSize;
+
+    for (auto &p : pos)
+        p = p * 0.1f;
+    for (int f = 0; f < 40; ++f)
+        frame(grid, tuner, pos, true);
+    EXPECT_LT(grid.config.cellSize, spread * 0.25f);
+}
+
+TEST(GridAutoTuner, RespectsTheFloorAndTheHotspotLimit)
+{
+    UniformGrid grid = makeGrid(10.f);
+    GridAutoTuner tuner(quickConfig());
+    const auto pos = uniformScene(10000, 100.f);
+    for (int f = 0; f < 4; ++f)
+        frame(grid, tuner, pos, false, 5.f);
+    EXPECT_EQ(grid.config.cellSize, 5.f);
+
+    // a sparse scene wants larger cells, but one packed cell already holds 400 particles
+    GridTunerConfig cfg = quickConfig();
+    cfg.maxOccupancy = 500;
+    UniformGrid sparse = makeGrid(1.f);
+    GridAutoTuner limited(cfg);
+    auto few = uniformScene(200, 100.f);
+    few.insert(few.end(), 400, Vector2D(50.5f, 50.5f));
+    for (int f = 0; f < 4; ++f)
+        frame(sparse, limited, few);
+    EXPECT_LE(sparse.config.cellSize, 1.2f);
+}
+
+TEST(GridAutoTuner, ParticleSystemKeepsCellsAboveTheInteractionRadius)
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 4.f;
+    cfg.world = {0.f, 0.f, 100.f, 100.f};
+    ParticleSystem<ParticleSystemDataSoA> ps(2000, std::make_unique<UniformGrid>(cfg));
+
+    InteractionConfig interactions;
+    interactions.radius = 3.f;
+    ps.setInteractions(std::make_unique<ParticleInteractions>(interactions));
+    ps.setGridTuner(std::make_unique<GridAutoTuner>(quickConfig()));
+
+    // dense enough that the tuner would go well below the radius on its own
+    for (const auto &p : uniformScene(2000, 20.f))
+    {
+        Particle particle = make_test_particle(0.f, 0.f, 0.f, 0.f, 100.f);
+        particle.position = p;
+        ps.addParticle(particle);
+    }
+    for (int f = 0; f < 20; ++f)
+        ps.update(0.01f);
+
+    EXPECT_EQ(ps.stats().partition.particles, 2000u);
+    EXPECT_FLOAT_EQ(ps.stats().partition.cells, 34u * 34u); // ceil(100 / 3)^2
+}
@@ -1,4 +1,6 @@
 #include "particlesim/particle_system.hpp"
+#include "particlesim/particle_world.hpp"
+#include <algorithm>
 
 namespace particlesim
 {
@@ -9,7 +11,9 @@ namespace particlesim
 
         for (size_t index : activeIndices_)
         {
-            out.push_back(pool_.get(index));
+            Particle p = pool_.get(index);
+            p.lifetime = static_cast<float>(deathTime_[index] - time_);
+            out.push_back(p);
         }
 
         return out;
@@ -31,6 +35,105 @@ namespace particlesim
             p.lifetime = life[i];
             p.alive = (alive[i] != 0);
 
+            p.updateTier = particles.field<Tier>()[i];
+
+            // sleeping blocks have not taken the skipped time off yet
+            const size_t block = i / BlockSize;
+            if (block < blocks_.size() && blocks_[block].sleeping && p.alive)
+                p.lifetime -= blocks_[block].sleepTime;
+
+            out.push_back(p);
+        }
+
+        return out;
+    }
+
+    std::vector<Particle> ParticleSystemDataBallistic::get()
+    {
+        std::vector<Particle> out;
+        out.reserve(size());
+
+        auto positionsNow = positions();
+        auto &[pos, vel, acc, spawn, death] = fields();
+        const float now = localTime();
+
+        for (size_t i = 0; i < size(); i++)
+        {
+            const float t = std::min(death[i], now) - spawn[i];
+
+            Particle p;
+            p.position = positionsNow[i];
+            p.velocity = {vel.storage[0][i] + acc.storage[0][i] * t, vel.storage[1][i] + acc.storage[1][i] * t};
+            p.acceleration = {acc.storage[0][i], acc.storage[1][i]};
+            p.lifetime = death[i] - now;
+            p.alive = death[i] > now;
+
+            out.push_back(p);
+        }
+
+        return out;
+    }
+
+    std::vector<Particle> ParticleSystemDataCohort::get()
+    {
+        std::vector<Particle> out;
+        out.reserve(size());
+
+        auto &[pos, vel, acc, death] = fields();
+
+        for (size_t i = 0; i < size(); i++)
+        {
+            const size_t slot = (head_ + i) & mask_;
+
+            Particle p;
+            p.position = {pos.x()[slot], pos.y()[slot]};
+            p.velocity = {vel.x()[slot], vel.y()[slot]};
+            p.acceleration = {acc.x()[slot], acc.y()[slot]};
+            p.lifetime = death[slot] - localTime();
+            p.alive = death[slot] > localTime();
+
+            out.push_back(p);
+        }
+
+        return out;
+    }
+
+    std::vector<Particle> ParticleSystemDataQuantized::get()
+    {
+        std::vector<Particle> out;
+        out.reserve(size());
+
+        auto &[pos, vel, acc, life] = fields();
+
+        for (size_t i = 0; i < size(); i++)
+        {
+            Particle p;
+            p.position = {world_.minX + pos.x()[i] * stepX_, world_.minY + pos.y()[i] * stepY_};
+            p.velocity = {halfToFloat(vel.x()[i]), halfToFloat(vel.y()[i])};
+            p.acceleration = {halfToFloat(acc.x()[i]), halfToFloat(acc.y()[i])};
+            p.lifetime = life[i] * quantum_;
+            p.alive = life[i] > 0;
+
+            out.push_back(p);
+        }
+
+        return out;
+    }
+
+    std::vector<Particle> ParticleWorld::get(EmitterID id)
+    {
+        const ParticleSoAView v = view(id);
+
+        std::vector<Particle> out;
+        out.reserve(v.count);
+        for (size_t i = 0; i < v.count; i++)
+        {
+            Particle p;
+            p.position = {v.posX[i], v.posY[i]};
+            p.velocity = {v.velX[i], v.velY[i]};
+            p.acceleration = {v.accX[i], v.accY[i]};
+            p.lifetime = v.lifetime[i];
+            p.alive = v.alive[i] != 0;
             out.push_back(p);
         }
 
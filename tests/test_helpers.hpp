@@ -1,5 +1,8 @@
 #pragma once
 #include "particlesim/particle.hpp"
+#include <filesystem>
+#include <string>
+#include <unistd.h>
 
 namespace particlesim
 {
@@ -9,4 +12,16 @@ namespace particlesim
 
     Particle makeDeadParticle();
 
+    // a path in the temp directory, the file is removed again when the test ends
+    struct TempFile
+    {
+        std::string path;
+
+        explicit TempFile(const char *name)
+            : path((std::filesystem::temp_directory_path() / (std::string("particlesim_") + name + "_" + std::to_string(::getpid()))).string())
+        {
+        }
+        ~TempFile() { std::filesystem::remove(path); }
+    };
+
 } // namespace particlesim
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "particlesim/interactions.hpp"
+#include "particlesim/particle_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+using namespace core;
+using namespace std;
+
+static PartitioningConfig interactionGrid()
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    cfg.world = {0, 0, 20, 20};
+    return cfg;
+}
+
+static vector<Vector2D> cluster(size_t n, unsigned seed = 11)
+{
+    mt19937 rng(seed);
+    uniform_real_distribution<float> dist(0.f, 20.f);
+    vector<Vector2D> pos(n);
+    for (auto &p : pos)
+        p = {dist(rng), dist(rng)};
+    return pos;
+}
+
+TEST(ParticleInteractions, OverlappingPairRepelsSymmetrically)
+{
+    UniformGrid grid(interactionGrid());
+    vector<Vector2D> pos = {{5.0f, 5.0f}, {5.5f, 5.0f}, {15.f, 15.f}};
+    grid.setData({pos, {}});
+    grid.build();
+
+    ParticleInteractions forces({InteractionModel::SoftRepulsion, 1.f, 10.f});
+    forces.compute(grid, pos);
+
+    auto acc = forces.accelerations();
+    EXPECT_EQ(forces.pairsEvaluated(), 1u);
+    EXPECT_FLOAT_EQ(acc[0].x, -5.f);
+    EXPECT_FLOAT_EQ(acc[1].x, 5.f);
+    EXPECT_FLOAT_EQ(acc[0].y, 0.f);
+    EXPECT_FLOAT_EQ(acc[2].x, 0.f);
+}
+
+TEST(ParticleInteractions, PairsMatchBruteForceAndConserveMomentum)
+{
+    UniformGrid grid(interactionGrid());
+    auto pos = cluster(800);
+    grid.setData({pos, {}});
+    grid.build();
+
+    ParticleInteractions forces({InteractionModel::SoftRepulsion, 1.f, 10.f});
+    forces.compute(grid, pos);
+
+    uint64_t expectedPairs = 0;
+    for (size_t i = 0; i < pos.size(); ++i)
+        for (size_t j = i + 1; j < pos.size(); ++j)
+        {
+            float dx = pos[i].x - pos[j].x, dy = pos[i].y - pos[j].y;
+            if (dx * dx + dy * dy < 1.f)
+                ++expectedPairs;
+        }
+    EXPECT_EQ(forces.pairsEvaluated(), expectedPairs);
+
+    Vector2D total;
+    for (const auto &a : forces.accelerations())
+        total += a;
+    EXPECT_NEAR(total.x, 0.f, 1e-3f);
+    EXPECT_NEAR(total.y, 0.f, 1e-3f);
+}
+
+TEST(ParticleInteractions, ParallelMatchesSerial)
+{
+    UniformGrid grid(interactionGrid());
+    auto pos = cluster(2000);
+    grid.setData({pos, {}});
+    grid.build();
+
+    for (auto model : {InteractionModel::SoftRepulsion, InteractionModel::SPH})
+    {
+        InteractionConfig cfg;
+        cfg.model = model;
+        ParticleInteractions serial(cfg), parallel(cfg);
+        ParallelScheduler scheduler(4);
+
+        serial.compute(grid, pos);
+        parallel.compute(grid, pos, &scheduler);
+
+        EXPECT_EQ(serial.pairsEvaluated(), parallel.pairsEvaluated());
+        for (size_t i = 0; i < pos.size(); ++i)
+        {
+            EXPECT_NEAR(serial.accelerations()[i].x, parallel.accelerations()[i].x, 1e-4f);
+            EXPECT_NEAR(serial.accelerations()[i].y, parallel.accelerations()[i].y, 1e-4f);
+        }
+    }
+}
+
+TEST(ParticleInteractions, SPHDensityOfIsolatedParticleIsSelfContribution)
+{
+    UniformGrid grid(interactionGrid());
+    vector<Vector2D> pos = {{2.f, 2.f}, {2.3f, 2.f}, {10.f, 10.f}};
+    grid.setData({pos, {}});
+    grid.build();
+
+    InteractionConfig cfg;
+    cfg.model = InteractionModel::SPH;
+    cfg.radius = 1.f;
+    ParticleInteractions sph(cfg);
+    sph.compute(grid, pos);
+
+    const float self = 4.f / 3.14159265f;
+    EXPECT_NEAR(sph.densities()[2], self, 1e-5f);
+    EXPECT_GT(sph.densities()[0], self);
+    // denser than rest density - the pair is pushed apart
+    EXPECT_LT(sph.accelerations()[0].x, 0.f);
+    EXPECT_GT(sph.accelerations()[1].x, 0.f);
+}
+
+TEST(ParticleInteractions, ParticleSystemSeparatesOverlappingParticles)
+{
+    auto run = [](auto &ps)
+    {
+        ps.setPartition(std::make_unique<UniformGrid>(interactionGrid()));
+        ps.setInteractions(std::make_unique<ParticleInteractions>(InteractionConfig{InteractionModel::SoftRepulsion, 1.f, 10.f}));
+
+        Particle a = make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f);
+        Particle b = a;
+        a.position = {5.0f, 5.f};
+        b.position = {5.4f, 5.f};
+        ps.addParticle(a);
+        ps.addParticle(b);
+
+        ps.update(0.1f);
+        auto out = ps.get();
+        EXPECT_LT(out[0].velocity.x, 0.f);
+        EXPECT_GT(out[1].velocity.x, 0.f);
+        EXPECT_GT(out[1].position.x - out[0].position.x, 0.4f);
+    };
+
+    ParticleSystem<ParticleSystemDataAoS> aos(16);
+    ParticleSystem<ParticleSystemDataSoA> soa(16);
+    ParticleSystem<ParticleSystemDataAllocated> allocated(16);
+    run(aos);
+    run(soa);
+    run(allocated);
+}
+
+namespace
+{
+    struct CountingGrid : UniformGrid
+    {
+        using UniformGrid::UniformGrid;
+        int builds = 0;
+        void build() override
+        {
+            ++builds;
+            UniformGrid::build();
+        }
+    };
+}
+
+TEST(ParticleInteractions, ParticleSystemBuildsTheGridOncePerFrame)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(64);
+    auto owned = std::make_unique<CountingGrid>(interactionGrid());
+    CountingGrid &grid = *owned;
+    ps.setPartition(std::move(owned));
+    ps.setInteractions(std::make_unique<ParticleInteractions>(InteractionConfig{InteractionModel::SoftRepulsion, 1.f, 10.f}));
+    for (const Vector2D &p : cluster(32))
+    {
+        Particle particle = make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f);
+        particle.position = p;
+        ps.addParticle(particle);
+    }
+
+    // nothing built yet, then the interaction pass reuses the previous frame's closing build
+    ps.update(0.1f);
+    EXPECT_EQ(grid.builds, 2);
+    ps.update(0.1f);
+    ps.update(0.1f);
+    EXPECT_EQ(grid.builds, 4);
+
+    // a new particle is not in the last build
+    ps.addParticle(make_test_particle(0.f, 0.f, 0.f, 0.f, 10.f));
+    ps.update(0.1f);
+    EXPECT_EQ(grid.builds, 6);
+}
+
+TEST(ParticleInteractions, ParticleSystemRejectsInteractionsWithoutAGrid)
+{
+    auto interactions = []
+    { return std::make_unique<ParticleInteractions>(InteractionConfig{InteractionModel::SoftRepulsion, 1.f, 10.f}); };
+
+    ParticleSystem<ParticleSystemDataSoA> none(16);
+    EXPECT_THROW(none.setInteractions(interactions()), std::invalid_argument);
+
+    ParticleSystem<ParticleSystemDataSoA> tree(16, std::make_unique<KDTree>(interactionGrid()));
+    EXPECT_THROW(tree.setInteractions(interactions()), std::invalid_argument);
+
+    ParticleSystem<ParticleSystemDataSoA> grid(16, std::make_unique<UniformGrid>(interactionGrid()));
+    grid.setInteractions(interactions());
+    EXPECT_THROW(grid.setPartition(std::make_unique<KDTree>(interactionGrid())), std::invalid_argument);
+    EXPECT_THROW(grid.setPartition(nullptr), std::invalid_argument);
+}
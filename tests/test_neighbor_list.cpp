@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "particlesim/neighbor_list.hpp"
+
+using namespace particlesim;
+using namespace core;
+using namespace std;
+
+static vector<Vector2D> scatter(size_t n, float extent, unsigned seed = 3)
+{
+    mt19937 rng(seed);
+    uniform_real_distribution<float> dist(0.f, extent);
+    vector<Vector2D> pos(n);
+    for (auto &p : pos)
+        p = {dist(rng), dist(rng)};
+    return pos;
+}
+
+static PartitioningConfig gridConfig()
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 1.f;
+    cfg.world = {0, 0, 20, 20};
+    return cfg;
+}
+
+TEST(NeighborListCache, ListsContainEveryPairWithinCutoff)
+{
+    NeighborListCache cache(gridConfig(), {1.f, 0.5f});
+    auto pos = scatter(400, 20.f);
+
+    EXPECT_TRUE(cache.update(pos));
+    ASSERT_EQ(cache.size(), pos.size());
+
+    for (uint32_t i = 0; i < pos.size(); ++i)
+    {
+        auto span = cache.neighbors(i);
+        vector<uint32_t> got(span.begin(), span.end());
+        sort(got.begin(), got.end());
+
+        vector<uint32_t> expected;
+        for (uint32_t j = 0; j < pos.size(); ++j)
+        {
+            float dx = pos[j].x - pos[i].x, dy = pos[j].y - pos[i].y;
+            if (j != i && dx * dx + dy * dy <= 1.5f * 1.5f)
+                expected.push_back(j);
+        }
+        EXPECT_EQ(got, expected);
+    }
+}
+
+TEST(NeighborListCache, SmallMovesReuseLists)
+{
+    NeighborListCache cache(gridConfig(), {1.f, 0.4f});
+    auto pos = scatter(200, 20.f);
+    cache.update(pos);
+
+    for (auto &p : pos)
+        p.x += 0.15f; // below skin / 2
+
+    EXPECT_FALSE(cache.update(pos));
+    EXPECT_EQ(cache.rebuildCount(), 1u);
+}
+
+TEST(NeighborListCache, SingleFastParticleTriggersRebuild)
+{
+    NeighborListCache cache(gridConfig(), {1.f, 0.4f});
+    auto pos = scatter(200, 20.f);
+    cache.update(pos);
+
+    pos[123].y += 0.25f;
+
+    EXPECT_NEAR(cache.maxDisplacementSq(pos), 0.0625f, 1e-4f);
+    EXPECT_TRUE(cache.update(pos));
+    EXPECT_EQ(cache.rebuildCount(), 2u);
+}
+
+TEST(NeighborListCache, CountChangeOrInvalidateForcesRebuild)
+{
+    NeighborListCache cache(gridConfig(), {1.f, 0.4f});
+    auto pos = scatter(100, 20.f);
+    cache.update(pos);
+
+    pos.pop_back();
+    EXPECT_TRUE(cache.update(pos));
+
+    cache.invalidate();
+    EXPECT_TRUE(cache.update(pos));
+    EXPECT_EQ(cache.rebuildCount(), 3u);
+}
+
+TEST(NeighborListCache, ListLengthsMatchTheLists)
+{
+    NeighborListCache cache(gridConfig(), {1.f, 0.5f});
+    const auto pos = scatter(400, 20.f);
+    cache.update(pos);
+
+    const Log2Histogram &lengths = cache.listLengths();
+    EXPECT_EQ(lengths.total(), pos.size());
+    EXPECT_EQ(lengths.sum(), cache.indices().size());
+
+    uint32_t longest = 0;
+    for (uint32_t i = 0; i < pos.size(); ++i)
+        longest = max<uint32_t>(longest, static_cast<uint32_t>(cache.neighbors(i).size()));
+    EXPECT_EQ(lengths.max(), longest);
+}
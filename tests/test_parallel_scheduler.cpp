@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "particlesim/parallel_scheduler.hpp"
+
+using namespace particlesim;
+
+TEST(ParallelScheduler, CoversWholeRangeExactlyOnce)
+{
+    ParallelScheduler scheduler(4);
+    std::vector<int> hits(1000, 0);
+
+    scheduler.parallelFor(hits.size(), [&](size_t begin, size_t end, size_t)
+                          {
+        for (size_t i = begin; i < end; ++i)
+            ++hits[i]; });
+
+    for (int h : hits)
+        EXPECT_EQ(h, 1);
+}
+
+TEST(ParallelScheduler, ChunkAssignmentIsStable)
+{
+    ParallelScheduler scheduler(3);
+    std::vector<size_t> owner(100, SIZE_MAX);
+
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        scheduler.parallelFor(owner.size(), [&](size_t begin, size_t end, size_t worker)
+                              {
+            auto [b, e] = ParallelScheduler::chunkRange(owner.size(), 3, worker);
+            EXPECT_EQ(b, begin);
+            EXPECT_EQ(e, end);
+            for (size_t i = begin; i < end; ++i)
+                owner[i] = worker; });
+    }
+
+    EXPECT_EQ(owner.front(), 0u);
+    EXPECT_EQ(owner.back(), 2u);
+}
+
+TEST(ParallelScheduler, HandlesFewerItemsThanWorkers)
+{
+    ParallelScheduler scheduler(8);
+    std::atomic<int> total{0};
+
+    scheduler.parallelFor(3, [&](size_t begin, size_t end, size_t)
+                          { total += static_cast<int>(end - begin); });
+
+    EXPECT_EQ(total.load(), 3);
+}
+
+TEST(ParallelScheduler, WorkerArenasAreIndependent)
+{
+    ParallelScheduler scheduler(4, 1024);
+    std::vector<int *> first(4, nullptr);
+
+    scheduler.parallelFor(4, [&](size_t, size_t, size_t worker)
+                          {
+        int *values = scheduler.workerArena(worker).allocateArray<int>(8);
+        for (int i = 0; i < 8; ++i)
+            values[i] = static_cast<int>(worker);
+        first[worker] = values; });
+
+    for (size_t w = 0; w < 4; ++w)
+    {
+        EXPECT_EQ(first[w][7], static_cast<int>(w));
+        EXPECT_EQ(scheduler.workerArena(w).stats().bytesUsed, 8 * sizeof(int));
+    }
+
+    scheduler.resetArenas();
+    for (size_t w = 0; w < 4; ++w)
+        EXPECT_EQ(scheduler.workerArena(w).stats().bytesUsed, 0u);
+}
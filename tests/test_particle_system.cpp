@@ -151,3 +151,735 @@ TEST(ParticleSystemAllocatedTest, SlotReuseAfterDeath)
 
     EXPECT_EQ(first, second);
 }
+
+TEST(ParticleSystemBallisticTest, PositionsFollowClosedForm)
+{
+    ParticleSystem<ParticleSystemDataBallistic> ps;
+    Particle p = make_test_particle(1.0f, 2.0f, 0.5f, -1.0f, 10.0f);
+    p.position = {3.0f, 4.0f};
+    ps.addParticle(p);
+
+    for (int i = 0; i < 4; ++i)
+        ps.update(0.5f);
+
+    const auto out = ps.get()[0];
+    // t = 2
+    EXPECT_FLOAT_EQ(out.position.x, 3.0f + 2.0f + 0.25f * 4.0f);
+    EXPECT_FLOAT_EQ(out.position.y, 4.0f + 4.0f - 0.5f * 4.0f);
+    EXPECT_FLOAT_EQ(out.velocity.x, 2.0f);
+    EXPECT_FLOAT_EQ(out.velocity.y, 0.0f);
+    EXPECT_FLOAT_EQ(out.lifetime, 8.0f);
+}
+
+TEST(ParticleSystemBallisticTest, LaterSpawnsUseTheirOwnClock)
+{
+    ParticleSystem<ParticleSystemDataBallistic> ps;
+    ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+    ps.update(1.0f);
+    ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+    ps.update(1.0f);
+
+    const auto out = ps.get();
+    EXPECT_FLOAT_EQ(out[0].position.x, 2.0f);
+    EXPECT_FLOAT_EQ(out[1].position.x, 1.0f);
+}
+
+TEST(ParticleSystemBallisticTest, ExpiredParticlesAreCompactedAndFrozen)
+{
+    ParticleSystem<ParticleSystemDataBallistic> ps;
+    ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+    ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+
+    ps.update(1.0f);
+    auto out = ps.get();
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_FALSE(out[0].alive);
+    EXPECT_FLOAT_EQ(out[0].position.x, 0.5f);
+
+    ps.update(1.0f, true);
+    EXPECT_EQ(ps.size(), 1u);
+    EXPECT_TRUE(ps.get()[0].alive);
+}
+
+TEST(ParticleSystemBallisticTest, KeepsPrecisionAfterADayOfFrames)
+{
+    ParticleSystemDataBallistic system;
+    // a particle alive across a rebase keeps its trajectory
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 1.0e6f));
+    const int frames = 86400 * 60;
+    for (int i = 0; i < frames; ++i)
+        system.update(1.0f / 60.0f);
+    EXPECT_NEAR(system.time(), 86400.0, 0.01); // 1 / 60.f is not exact
+    EXPECT_NEAR(system.get()[0].position.x, 86400.0f, 1.0f);
+
+    // at float absolute times a frame would be 1/128 s here and the death would land frames late
+    // 30 frames of 1 / 60.f come to a hair over 0.5 s, so the lifetime sits between frame 30 and 31
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.51f));
+    for (int i = 0; i < 30; ++i)
+        system.update(1.0f / 60.0f, true);
+    ASSERT_EQ(system.size(), 2u);
+    EXPECT_NEAR(system.get()[1].position.x, 0.5f, 1e-3f);
+
+    system.update(1.0f / 60.0f, true);
+    EXPECT_EQ(system.size(), 1u);
+}
+
+TEST(ParticleSystemBallisticTest, ConvergesToEulerLayoutForSmallSteps)
+{
+    ParticleSystem<ParticleSystemDataSoA> soa;
+    ParticleSystem<ParticleSystemDataBallistic> ballistic;
+    Particle p = make_test_particle(1.0f, 2.0f, 0.3f, -9.8f, 10.0f);
+    soa.addParticle(p);
+    ballistic.addParticle(p);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        soa.update(0.001f);
+        ballistic.update(0.001f);
+    }
+
+    const auto a = soa.get()[0];
+    const auto b = ballistic.get()[0];
+    EXPECT_NEAR(a.position.x, b.position.x, 1e-2f);
+    EXPECT_NEAR(a.position.y, b.position.y, 1e-2f);
+}
+
+TEST(ParticleSystemAllocatedTest, ExpiresAtLifetimeAndFreesNextUpdate)
+{
+    ParticleSystemDataAllocated system(8, 0.01f);
+
+    Particle shortLived = make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.25f);
+    Particle longLived = make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 10.0f);
+    size_t shortIndex = system.add(shortLived);
+    system.add(longLived);
+
+    system.update(0.1f);
+    system.update(0.1f);
+    EXPECT_TRUE(system.expired().empty());
+
+    system.update(0.1f); // t = 0.3 - short-lived dies
+    ASSERT_EQ(system.expired().size(), 1u);
+    EXPECT_EQ(system.expired()[0], shortIndex);
+    EXPECT_EQ(system.size(), 2u);
+
+    system.update(0.1f);
+    EXPECT_EQ(system.size(), 1u);
+
+    const auto out = system.get();
+    EXPECT_TRUE(out[0].alive);
+    EXPECT_NEAR(out[0].lifetime, 9.6f, 1e-5f);
+    EXPECT_NEAR(out[0].position.x, 0.4f, 1e-5f);
+}
+
+TEST(ParticleSystemAllocatedTest, ChurnKeepsActiveSetConsistent)
+{
+    ParticleSystemDataAllocated system(64);
+
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        while (system.size() < 64)
+        {
+            if (system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.05f * (1 + frame % 7))) == INVALID_INDEX)
+                break;
+        }
+        system.update(0.016f);
+
+        // deaths may land up to one expiry tick late, never early
+        for (const auto &p : system.get())
+        {
+            if (p.alive)
+                EXPECT_GT(p.lifetime, -1.0f / 240.0f);
+            else
+                EXPECT_LE(p.lifetime, 0.0f);
+        }
+    }
+}
+
+TEST(ParticleSystemCohortTest, BurstsShareACohort)
+{
+    const size_t burst = ParticleSystemDataCohort::MinCohortSize;
+    ParticleSystemDataCohort system(4 * burst);
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 1.0f));
+    for (size_t i = 0; i < burst + 3; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+
+    EXPECT_EQ(system.size(), 2 * burst + 3);
+    EXPECT_EQ(system.cohortCount(), 2u);
+}
+
+TEST(ParticleSystemCohortTest, RandomLifetimesFillCohortsOfMinimumSize)
+{
+    ParticleSystemDataCohort system(1024);
+    for (int i = 0; i < 1024; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.1f + 0.37f * float((i * 7919) % 101)));
+
+    EXPECT_EQ(system.size(), 1024u);
+    EXPECT_EQ(system.cohortCount(), 1024u / ParticleSystemDataCohort::MinCohortSize);
+}
+
+TEST(ParticleSystemCohortTest, CompactionTruncatesExpiredCohorts)
+{
+    ParticleSystemDataCohort system(16);
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+    system.add(make_test_particle(2.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+    system.add(make_test_particle(3.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+
+    system.update(1.0f, true);
+    ASSERT_EQ(system.size(), 1u);
+    EXPECT_EQ(system.cohortCount(), 1u);
+
+    const auto out = system.get();
+    EXPECT_TRUE(out[0].alive);
+    EXPECT_FLOAT_EQ(out[0].velocity.x, 2.0f);
+    EXPECT_FLOAT_EQ(out[0].position.x, 2.0f);
+    EXPECT_FLOAT_EQ(out[0].lifetime, 4.0f);
+}
+
+TEST(ParticleSystemCohortTest, ExpiredCohortBetweenLiveOnesIsReclaimed)
+{
+    const size_t burst = ParticleSystemDataCohort::MinCohortSize;
+    ParticleSystemDataCohort system(4 * burst);
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(2.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(3.0f, 0.0f, 0.0f, 0.0f, 4.0f));
+    ASSERT_EQ(system.cohortCount(), 3u);
+
+    system.update(1.0f, true);
+    ASSERT_EQ(system.size(), 2 * burst);
+
+    // the later cohort slid down over the gap, in order
+    const auto out = system.get();
+    for (size_t i = 0; i < 2 * burst; ++i)
+    {
+        EXPECT_TRUE(out[i].alive);
+        EXPECT_FLOAT_EQ(out[i].position.x, i < burst ? 1.0f : 3.0f) << i;
+    }
+    for (size_t i = 0; i < burst; ++i)
+        EXPECT_NE(system.add(make_test_particle()), INVALID_INDEX);
+}
+
+TEST(ParticleSystemCohortTest, MixedLifetimesAreCompactedAndFreeTheirSlots)
+{
+    ParticleSystemDataCohort system(256);
+    for (int i = 0; i < 256; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, i % 3 == 0 ? 0.5f : (i % 3 == 1 ? 1.5f : 3.0f)));
+    EXPECT_EQ(system.add(make_test_particle()), INVALID_INDEX);
+
+    system.update(1.0f, true);
+    const size_t survivors = 256 - 86; // every third died
+    ASSERT_EQ(system.size(), survivors);
+    for (const auto &p : system.get())
+        EXPECT_TRUE(p.alive);
+
+    for (size_t i = survivors; i < 256; ++i)
+        EXPECT_NE(system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 10.0f)), INVALID_INDEX);
+    EXPECT_EQ(system.add(make_test_particle()), INVALID_INDEX);
+
+    system.update(1.0f, true);
+    EXPECT_EQ(system.size(), 256u - 85u); // the 1.5 s ones
+    system.update(1.5f, true);
+    EXPECT_EQ(system.size(), 86u); // the new ones
+}
+
+TEST(ParticleSystemCohortTest, RingWrapsAndRejectsWhenFull)
+{
+    const size_t burst = ParticleSystemDataCohort::MinCohortSize;
+    ParticleSystemDataCohort system(2 * burst);
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+    for (size_t i = 0; i < burst; ++i)
+        system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+    EXPECT_EQ(system.add(make_test_particle()), INVALID_INDEX);
+
+    system.update(1.0f, true);
+    ASSERT_EQ(system.size(), burst);
+    for (size_t i = 0; i < burst; ++i)
+        EXPECT_NE(system.add(make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 5.0f)), INVALID_INDEX);
+    EXPECT_EQ(system.add(make_test_particle()), INVALID_INDEX);
+
+    // new slots wrapped past the end of the ring, logical order is preserved
+    const auto positions = system.positions();
+    ASSERT_EQ(positions.size(), 2 * burst);
+    for (size_t i = 0; i < 2 * burst; ++i)
+        EXPECT_FLOAT_EQ(positions[i].x, i < burst ? 1.0f : 0.0f) << i;
+}
+
+TEST(ParticleSystemCohortTest, KeepsDeathPrecisionAfterADayOfFrames)
+{
+    ParticleSystemDataCohort system(64);
+    system.add(make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 1.0e6f));
+    for (int i = 0; i < 86400 * 60; ++i)
+        system.update(1.0f / 60.0f, true);
+
+    // 30 frames of 1 / 60.f come to a hair over 0.5 s, so the lifetime sits between frame 30 and 31
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.51f));
+    for (int i = 0; i < 30; ++i)
+        system.update(1.0f / 60.0f, true);
+    ASSERT_EQ(system.size(), 2u);
+    EXPECT_NEAR(system.get()[1].position.x, 0.5f, 1e-3f);
+
+    system.update(1.0f / 60.0f, true);
+    EXPECT_EQ(system.size(), 1u);
+}
+
+TEST(ParticleSystemCohortTest, MatchesSoAIntegration)
+{
+    ParticleSystem<ParticleSystemDataSoA> soa;
+    ParticleSystem<ParticleSystemDataCohort> cohort;
+    for (int i = 0; i < 32; ++i)
+    {
+        Particle p = make_test_particle(0.1f * i, 1.0f, 0.0f, -9.8f, 0.1f + 0.05f * (i % 4));
+        soa.addParticle(p);
+        cohort.addParticle(p);
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        soa.update(0.016f);
+        cohort.update(0.016f);
+    }
+
+    const auto a = soa.get();
+    const auto b = cohort.get();
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_EQ(a[i].alive, b[i].alive);
+        EXPECT_FLOAT_EQ(a[i].position.x, b[i].position.x);
+        EXPECT_FLOAT_EQ(a[i].position.y, b[i].position.y);
+    }
+}
+
+TEST(ParticleSystemQuantizedTest, RoundTripsWithinStep)
+{
+    WorldBounds world{-50.f, -50.f, 50.f, 50.f};
+    ParticleSystemDataQuantized system(4, world);
+
+    Particle p = make_test_particle(3.3f, -1.7f, 0.0f, -9.8f, 2.0f);
+    p.position = {12.345f, -33.21f};
+    system.add(p);
+
+    const Vector2D step = system.positionStep();
+    const auto out = system.get()[0];
+    EXPECT_NEAR(out.position.x, 12.345f, step.x);
+    EXPECT_NEAR(out.position.y, -33.21f, step.y);
+    EXPECT_NEAR(out.velocity.x, 3.3f, 3.3f / 2048.f);
+    EXPECT_NEAR(out.acceleration.y, -9.8f, 9.8f / 2048.f);
+    EXPECT_NEAR(out.lifetime, 2.0f, 1.0f / 60.0f);
+    EXPECT_TRUE(out.alive);
+}
+
+TEST(ParticleSystemQuantizedTest, PositionsSaturateAtWorldBounds)
+{
+    ParticleSystemDataQuantized system(4);
+    system.add(make_test_particle(-100.0f, 500.0f, 0.0f, 0.0f, 5.0f));
+
+    system.update(1.0f);
+    const auto positions = system.positions();
+    EXPECT_FLOAT_EQ(positions[0].x, 0.0f);
+    EXPECT_NEAR(positions[0].y, 100.0f, 1e-3f);
+}
+
+TEST(ParticleSystemQuantizedTest, LifetimeCountsDownInTicks)
+{
+    ParticleSystemDataQuantized system(4, {}, 0.125f);
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.45f));
+    system.add(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+    system.add(makeDeadParticle());
+
+    system.update(0.25f, true);
+    ASSERT_EQ(system.size(), 2u);
+
+    system.update(0.25f, true);
+    ASSERT_EQ(system.size(), 1u);
+    EXPECT_NEAR(system.get()[0].lifetime, 4.5f, 0.125f);
+}
+
+TEST(ParticleSystemQuantizedTest, TracksSoAWithinDocumentedPrecision)
+{
+    WorldBounds world{0.f, 0.f, 200.f, 200.f};
+    ParticleSystemDataSoA soa(256);
+    ParticleSystemDataQuantized quantized(256, world);
+
+    for (int i = 0; i < 256; ++i)
+    {
+        Particle p = make_test_particle(-8.f + 0.0625f * i, 12.f - 0.05f * i, 0.0f, -9.8f, 5.0f);
+        p.position = {50.f + 0.37f * i, 150.f - 0.21f * i};
+        soa.add(p);
+        quantized.add(p);
+    }
+
+    const int frames = 120;
+    for (int f = 0; f < frames; ++f)
+    {
+        soa.update(1.0f / 60.0f);
+        quantized.update(1.0f / 60.0f);
+    }
+
+    const auto a = soa.get();
+    const auto b = quantized.get();
+    const Vector2D step = quantized.positionStep();
+
+    double meanErrX = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        // the dithered rounding walks at most one step per frame and the fp16 velocity
+        // drifts by at most half an ulp per frame under constant acceleration
+        const float velocityDrift = frames * (std::fabs(a[i].velocity.y) + 12.f) / 4096.f;
+        EXPECT_NEAR(a[i].position.x, b[i].position.x, frames * step.x + 0.01f);
+        EXPECT_NEAR(a[i].position.y, b[i].position.y, frames * step.y + velocityDrift * frames / 60.f);
+        EXPECT_NEAR(a[i].velocity.y, b[i].velocity.y, velocityDrift);
+        EXPECT_EQ(a[i].alive, b[i].alive);
+        meanErrX += b[i].position.x - a[i].position.x;
+    }
+
+    // unbiased rounding - errors cancel across particles
+    EXPECT_LT(std::fabs(meanErrX / a.size()), 4.0f * step.x);
+}
+
+static RestConfig restAfter(uint8_t frames)
+{
+    RestConfig cfg;
+    cfg.enabled = true;
+    cfg.sleepFrames = frames;
+    return cfg;
+}
+
+TEST(ParticleSystemSoARestTest, SettledBlocksFallAsleep)
+{
+    ParticleSystemDataSoA system(256);
+    system.setRestConfig(restAfter(3));
+
+    // first block settled, second block has one mover
+    for (size_t i = 0; i < 2 * ParticleSystemDataSoA::BlockSize; ++i)
+        system.add(make_test_particle(i == 100 ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+
+    for (int f = 0; f < 3; ++f)
+    {
+        EXPECT_EQ(system.sleepingCount(), 0u);
+        system.update(0.1f);
+    }
+
+    EXPECT_EQ(system.sleepingCount(), ParticleSystemDataSoA::BlockSize);
+    EXPECT_EQ(system.activeCount(), ParticleSystemDataSoA::BlockSize);
+
+    system.update(0.1f);
+    const auto out = system.get();
+    EXPECT_NEAR(out[0].lifetime, 9.6f, 1e-5f);
+    EXPECT_NEAR(out[100].position.x, 0.4f, 1e-5f);
+}
+
+TEST(ParticleSystemSoARestTest, ZeroSleepFramesKeepsMoversAwake)
+{
+    ParticleSystemDataSoA system(256);
+    system.setRestConfig(restAfter(0));
+
+    // first block settled, second block moving
+    for (size_t i = 0; i < 2 * ParticleSystemDataSoA::BlockSize; ++i)
+        system.add(make_test_particle(i < ParticleSystemDataSoA::BlockSize ? 0.0f : 1.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+
+    system.update(0.1f);
+    EXPECT_EQ(system.sleepingCount(), ParticleSystemDataSoA::BlockSize);
+
+    system.update(0.1f);
+    const auto out = system.get();
+    EXPECT_NEAR(out[ParticleSystemDataSoA::BlockSize].velocity.x, 1.0f, 1e-6f);
+    EXPECT_NEAR(out[ParticleSystemDataSoA::BlockSize].position.x, 0.2f, 1e-5f);
+}
+
+TEST(ParticleSystemSoARestTest, SleepersDieOnTheSameFrame)
+{
+    ParticleSystemDataSoA resting(64);
+    ParticleSystemDataSoA reference(64);
+    resting.setRestConfig(restAfter(1));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        Particle p = make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 0.35f + 0.1f * i);
+        resting.add(p);
+        reference.add(p);
+    }
+
+    for (int f = 0; f < 12; ++f)
+    {
+        resting.update(0.1f, true);
+        reference.update(0.1f, true);
+        ASSERT_EQ(resting.size(), reference.size()) << "frame " << f;
+    }
+    EXPECT_EQ(resting.size(), 0u);
+}
+
+TEST(ParticleSystemSoARestTest, ForcesAndWakeRestoreIntegration)
+{
+    ParticleSystemDataSoA system(128);
+    system.setRestConfig(restAfter(1));
+    for (int i = 0; i < 2 * 64; ++i)
+        system.add(make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+
+    system.update(0.1f);
+    ASSERT_EQ(system.sleepingCount(), 128u);
+
+    // a kick below the threshold is dropped, a real one wakes its block only
+    std::vector<Vector2D> acc(128);
+    acc[3] = {0.001f, 0.0f};
+    acc[70] = {10.0f, 0.0f};
+    system.applyAcceleration(acc, 0.1f);
+    EXPECT_EQ(system.sleepingCount(), 64u);
+
+    system.update(0.1f);
+    auto out = system.get();
+    EXPECT_FLOAT_EQ(out[3].velocity.x, 0.0f);
+    EXPECT_FLOAT_EQ(out[70].velocity.x, 1.0f);
+    EXPECT_NEAR(out[70].position.x, 0.1f, 1e-6f);
+
+    const uint32_t ids[] = {5};
+    system.wake(ids);
+    EXPECT_EQ(system.sleepingCount(), 0u);
+    EXPECT_NEAR(system.get()[5].lifetime, 9.8f, 1e-5f);
+}
+
+TEST(ParticleSystemSoARestTest, CompactionAndDisableSettleSkippedTime)
+{
+    ParticleSystemDataSoA system(128);
+    system.setRestConfig(restAfter(1));
+    for (int i = 0; i < 100; ++i)
+        system.add(make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, i < 90 ? 10.0f : 0.25f));
+
+    for (int f = 0; f < 4; ++f)
+        system.update(0.1f, true);
+    ASSERT_EQ(system.size(), 90u);
+
+    system.setRestConfig({});
+    EXPECT_EQ(system.sleepingCount(), 0u);
+    for (const auto &p : system.get())
+    {
+        EXPECT_TRUE(p.alive);
+        EXPECT_NEAR(p.lifetime, 9.6f, 1e-5f);
+    }
+}
+
+static Particle tieredParticle(uint8_t tier, float lifetime = 10.0f)
+{
+    Particle p = make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, lifetime);
+    p.updateTier = tier;
+    return p;
+}
+
+TEST(ParticleSystemSoATierTest, TiersIntegrateWithStretchedStepsStaggered)
+{
+    constexpr size_t Block = ParticleSystemDataSoA::BlockSize;
+    ParticleSystemDataSoA system(8 * Block);
+    for (size_t i = 0; i < 4 * Block; ++i)
+        system.add(tieredParticle(4));
+    for (size_t i = 0; i < Block; ++i)
+        system.add(tieredParticle(1));
+
+    for (size_t f = 0; f < 4; ++f)
+    {
+        system.update(0.1f);
+
+        // one block of tier 4 particles per frame
+        size_t moved = 0;
+        const auto out = system.get();
+        for (size_t i = 0; i < 4 * Block; ++i)
+            moved += out[i].position.x > 0.0f;
+        EXPECT_EQ(moved, (f + 1) * Block);
+    }
+
+    for (const auto &p : system.get())
+    {
+        EXPECT_NEAR(p.position.x, 0.4f, 1e-5f);
+        EXPECT_NEAR(p.lifetime, 9.6f, 1e-5f);
+    }
+}
+
+TEST(ParticleSystemSoATierTest, TiersRoundDownToPowersOfTwo)
+{
+    ParticleSystemDataSoA system(4);
+    system.add(tieredParticle(3));
+    system.add(tieredParticle(0));
+    EXPECT_EQ(system.get()[0].updateTier, 2);
+    EXPECT_EQ(system.get()[1].updateTier, 1);
+}
+
+TEST(ParticleSystemSoATierTest, LodStretchesOnlyTiersAboveOne)
+{
+    ParticleSystemDataSoA system(16);
+    system.add(tieredParticle(1));
+    system.add(tieredParticle(2));
+    system.setLodLevel(2);
+    EXPECT_EQ(system.lodLevel(), 2);
+
+    for (int f = 0; f < 8; ++f)
+    {
+        system.update(0.1f);
+        EXPECT_NEAR(system.get()[0].position.x, 0.1f * (f + 1), 1e-5f);
+    }
+
+    // tier 2 at level 2 runs every 8 frames with 8 * dt
+    EXPECT_NEAR(system.get()[1].position.x, 0.8f, 1e-5f);
+
+    system.setLodLevel(200);
+    EXPECT_EQ(system.lodLevel(), ParticleSystemDataSoA::MaxLodLevel);
+}
+
+TEST(ParticleSystemSoATierTest, LodChangesWaitForAStrideBoundary)
+{
+    // block 0, so the phase is the frame. Steps are taken up front: x is the time covered so far
+    ParticleSystemDataSoA system(16);
+    system.add(tieredParticle(2));
+    system.update(0.1f);
+    system.update(0.1f);
+    EXPECT_NEAR(system.get()[0].position.x, 0.2f, 1e-5f);
+
+    // raised mid-cycle: stride 2 continues until phase 8, then one step of 8 frames
+    system.setLodLevel(2);
+    for (int f = 2; f < 16; ++f)
+        system.update(0.1f);
+    EXPECT_NEAR(system.get()[0].position.x, 1.6f, 1e-5f);
+
+    // lowered at phase 20 while the step taken at 16 covers up to 24
+    for (int f = 16; f < 20; ++f)
+        system.update(0.1f);
+    EXPECT_NEAR(system.get()[0].position.x, 2.4f, 1e-5f);
+    system.setLodLevel(0);
+    for (int f = 20; f < 24; ++f)
+        system.update(0.1f);
+    EXPECT_NEAR(system.get()[0].position.x, 2.4f, 1e-5f);
+    system.update(0.1f);
+    EXPECT_NEAR(system.get()[0].position.x, 2.6f, 1e-5f);
+}
+
+TEST(ParticleSystemSoATierTest, BudgetRaisesAndRecoversLod)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(4096);
+    for (int i = 0; i < 4096; ++i)
+        ps.addParticle(tieredParticle(i % 2 ? 4 : 1));
+
+    // any real frame is over a zero budget
+    for (int f = 0; f < 10; ++f)
+        ps.update(0.016f, std::chrono::microseconds(0));
+    EXPECT_EQ(ps.lodLevel(), ParticleSystemDataSoA::MaxLodLevel);
+    EXPECT_EQ(ps.layout().lodLevel(), ParticleSystemDataSoA::MaxLodLevel);
+
+    const auto generous = std::chrono::microseconds(std::chrono::hours(1));
+    for (uint32_t f = 0; f + 1 < ps.RecoverFrames; ++f)
+        ps.update(0.016f, generous);
+    EXPECT_EQ(ps.lodLevel(), ParticleSystemDataSoA::MaxLodLevel);
+
+    ps.update(0.016f, generous);
+    EXPECT_EQ(ps.lodLevel(), ParticleSystemDataSoA::MaxLodLevel - 1);
+
+    // tier 1 particles kept full rate throughout
+    EXPECT_NEAR(ps.get()[0].lifetime, 10.0f - 0.016f * (10 + ps.RecoverFrames), 1e-4f);
+}
+
+TEST(ParticleSystemStatsTest, SoACountsBirthsDeathsAndMoves)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(100);
+    for (int i = 0; i < 10; ++i)
+        ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, i < 4 ? 0.5f : 5.0f));
+
+    ps.update(1.0f);
+    SimulationStats stats = ps.stats();
+    EXPECT_EQ(stats.frame, 1u);
+    EXPECT_EQ(stats.births, 10u);
+    EXPECT_EQ(stats.deaths, 4u);
+    EXPECT_EQ(stats.particles, 10u);
+    EXPECT_EQ(stats.alive, 6u);
+    EXPECT_EQ(stats.compactionMoves, 0u);
+
+    // the four dead slots at the front are filled from the live tail
+    ps.addParticle(make_test_particle());
+    ps.update(0.1f, true);
+    stats = ps.stats();
+    EXPECT_EQ(stats.births, 1u);
+    EXPECT_EQ(stats.deaths, 0u);
+    EXPECT_EQ(stats.particles, 7u);
+    EXPECT_EQ(stats.alive, 7u);
+    EXPECT_EQ(stats.compactionMoves, 4u);
+}
+
+TEST(ParticleSystemStatsTest, TieredAndSleepingDeathsAreCounted)
+{
+    ParticleSystem<ParticleSystemDataSoA> ps(100);
+    RestConfig rest;
+    rest.enabled = true;
+    rest.sleepFrames = 1;
+    ps.layout().setRestConfig(rest);
+    for (int i = 0; i < 8; ++i)
+    {
+        Particle p = make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 1.0f + float(i));
+        p.updateTier = i % 2 ? 2 : 1;
+        ps.addParticle(p);
+    }
+
+    size_t deaths = 0;
+    for (int f = 0; f < 20; ++f)
+    {
+        ps.update(0.5f);
+        deaths += ps.stats().deaths;
+    }
+    // sleeping blocks settle their deaths when they wake, which also happens inside update()
+    EXPECT_EQ(deaths, 8u);
+    EXPECT_EQ(ps.layout().counters().deaths, 8u);
+    EXPECT_EQ(ps.stats().alive, 0u);
+}
+
+TEST(ParticleSystemStatsTest, AllocatedCountsExpiries)
+{
+    ParticleSystem<ParticleSystemDataAllocated> ps(100);
+    for (int i = 0; i < 6; ++i)
+        ps.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, i < 2 ? 0.5f : 5.0f));
+
+    ps.update(1.0f);
+    EXPECT_EQ(ps.stats().deaths, 2u);
+    EXPECT_EQ(ps.stats().alive, 4u);
+
+    ps.update(1.0f);
+    const SimulationStats stats = ps.stats();
+    EXPECT_EQ(stats.deaths, 0u);
+    EXPECT_EQ(stats.particles, 4u);
+    EXPECT_EQ(stats.alive, 4u);
+    EXPECT_GE(stats.compactionMoves, 1u);
+}
+
+TEST(ParticleSystemStatsTest, LayoutsWithoutCountersReportSizes)
+{
+    ParticleSystem<ParticleSystemDataAoS> ps(100);
+    for (int i = 0; i < 5; ++i)
+        ps.addParticle(make_test_particle());
+    ps.update(0.1f);
+
+    const SimulationStats stats = ps.stats();
+    EXPECT_EQ(stats.births, 5u);
+    EXPECT_EQ(stats.particles, 5u);
+    EXPECT_EQ(stats.alive, 5u);
+    EXPECT_EQ(stats.deaths, 0u);
+    EXPECT_EQ(stats.partition.particles, 0u);
+}
+
+TEST(ParticleSystemStatsTest, PartitionStatsComeFromTheLastBuild)
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 10.f;
+    cfg.world = {0, 0, 100, 100};
+    ParticleSystem<ParticleSystemDataSoA> ps(100, std::make_unique<UniformGrid>(cfg));
+    for (int i = 0; i < 20; ++i)
+    {
+        Particle p = make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 10.0f);
+        p.position = {i < 16 ? 5.0f : 55.0f, 5.0f};
+        ps.addParticle(p);
+    }
+    ps.update(0.1f);
+
+    const PartitionStats &partition = ps.stats().partition;
+    EXPECT_EQ(partition.particles, 20u);
+    EXPECT_EQ(partition.nonEmptyCells(), 2u);
+    EXPECT_EQ(partition.maxOccupancy(), 16u);
+}
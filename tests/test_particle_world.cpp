@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "particlesim/particle_world.hpp"
+#include "particlesim/particle_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+
+TEST(ParticleWorld, EmittersOwnSeparateRanges)
+{
+    ParticleWorld world;
+    EmitterID a = world.createEmitter(2);
+    EmitterID b = world.createEmitter(3);
+
+    EXPECT_EQ(world.add(a, make_test_particle()), 0u);
+    EXPECT_EQ(world.add(a, make_test_particle()), 1u);
+    EXPECT_EQ(world.add(a, make_test_particle()), INVALID_INDEX);
+    EXPECT_EQ(world.add(b, make_test_particle()), 0u);
+
+    EXPECT_EQ(world.emitterCount(), 2u);
+    EXPECT_EQ(world.size(a), 2u);
+    EXPECT_EQ(world.size(b), 1u);
+    EXPECT_EQ(world.size(), 3u);
+}
+
+TEST(ParticleWorld, MatchesSoALayoutWithoutEmitterForces)
+{
+    ParticleWorld world;
+    EmitterID id = world.createEmitter(16);
+    ParticleSystem<ParticleSystemDataSoA> ps(16);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        Particle p = make_test_particle(0.1f * i, 1.0f, 0.5f, -9.8f, 0.05f + 0.02f * i);
+        world.add(id, p);
+        ps.addParticle(p);
+    }
+
+    for (int f = 0; f < 10; ++f)
+    {
+        world.update(0.016f, true);
+        ps.update(0.016f, true);
+    }
+
+    auto a = world.get(id);
+    auto b = ps.get();
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(a[i].position.x, b[i].position.x);
+        EXPECT_FLOAT_EQ(a[i].position.y, b[i].position.y);
+        EXPECT_FLOAT_EQ(a[i].lifetime, b[i].lifetime);
+    }
+}
+
+TEST(ParticleWorld, AppliesPerEmitterGravityAndDrag)
+{
+    ParticleWorld world;
+    EmitterID falling = world.createEmitter(4, {{0.0f, -10.0f}, 0.0f});
+    EmitterID damped = world.createEmitter(4, {{0.0f, 0.0f}, 0.5f});
+
+    world.add(falling, make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+    world.add(damped, make_test_particle(2.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+
+    world.update(0.1f);
+    EXPECT_FLOAT_EQ(world.get(falling)[0].velocity.y, -1.0f);
+    EXPECT_FLOAT_EQ(world.get(falling)[0].position.y, -0.1f);
+    EXPECT_FLOAT_EQ(world.get(damped)[0].velocity.x, 1.9f);
+
+    world.setParams(damped, {});
+    world.update(0.1f);
+    EXPECT_FLOAT_EQ(world.get(damped)[0].velocity.x, 1.9f);
+}
+
+TEST(ParticleWorld, CompactionStaysInsideEachRange)
+{
+    ParticleWorld world;
+    EmitterID a = world.createEmitter(4);
+    EmitterID b = world.createEmitter(4);
+
+    world.add(a, make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 0.05f));
+    world.add(a, make_test_particle(2.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+    world.add(a, makeDeadParticle());
+    world.add(b, make_test_particle(3.0f, 0.0f, 0.0f, 0.0f, 5.0f));
+
+    world.update(0.1f, true);
+    ASSERT_EQ(world.size(a), 1u);
+    ASSERT_EQ(world.size(b), 1u);
+    EXPECT_FLOAT_EQ(world.get(a)[0].velocity.x, 2.0f);
+    EXPECT_FLOAT_EQ(world.get(b)[0].velocity.x, 3.0f);
+
+    // freed slots are reused by the same emitter
+    EXPECT_EQ(world.add(a, make_test_particle()), 1u);
+}
+
+TEST(ParticleWorld, ParallelUpdateMatchesSerial)
+{
+    ParticleWorld serial;
+    ParticleWorld parallel;
+    for (int e = 0; e < 64; ++e)
+    {
+        EmitterParams params{{0.0f, -1.0f * e}, 0.01f * e};
+        EmitterID s = serial.createEmitter(32, params);
+        EmitterID p = parallel.createEmitter(32, params);
+        for (int i = 0; i < 10 + e % 20; ++i)
+        {
+            Particle particle = make_test_particle(0.1f * i, 0.0f, 0.0f, 0.0f, 0.02f * (i + 1));
+            serial.add(s, particle);
+            parallel.add(p, particle);
+        }
+    }
+
+    ParallelScheduler scheduler(4);
+    for (int f = 0; f < 10; ++f)
+    {
+        serial.update(0.016f, true);
+        parallel.update(0.016f, true, &scheduler);
+    }
+
+    for (EmitterID e = 0; e < 64; ++e)
+    {
+        auto a = serial.get(e);
+        auto b = parallel.get(e);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            EXPECT_EQ(a[i].position.y, b[i].position.y);
+    }
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/profiling.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+
+namespace
+{
+    class FrameProfilerTest : public ::testing::Test
+    {
+    protected:
+        FrameProfiler &profiler = FrameProfiler::instance();
+
+        void SetUp() override { profiler.reset(); }
+        void TearDown() override { profiler.reset(); }
+    };
+}
+
+TEST_F(FrameProfilerTest, FramesFoldTheirStages)
+{
+    EXPECT_EQ(profiler.frameCount(), 0u);
+    EXPECT_EQ(profiler.latest().frameNanoseconds, 0u);
+
+    profiler.addStage(Stage::LayoutUpdate, 100);
+    profiler.addStage(Stage::LayoutUpdate, 50);
+    profiler.addStage(Stage::Positions, 7);
+    profiler.endFrame(1000);
+
+    FrameStats stats = profiler.latest();
+    EXPECT_EQ(stats.frame, 0u);
+    EXPECT_EQ(stats.frameNanoseconds, 1000u);
+    EXPECT_EQ(stats.stageNanoseconds(Stage::LayoutUpdate), 150u);
+    EXPECT_EQ(stats.stageCalls(Stage::LayoutUpdate), 2u);
+    EXPECT_EQ(stats.stageNanoseconds(Stage::Positions), 7u);
+    EXPECT_EQ(stats.stageCalls(Stage::PartitionBuild), 0u);
+
+    // the next frame starts from zero
+    profiler.endFrame(500);
+    stats = profiler.latest();
+    EXPECT_EQ(stats.frame, 1u);
+    EXPECT_EQ(stats.stageNanoseconds(Stage::LayoutUpdate), 0u);
+    EXPECT_EQ(profiler.frameCount(), 2u);
+}
+
+TEST_F(FrameProfilerTest, HistoryKeepsTheLastFrames)
+{
+    const size_t frames = FrameProfiler::HistorySize + 10;
+    for (size_t f = 0; f < frames; ++f)
+    {
+        profiler.addStage(Stage::Export, f);
+        profiler.endFrame(f);
+    }
+
+    const auto history = profiler.history();
+    ASSERT_EQ(history.size(), FrameProfiler::HistorySize);
+    EXPECT_EQ(history.front().frame, 10u);
+    EXPECT_EQ(history.back().frame, frames - 1);
+    for (size_t i = 0; i < history.size(); ++i)
+        EXPECT_EQ(history[i].stageNanoseconds(Stage::Export), history[i].frame);
+}
+
+TEST_F(FrameProfilerTest, StagesOfAllThreadsAreSummed)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&]
+                             {
+                                 for (int i = 0; i < 1000; ++i)
+                                     profiler.addStage(Stage::PartitionQuery, 2); });
+    for (auto &t : threads)
+        t.join();
+    profiler.endFrame(1);
+
+    const FrameStats stats = profiler.latest();
+    EXPECT_EQ(stats.stageCalls(Stage::PartitionQuery), 4000u);
+    EXPECT_EQ(stats.stageNanoseconds(Stage::PartitionQuery), 8000u);
+}
+
+TEST_F(FrameProfilerTest, ExitedThreadsLeaveTheirCountersToNewOnes)
+{
+    const size_t before = profiler.threadCount();
+    for (int t = 0; t < 20; ++t)
+        std::thread([&]
+                    { profiler.addStage(Stage::CompactDead, 3); })
+            .join();
+
+    // at most one new set, reused by every later thread
+    EXPECT_LE(profiler.threadCount(), before + 1);
+
+    // what the exited threads added still reaches the frame
+    profiler.endFrame(1);
+    const FrameStats stats = profiler.latest();
+    EXPECT_EQ(stats.stageCalls(Stage::CompactDead), 20u);
+    EXPECT_EQ(stats.stageNanoseconds(Stage::CompactDead), 60u);
+}
+
+TEST_F(FrameProfilerTest, StageNames)
+{
+    EXPECT_STREQ(stageName(Stage::LayoutUpdate), "LayoutUpdate");
+    EXPECT_STREQ(stageName(Stage::PartitionQuery), "PartitionQuery");
+    EXPECT_STREQ(stageName(Stage::Export), "Export");
+}
+
+TEST_F(FrameProfilerTest, UpdateReportsItsStages)
+{
+    ParticleSystem<ParticleSystemDataSoA> system(1000);
+    PartitioningConfig cfg;
+    cfg.world = {0.f, 0.f, 100.f, 100.f};
+    cfg.cellSize = 10;
+    system.setPartition(std::make_unique<UniformGrid>(cfg));
+    for (int i = 0; i < 100; ++i)
+    {
+        Particle p = make_test_particle(1.f, 0.f, 0.f, 0.f, 10.f);
+        p.position = {float(i % 10) * 10.f + 5.f, float(i / 10) * 10.f + 5.f};
+        system.addParticle(p);
+    }
+
+    system.update(0.1f, true);
+    system.update(0.1f, true);
+
+    if (!FrameProfiler::enabled())
+    {
+        // the zones compile to nothing
+        EXPECT_EQ(profiler.frameCount(), 0u);
+        return;
+    }
+
+    ASSERT_EQ(profiler.frameCount(), 2u);
+    const FrameStats stats = profiler.latest();
+    EXPECT_EQ(stats.frame, 1u);
+    EXPECT_GT(stats.frameNanoseconds, 0u);
+    EXPECT_EQ(stats.stageCalls(Stage::LayoutUpdate), 1u);
+    EXPECT_EQ(stats.stageCalls(Stage::CompactDead), 1u);
+    EXPECT_EQ(stats.stageCalls(Stage::PartitionBuild), 1u);
+    EXPECT_GE(stats.stageCalls(Stage::Positions), 1u);
+    EXPECT_EQ(stats.stageCalls(Stage::Export), 0u);
+    EXPECT_LE(stats.stageNanoseconds(Stage::LayoutUpdate), stats.frameNanoseconds);
+}
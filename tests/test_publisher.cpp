@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/publisher.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+
+TEST(FramePublisherTest, ConsumerGetsTheLatestFrame)
+{
+    ParticleSystem<ParticleSystemDataSoA> system(100);
+    for (int i = 0; i < 10; ++i)
+        system.addParticle(make_test_particle(1.0f, float(i), 0.0f, 0.0f, 10.0f));
+
+    FramePublisher publisher(100);
+    system.setPublisher(&publisher);
+    EXPECT_EQ(publisher.latest(), nullptr);
+
+    system.update(0.5f);
+    system.update(0.5f);
+    EXPECT_EQ(publisher.published(), 2u);
+
+    const PublishedFrame *frame = publisher.latest();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->index, 1u);
+    ASSERT_EQ(frame->size(), 10u);
+    const auto particles = system.get();
+    for (size_t i = 0; i < 10; ++i)
+    {
+        EXPECT_FLOAT_EQ(frame->posX[i], particles[i].position.x);
+        EXPECT_FLOAT_EQ(frame->posY[i], particles[i].position.y);
+        EXPECT_FLOAT_EQ(frame->lifetime[i], particles[i].lifetime);
+        EXPECT_EQ(frame->alive[i], 1);
+    }
+
+    // nothing new: the same frame again
+    EXPECT_EQ(publisher.latest(), frame);
+
+    system.setPublisher(nullptr);
+    system.update(0.5f);
+    EXPECT_EQ(publisher.published(), 2u);
+}
+
+TEST(FramePublisherTest, LayoutsWithoutColumnsPublishPositions)
+{
+    ParticleSystem<ParticleSystemDataAoS> system(10);
+    for (int i = 0; i < 3; ++i)
+        system.addParticle(make_test_particle(2.0f, 0.0f, 0.0f, 0.0f, 10.0f));
+
+    FramePublisher publisher;
+    system.setPublisher(&publisher);
+    system.update(0.25f);
+
+    const PublishedFrame *frame = publisher.latest();
+    ASSERT_NE(frame, nullptr);
+    ASSERT_EQ(frame->size(), 3u);
+    EXPECT_FLOAT_EQ(frame->posX[0], 0.5f);
+    EXPECT_EQ(frame->alive[2], 1);
+}
+
+TEST(FramePublisherTest, SlowConsumerNeverBlocksTheSimulation)
+{
+    ParticleSystem<ParticleSystemDataSoA> system(1000);
+    for (int i = 0; i < 1000; ++i)
+        system.addParticle(make_test_particle(1.0f, 0.0f, 0.0f, 0.0f, 1000.0f));
+
+    FramePublisher publisher(1000);
+    system.setPublisher(&publisher);
+    std::atomic<bool> done{false};
+    size_t torn = 0, frames = 0;
+
+    // every particle shares x in a frame, so a mix of two frames shows up as differing values
+    std::thread consumer([&]
+                         {
+                             uint64_t last = 0;
+                             while (!done.load())
+                             {
+                                 const PublishedFrame *f = publisher.latest();
+                                 if (!f || f->index == last)
+                                     continue;
+                                 last = f->index;
+                                 ++frames;
+                                 for (float x : f->posX)
+                                     torn += x != f->posX[0];
+                                 std::this_thread::yield();
+                             } });
+
+    for (int f = 0; f < 2000; ++f)
+        system.update(0.001f);
+    done = true;
+    consumer.join();
+
+    EXPECT_EQ(publisher.published(), 2000u);
+    EXPECT_EQ(torn, 0u);
+    EXPECT_LE(frames, 2000u);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/recorder.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct ExpectedFrame
+    {
+        std::vector<float> x, y;
+        std::vector<uint8_t> alive;
+    };
+
+    // particles with spread out lifetimes so compaction changes the count while recording
+    ParticleSystem<ParticleSystemDataSoA> makeSystem(size_t count)
+    {
+        ParticleSystem<ParticleSystemDataSoA> system(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle p = make_test_particle(std::sin(0.1f * i), std::cos(0.3f * i), 0.0f, -1.0f, 0.05f + 0.02f * (i % 97));
+            p.position = {float(i % 64) - 32.f, float(i / 64)};
+            system.addParticle(p);
+        }
+        return system;
+    }
+
+    std::vector<ExpectedFrame> recordFrames(ParticleSystem<ParticleSystemDataSoA> &system, FrameRecorder &recorder, int frames)
+    {
+        std::vector<ExpectedFrame> expected;
+        system.setRecorder(&recorder);
+        for (int f = 0; f < frames; ++f)
+        {
+            system.update(0.05f, f % 3 == 2);
+            const ParticleSoAView v = system.layout().view();
+            expected.push_back({{v.posX, v.posX + v.count}, {v.posY, v.posY + v.count}, {v.alive, v.alive + v.count}});
+        }
+        system.setRecorder(nullptr);
+        return expected;
+    }
+
+    void expectFrame(const RecordedFrame &frame, const ExpectedFrame &expected, float quantum)
+    {
+        ASSERT_EQ(frame.size(), expected.x.size()) << "frame " << frame.index;
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            ASSERT_NEAR(frame.x[i], expected.x[i], 0.5f * quantum * 1.001f) << "frame " << frame.index << " particle " << i;
+            ASSERT_NEAR(frame.y[i], expected.y[i], 0.5f * quantum * 1.001f) << "frame " << frame.index << " particle " << i;
+            ASSERT_EQ(frame.alive[i], expected.alive[i]) << "frame " << frame.index << " particle " << i;
+        }
+    }
+}
+
+TEST(FrameRecorderTest, ReplayMatchesWithinHalfAQuantum)
+{
+    TempFile file("recording");
+    RecorderConfig cfg;
+    cfg.keyframeInterval = 10;
+    cfg.queueDepth = 2;
+
+    auto system = makeSystem(1000);
+    std::vector<ExpectedFrame> expected;
+    {
+        FrameRecorder recorder(file.path, cfg);
+        expected = recordFrames(system, recorder, 35);
+        recorder.close();
+
+        const RecorderStats stats = recorder.stats();
+        EXPECT_EQ(stats.frames, 35u);
+        EXPECT_EQ(stats.keyframes, 4u);
+        EXPECT_GT(stats.encodedBytes, 0u);
+    }
+    ASSERT_LT(expected.back().x.size(), 1000u);
+
+    FrameReplay replay(file.path);
+    EXPECT_EQ(replay.frameCount(), 35u);
+    EXPECT_EQ(replay.keyframes().size(), 4u);
+    EXPECT_FLOAT_EQ(replay.quantum(), cfg.quantum);
+
+    RecordedFrame frame;
+    for (uint64_t f = 0; f < 35; ++f)
+    {
+        ASSERT_TRUE(replay.next(frame));
+        EXPECT_EQ(frame.index, f);
+        EXPECT_EQ(frame.keyframe, f % 10 == 0);
+        expectFrame(frame, expected[f], cfg.quantum);
+    }
+    EXPECT_FALSE(replay.next(frame));
+}
+
+TEST(FrameRecorderTest, SeekLandsOnAnyFrame)
+{
+    TempFile file("seek");
+    RecorderConfig cfg;
+    cfg.keyframeInterval = 8;
+
+    auto system = makeSystem(300);
+    std::vector<ExpectedFrame> expected;
+    {
+        FrameRecorder recorder(file.path, cfg);
+        expected = recordFrames(system, recorder, 30);
+    }
+
+    FrameReplay replay(file.path);
+    RecordedFrame frame;
+    for (uint64_t target : {17u, 3u, 16u, 29u, 18u, 0u})
+    {
+        replay.seek(target);
+        ASSERT_TRUE(replay.next(frame));
+        EXPECT_EQ(frame.index, target);
+        expectFrame(frame, expected[target], cfg.quantum);
+    }
+
+    replay.seek(30);
+    EXPECT_FALSE(replay.next(frame));
+}
+
+TEST(FrameRecorderTest, UnclosedRecordingIsScanned)
+{
+    TempFile file("unclosed");
+    TempFile cut("unclosed_cut");
+    RecorderConfig cfg;
+    cfg.keyframeInterval = 5;
+
+    auto system = makeSystem(200);
+    FrameRecorder recorder(file.path, cfg);
+    const auto expected = recordFrames(system, recorder, 12);
+    recorder.flush();
+
+    FrameReplay replay(file.path);
+    EXPECT_EQ(replay.frameCount(), 12u);
+    ASSERT_EQ(replay.keyframes().size(), 3u);
+    EXPECT_EQ(replay.keyframes()[2].frame, 10u);
+
+    RecordedFrame frame;
+    replay.seek(11);
+    ASSERT_TRUE(replay.next(frame));
+    expectFrame(frame, expected[11], cfg.quantum);
+
+    // a crash in the middle of the last frame loses only that frame
+    fs::copy_file(file.path, cut.path, fs::copy_options::overwrite_existing);
+    fs::resize_file(cut.path, fs::file_size(cut.path) - 3);
+    FrameReplay partial(cut.path);
+    EXPECT_EQ(partial.frameCount(), 11u);
+}
+
+TEST(FrameRecorderTest, SlowMotionCompresses)
+{
+    TempFile file("ratio");
+    ParticleSystemDataSoA layout(4096);
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        Particle p = make_test_particle(0.01f * float(i % 7), -0.02f, 0.0f, 0.0f, 100.0f);
+        p.position = {float(i % 64) * 3.f, float(i / 64) * 3.f};
+        layout.add(p);
+    }
+
+    FrameRecorder recorder(file.path);
+    for (int f = 0; f < 60; ++f)
+    {
+        layout.update(1.f / 60.f);
+        recorder.record(layout.view());
+    }
+    recorder.close();
+
+    const RecorderStats stats = recorder.stats();
+    EXPECT_EQ(stats.frames, 60u);
+    EXPECT_EQ(stats.rawBytes, 60u * 4096u * 8u);
+    EXPECT_GT(stats.compressionRatio(), 4.0);
+    EXPECT_LE(stats.encodedBytes + sizeof(RecordingHeader), fs::file_size(file.path));
+}
+
+TEST(FrameRecorderTest, RejectsBadInput)
+{
+    TempFile file("bad");
+    RecorderConfig cfg;
+    cfg.quantum = 0.f;
+    EXPECT_THROW(FrameRecorder(file.path, cfg), std::invalid_argument);
+    EXPECT_THROW(FrameRecorder(file.path + "/not/a/dir"), std::runtime_error);
+
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "not a recording at all, just some text";
+    }
+    EXPECT_THROW(FrameReplay{file.path}, std::runtime_error);
+    EXPECT_THROW(FrameReplay{file.path + ".missing"}, std::runtime_error);
+}
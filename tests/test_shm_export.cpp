@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/shm_export.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+
+namespace
+{
+    std::string segmentName(const char *test)
+    {
+        return "/particlesim_test_" + std::string(test) + "_" + std::to_string(::getpid());
+    }
+
+    // every particle of frame f sits at x = f
+    void publishUniform(SharedFrameExport &shared, std::vector<float> &x, std::vector<float> &y, std::vector<uint8_t> &alive, float f)
+    {
+        std::fill(x.begin(), x.end(), f);
+        shared.publish(ParticleSoAView{x.data(), y.data(), nullptr, nullptr, nullptr, nullptr, nullptr, alive.data(), x.size()});
+    }
+}
+
+TEST(SharedFrameExportTest, ReaderSeesTheLatestFrame)
+{
+    const std::string name = segmentName("latest");
+    ParticleSystem<ParticleSystemDataSoA> system(100);
+    for (int i = 0; i < 20; ++i)
+        system.addParticle(make_test_particle(float(i), 1.0f, 0.0f, 0.0f, i < 15 ? 10.0f : 0.3f));
+
+    SharedFrameExport shared(name, 100);
+    SharedFrameReader reader(name);
+    SharedFrameReader::Frame frame;
+    EXPECT_FALSE(reader.latest(frame));
+
+    system.setExport(&shared);
+    system.update(0.5f);
+    system.update(0.5f);
+    EXPECT_EQ(shared.published(), 2u);
+    EXPECT_EQ(reader.published(), 2u);
+
+    ASSERT_TRUE(reader.latest(frame));
+    EXPECT_EQ(frame.frame, 1u);
+    ASSERT_EQ(frame.count, 20u);
+    EXPECT_EQ(frame.totalCount, 20u);
+    EXPECT_EQ(frame.aliveCount, 15u);
+    const auto particles = system.get();
+    for (size_t i = 0; i < 20; ++i)
+    {
+        EXPECT_FLOAT_EQ(frame.posX[i], particles[i].position.x);
+        EXPECT_FLOAT_EQ(frame.posY[i], particles[i].position.y);
+        EXPECT_EQ(frame.alive[i], i < 15 ? 1 : 0);
+    }
+    EXPECT_TRUE(reader.unchanged(frame));
+}
+
+TEST(SharedFrameExportTest, FramesAboveCapacityAreCut)
+{
+    const std::string name = segmentName("capacity");
+    SharedFrameExport shared(name, 64);
+    std::vector<core::Vector2D> positions(100, core::Vector2D(3.f, 4.f));
+    shared.publish(positions);
+
+    SharedFrameReader reader(name);
+    SharedFrameReader::Frame frame;
+    ASSERT_TRUE(reader.latest(frame));
+    EXPECT_EQ(frame.count, 64u);
+    EXPECT_EQ(frame.totalCount, 100u);
+    EXPECT_EQ(frame.aliveCount, 100u);
+    EXPECT_FLOAT_EQ(frame.posY[63], 4.f);
+}
+
+TEST(SharedFrameExportTest, OverwrittenSlotIsNoticed)
+{
+    const std::string name = segmentName("lapped");
+    SharedFrameExport shared(name, 16, 3);
+    SharedFrameReader reader(name);
+    std::vector<float> x(16), y(16);
+    std::vector<uint8_t> alive(16, 1);
+
+    publishUniform(shared, x, y, alive, 0.f);
+    SharedFrameReader::Frame frame;
+    ASSERT_TRUE(reader.latest(frame));
+
+    // two more frames go to the other slots, the third comes back to this one
+    publishUniform(shared, x, y, alive, 1.f);
+    publishUniform(shared, x, y, alive, 2.f);
+    EXPECT_TRUE(reader.unchanged(frame));
+    publishUniform(shared, x, y, alive, 3.f);
+    EXPECT_FALSE(reader.unchanged(frame));
+}
+
+TEST(SharedFrameExportTest, ConcurrentReadsAreConsistent)
+{
+    const std::string name = segmentName("concurrent");
+    SharedFrameExport shared(name, 4096, 2);
+    SharedFrameReader reader(name);
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]
+                       {
+                           std::vector<float> x(4096), y(4096);
+                           std::vector<uint8_t> alive(4096, 1);
+                           for (int f = 0; f < 3000; ++f)
+                               publishUniform(shared, x, y, alive, float(f));
+                           done = true; });
+
+    size_t torn = 0;
+    while (!done.load())
+    {
+        bool mixed = false;
+        const bool ok = reader.read([&](const SharedFrameReader::Frame &frame)
+                                    {
+                                        mixed = false;
+                                        for (size_t i = 0; i < frame.count; ++i)
+                                            mixed |= frame.posX[i] != frame.posX[0]; });
+        torn += ok && mixed;
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(reader.published(), 3000u);
+    EXPECT_TRUE(reader.read([](const SharedFrameReader::Frame &frame)
+                            { EXPECT_EQ(frame.posX[0], 2999.f); }));
+}
+
+TEST(SharedFrameExportTest, OtherProcessesMapIt)
+{
+    const std::string name = segmentName("process");
+    SharedFrameExport shared(name, 32);
+    std::vector<float> x(32), y(32, 2.f);
+    std::vector<uint8_t> alive(32, 1);
+    publishUniform(shared, x, y, alive, 7.f);
+
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        bool seen = false;
+        try
+        {
+            SharedFrameReader reader(name);
+            reader.read([&](const SharedFrameReader::Frame &frame)
+                        { seen = frame.count == 32 && frame.posX[31] == 7.f && frame.posY[0] == 2.f; });
+        }
+        catch (...)
+        {
+        }
+        ::_exit(seen ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(SharedFrameExportTest, LiveExportIsNotTakenOver)
+{
+    const std::string name = segmentName("taken");
+    SharedFrameExport shared(name, 8);
+    std::vector<float> x(8), y(8);
+    std::vector<uint8_t> alive(8, 1);
+    publishUniform(shared, x, y, alive, 3.f);
+
+    EXPECT_THROW(SharedFrameExport(name, 8), std::runtime_error);
+
+    SharedFrameReader reader(name);
+    EXPECT_TRUE(reader.read([](const SharedFrameReader::Frame &frame)
+                            { EXPECT_EQ(frame.posX[0], 3.f); }));
+}
+
+TEST(SharedFrameExportTest, ExportOfAnExitedWriterIsReplaced)
+{
+    const std::string name = segmentName("abandoned");
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // exits without the destructor, as a crash would
+        new SharedFrameExport(name, 8);
+        ::_exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+
+    SharedFrameExport shared(name, 16);
+    std::vector<float> x(16), y(16);
+    std::vector<uint8_t> alive(16, 1);
+    publishUniform(shared, x, y, alive, 5.f);
+
+    SharedFrameReader reader(name);
+    EXPECT_TRUE(reader.read([](const SharedFrameReader::Frame &frame)
+                            { EXPECT_EQ(frame.count, 16u); }));
+}
+
+TEST(SharedFrameExportTest, MissingSegmentThrows)
+{
+    EXPECT_THROW(SharedFrameReader(segmentName("missing")), std::runtime_error);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "particlesim/particle_system.hpp"
+#include "particlesim/snapshot.hpp"
+#include "test_helpers.hpp"
+
+using namespace particlesim;
+namespace fs = std::filesystem;
+
+namespace
+{
+    void fill(ParticleSystemDataSoA &system, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle p = make_test_particle(0.5f * i, -0.25f * i, 0.1f, -9.8f, 1.0f + 0.01f * i);
+            p.position = {float(i), float(i % 17)};
+            p.alive = i % 5 != 0;
+            p.updateTier = uint8_t(1u << (i % 3));
+            system.add(p);
+        }
+    }
+
+    template <typename Field>
+    void expectSameField(const Field &a, const Field &b)
+    {
+        for (size_t k = 0; k < a.storage.size(); ++k)
+            EXPECT_EQ(a.storage[k], b.storage[k]) << "component " << k;
+    }
+
+    void expectSameColumns(ParticleSystemDataSoA &a, ParticleSystemDataSoA &b)
+    {
+        ParticleSoA &x = a.columns();
+        ParticleSoA &y = b.columns();
+        ASSERT_EQ(x.size(), y.size());
+        expectSameField(x.field<Position>(), y.field<Position>());
+        expectSameField(x.field<Velocity>(), y.field<Velocity>());
+        expectSameField(x.field<Acceleration>(), y.field<Acceleration>());
+        expectSameField(x.field<Lifetime>(), y.field<Lifetime>());
+        expectSameField(x.field<Alive>(), y.field<Alive>());
+        expectSameField(x.field<Tier>(), y.field<Tier>());
+    }
+}
+
+TEST(SnapshotTest, RoundTripKeepsEveryColumn)
+{
+    TempFile file("roundtrip");
+    ParticleSystemDataSoA original(1000);
+    fill(original, 777);
+    writeSnapshot(file.path, original);
+
+    MappedSnapshot snapshot(file.path);
+    EXPECT_EQ(snapshot.size(), 777u);
+    EXPECT_EQ(snapshot.version(), SnapshotVersion);
+
+    ParticleSystemDataSoA restored(10);
+    fill(restored, 5);
+    snapshot.restore(restored);
+    expectSameColumns(original, restored);
+
+    // tiers were picked up again, so both step the same way
+    for (int f = 0; f < 8; ++f)
+    {
+        original.update(0.1f);
+        restored.update(0.1f);
+    }
+    expectSameColumns(original, restored);
+}
+
+TEST(SnapshotTest, ColumnsAreReadInPlace)
+{
+    TempFile file("inplace");
+    ParticleSystemDataSoA system(300);
+    fill(system, 300);
+    writeSnapshot(file.path, system);
+
+    MappedSnapshot snapshot(file.path);
+    const float *y = snapshot.column<float>(SnapshotField::Velocity, 1);
+    ASSERT_NE(y, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(y) % SnapshotAlignment, 0u);
+    EXPECT_EQ(std::memcmp(y, system.columns().field<Velocity>().y(), 300 * sizeof(float)), 0);
+
+    const uint8_t *tier = snapshot.column<uint8_t>(SnapshotField::Tier);
+    ASSERT_NE(tier, nullptr);
+    EXPECT_EQ(tier[2], 4);
+
+    // wrong element type or a component the field does not have
+    EXPECT_EQ(snapshot.column<uint8_t>(SnapshotField::Position), nullptr);
+    EXPECT_EQ(snapshot.column(SnapshotField::Lifetime, 1), nullptr);
+
+    // the mapping outlives the moved-from handle
+    MappedSnapshot moved = std::move(snapshot);
+    EXPECT_EQ(moved.column<float>(SnapshotField::Velocity, 1), y);
+    EXPECT_FLOAT_EQ(y[3], -0.75f);
+}
+
+TEST(SnapshotTest, EmptySystem)
+{
+    TempFile file("empty");
+    ParticleSystemDataSoA empty(10);
+    writeSnapshot(file.path, empty);
+
+    ParticleSystemDataSoA restored(10);
+    fill(restored, 20);
+    MappedSnapshot(file.path).restore(restored);
+    EXPECT_EQ(restored.size(), 0u);
+}
+
+TEST(SnapshotTest, RestoreResetsSleepingBlocks)
+{
+    TempFile file("rest");
+    ParticleSystemDataSoA source(200);
+    fill(source, 130);
+    writeSnapshot(file.path, source);
+
+    RestConfig rest;
+    rest.enabled = true;
+    rest.sleepFrames = 1;
+    ParticleSystemDataSoA restored(200);
+    restored.setRestConfig(rest);
+    for (size_t i = 0; i < 2 * ParticleSystemDataSoA::BlockSize; ++i)
+        restored.add(make_test_particle(0.0f, 0.0f, 0.0f, 0.0f, 100.0f));
+    for (int f = 0; f < 3; ++f)
+        restored.update(0.1f);
+    ASSERT_GT(restored.sleepingCount(), 0u);
+
+    MappedSnapshot(file.path).restore(restored);
+    EXPECT_EQ(restored.size(), 130u);
+    EXPECT_EQ(restored.sleepingCount(), 0u);
+    expectSameColumns(source, restored);
+    restored.update(0.1f);
+}
+
+TEST(SnapshotTest, RejectsFilesThatAreNotSnapshots)
+{
+    TempFile file("corrupt");
+    EXPECT_THROW(MappedSnapshot(file.path + ".missing"), std::runtime_error);
+
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "definitely not a particle snapshot, just some text";
+    }
+    EXPECT_THROW(MappedSnapshot{file.path}, std::runtime_error);
+
+    ParticleSystemDataSoA system(100);
+    fill(system, 100);
+    writeSnapshot(file.path, system);
+    fs::resize_file(file.path, fs::file_size(file.path) - 1);
+    EXPECT_THROW(MappedSnapshot{file.path}, std::runtime_error);
+
+    fs::resize_file(file.path, 16);
+    EXPECT_THROW(MappedSnapshot{file.path}, std::runtime_error);
+}
+
+TEST(SnapshotTest, RejectsParticleCountsThatOverflowTheColumnSizes)
+{
+    TempFile file("overflow");
+    ParticleSystemDataSoA system(100);
+    fill(system, 100);
+    writeSnapshot(file.path, system);
+
+    // keep only the float columns, with a count whose 4-byte column size wraps back to the real one
+    {
+        std::fstream io(file.path, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader h;
+        io.read(reinterpret_cast<char *>(&h), sizeof(h));
+        h.particleCount += uint64_t{1} << 62;
+        h.sectionCount = 7;
+        io.seekp(0);
+        io.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    }
+    EXPECT_THROW(MappedSnapshot{file.path}, std::runtime_error);
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <random>
 #include "particlesim/spatial_partitioning.hpp"
 
 using namespace particlesim;
@@ -202,3 +203,201 @@ TEST(UniformGrid, ParticlesOutsideBoundsAreClamped)
     EXPECT_EQ(idx0, 0);
     EXPECT_EQ(idx1, (10 - 1) + (10 - 1) * 10);
 }
+
+TEST(UniformGrid, StatsDescribeOccupancyAndQueries)
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 10.f;
+    cfg.world = {0, 0, 100, 100};
+    UniformGrid grid(cfg);
+
+    // a hotspot of 9 particles in cell (0, 0), one particle in each of three other cells
+    vector<Vector2D> pos(9, Vector2D(5, 5));
+    pos.push_back({55, 55});
+    pos.push_back({75, 55});
+    pos.push_back({95, 95});
+    grid.setData({pos, {}});
+    grid.build();
+
+    PartitionStats stats = grid.stats();
+    EXPECT_EQ(stats.particles, 12u);
+    EXPECT_EQ(stats.cells, 100u);
+    EXPECT_EQ(stats.nonEmptyCells(), 4u);
+    EXPECT_EQ(stats.maxOccupancy(), 9u);
+    EXPECT_EQ(stats.occupancy.sum(), 12u);
+    EXPECT_EQ(stats.occupancy.percentile(0.5), 1u);
+    EXPECT_EQ(stats.neighborCounts.total(), 0u);
+
+    grid.queryNeighborhood(0);  // the other 8 of the hotspot
+    grid.queryNeighborhood(11); // alone
+    stats = grid.stats();
+    EXPECT_EQ(stats.neighborCounts.total(), 2u);
+    EXPECT_EQ(stats.neighborCounts.max(), 8u);
+    EXPECT_EQ(stats.neighborCounts.count(0), 1u);
+
+    grid.clear();
+    stats = grid.stats();
+    EXPECT_EQ(stats.nonEmptyCells(), 0u);
+    EXPECT_EQ(stats.neighborCounts.total(), 0u);
+}
+
+static vector<uint32_t> bruteForceKNearest(const vector<Vector2D> &pos, const Vector2D &p, uint32_t k, uint32_t exclude)
+{
+    vector<uint32_t> order;
+    for (uint32_t i = 0; i < pos.size(); ++i)
+        if (i != exclude)
+            order.push_back(i);
+
+    auto distSq = [&](uint32_t i)
+    {
+        float dx = pos[i].x - p.x, dy = pos[i].y - p.y;
+        return dx * dx + dy * dy;
+    };
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+         { return distSq(a) < distSq(b); });
+    order.resize(min<size_t>(k, order.size()));
+    return order;
+}
+
+static vector<Vector2D> randomPositions(size_t n, float extent)
+{
+    mt19937 rng(7);
+    uniform_real_distribution<float> dist(0.f, extent);
+    vector<Vector2D> pos(n);
+    for (auto &p : pos)
+        p = {dist(rng), dist(rng)};
+    return pos;
+}
+
+TEST(UniformGridAllocated, ParallelQueriesWithWorkerArenasMatchSharedArena)
+{
+    PartitioningConfig cfg;
+    cfg.world = {0.f, 0.f, 20.f, 20.f};
+    UniformGridAllocated grid(cfg);
+    FrameArena arena;
+    ParallelScheduler scheduler(4, 1024);
+
+    auto pos = randomPositions(2000, 20.f);
+    grid.setData({pos, &arena});
+    grid.build();
+
+    vector<vector<uint32_t>> parallel(pos.size());
+    scheduler.parallelFor(pos.size(), [&](size_t begin, size_t end, size_t worker)
+                          {
+        FrameArena &local = scheduler.workerArena(worker);
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto result = grid.queryNeighborhood(static_cast<uint32_t>(i), local);
+            parallel[i].assign(result.begin(), result.end());
+        } });
+
+    for (uint32_t id = 0; id < pos.size(); ++id)
+    {
+        auto shared = grid.queryNeighborhood(id);
+        EXPECT_EQ(parallel[id], vector<uint32_t>(shared.begin(), shared.end()));
+    }
+}
+
+TEST(KDTree, KNearestMatchesBruteForce)
+{
+    PartitioningConfig cfg;
+    KDTree tree(cfg);
+    FrameArena arena;
+
+    auto pos = randomPositions(500, 100.f);
+    tree.setData({pos, &arena});
+    tree.build();
+
+    for (uint32_t id = 0; id < pos.size(); id += 37)
+    {
+        auto result = tree.queryKNearest(id, 10);
+        auto expected = bruteForceKNearest(pos, pos[id], 10, id);
+        ASSERT_EQ(result.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            EXPECT_EQ(result[i], expected[i]);
+    }
+}
+
+TEST(KDTree, KNearestFromPointIncludesEveryParticle)
+{
+    PartitioningConfig cfg;
+    KDTree tree(cfg);
+    FrameArena arena;
+
+    vector<Vector2D> pos = {{0, 0}, {10, 0}, {3, 0}, {1, 1}};
+    tree.setData({pos, &arena});
+    tree.build();
+
+    auto result = tree.queryKNearest(Vector2D{0.f, 0.f}, 3);
+    ASSERT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0], 0u);
+    EXPECT_EQ(result[1], 3u);
+    EXPECT_EQ(result[2], 2u);
+}
+
+TEST(KDTree, KLargerThanParticleCountReturnsAll)
+{
+    PartitioningConfig cfg;
+    KDTree tree(cfg);
+    FrameArena arena;
+
+    vector<Vector2D> pos = {{0, 0}, {1, 0}, {2, 0}};
+    tree.setData({pos, &arena});
+    tree.build();
+
+    EXPECT_EQ(tree.queryKNearest(0u, 10).size(), 2u);
+}
+
+TEST(KDTree, QueryNeighborhoodUsesCellSizeAsRadius)
+{
+    PartitioningConfig cfg;
+    cfg.cellSize = 2.f;
+    KDTree tree(cfg);
+
+    auto pos = randomPositions(300, 20.f);
+    tree.setData({pos, {}});
+    tree.build();
+
+    for (uint32_t id = 0; id < pos.size(); id += 29)
+    {
+        auto span = tree.queryNeighborhood(id);
+        vector<uint32_t> got(span.begin(), span.end());
+        sort(got.begin(), got.end());
+
+        vector<uint32_t> expected;
+        for (uint32_t i = 0; i < pos.size(); ++i)
+        {
+            float dx = pos[i].x - pos[id].x, dy = pos[i].y - pos[id].y;
+            if (i != id && dx * dx + dy * dy <= 4.f)
+                expected.push_back(i);
+        }
+        EXPECT_EQ(got, expected);
+    }
+}
+
+TEST(KDTree, BatchedQueryMatchesSingleQueries)
+{
+    PartitioningConfig cfg;
+    KDTree tree(cfg);
+    FrameArena arena(4 * 1024 * 1024);
+    ParallelScheduler scheduler(4);
+
+    auto pos = randomPositions(1000, 50.f);
+    tree.setData({pos, &arena});
+    tree.build();
+
+    vector<uint32_t> ids(pos.size());
+    for (uint32_t i = 0; i < ids.size(); ++i)
+        ids[i] = i;
+
+    const uint32_t k = 6;
+    auto batch = tree.queryKNearestBatch(ids, k, scheduler);
+    ASSERT_EQ(batch.size(), ids.size() * k);
+
+    for (uint32_t id = 0; id < ids.size(); id += 97)
+    {
+        auto single = tree.queryKNearest(id, k);
+        for (uint32_t j = 0; j < k; ++j)
+            EXPECT_EQ(batch[id * k + j], single[j]);
+    }
+}